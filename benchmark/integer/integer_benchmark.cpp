@@ -1,9 +1,11 @@
 
 #include <benchmark/benchmark.h>
 #include <big_int.hpp>
+#include <suuri_prepared.hpp>
 
 #include <chrono>
 #include <iostream>
+#include <map>
 #include <sstream>
 
 #define STARTSEED 6942069
@@ -28,6 +30,12 @@ uint32_t pcg_random(uint32_t &seed, uint32_t min, uint32_t max)
 
 
 #define STANDARDPARAMS RangeMultiplier(2)->Range(1, 1 << 18)->UseManualTime()
+// The length of the shorter operand, and the length of the longer one as a percentage of it
+#define RATIOPARAMS ArgsProduct({{1, 1 << 4, 1 << 8, 1 << 12}, {100, 150, 200, 250, 300, 500, 1000, 10000}})->UseManualTime()
+// The length of the operands, and the number of threads
+#define PARALLELPARAMS ArgsProduct({{1 << 12, 1 << 14, 1 << 16, 1 << 18, 1 << 20}, {1, 2, 4, 8, 16, 32, 64}})->UseManualTime()
+// The bits of the modulus, and whether to run the emulated IFMA kernels instead of the best ones for the CPU
+#define MODULUSPARAMS ArgsProduct({{512, 1024, 2048, 3072, 4096}, {0, 1, 2}})->UseManualTime()
 
 static void BM_integer_long_multiplication_same_length(benchmark::State &state)
 {
@@ -89,5 +97,757 @@ static void BM_integer_karatsuba_multiplication_same_length(benchmark::State &st
 }
 BENCHMARK(BM_integer_karatsuba_multiplication_same_length)->STANDARDPARAMS;
 
+static void BM_integer_parallel_multiplication_same_length(benchmark::State &state)
+{
+	state.SetLabel((std::stringstream{} << state.range(0) << " " << state.range(1)).str());
+	suuri::parallel::set_thread_count(static_cast<size_t>(state.range(1)));
+
+	// REUSABLE VARIABLES
+	suuri::big_int_t a, b, c;
+	auto generator = [](uint32_t min, uint32_t max) {
+		static uint32_t seed = STARTSEED;
+		return pcg_random(seed, min, max);
+	};
+	// The serial time of every length, measured by the single thread run that comes first
+	static std::map<int64_t, double> serial_seconds;
+	double total_seconds = 0;
+
+	for (auto _: state)
+	{
+		// SETUP CODE
+		a = suuri::big_int_t::random_of_size(state.range(0), generator);
+		b = suuri::big_int_t::random_of_size(state.range(0), generator);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		// --- CODE TO BE BENCHMARKED
+
+		c = a * b;
+
+		// ---
+		auto end = std::chrono::high_resolution_clock::now();
+		auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+		state.SetIterationTime(elapsed_seconds.count());
+		total_seconds += elapsed_seconds.count();
+	}
+
+	const double seconds = total_seconds / static_cast<double>(state.iterations());
+	if (state.range(1) == 1)
+		serial_seconds[state.range(0)] = seconds;
+	if (serial_seconds.contains(state.range(0)))
+		state.counters["speedup"] = serial_seconds[state.range(0)] / seconds;
+	state.counters["threads"] = static_cast<double>(state.range(1));
+
+	suuri::parallel::set_thread_count(1);
+}
+BENCHMARK(BM_integer_parallel_multiplication_same_length)->PARALLELPARAMS;
+
+static void BM_integer_toom3_multiplication_same_length(benchmark::State &state)
+{
+	state.SetLabel((std::stringstream{} << state.range(0)).str());
+
+	// REUSABLE VARIABLES
+	suuri::big_int_t a, b, c;
+	auto generator = [](uint32_t min, uint32_t max) {
+		static uint32_t seed = STARTSEED;
+		return pcg_random(seed, min, max);
+	};
+
+	for (auto _: state)
+	{
+		// SETUP CODE
+		a = suuri::big_int_t::random_of_size(state.range(0), generator);
+		b = suuri::big_int_t::random_of_size(state.range(0), generator);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		// --- CODE TO BE BENCHMARKED
+
+		c = a.toom3_multiplication(b);
+
+		// ---
+		auto end = std::chrono::high_resolution_clock::now();
+		auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+		state.SetIterationTime(elapsed_seconds.count());
+	}
+}
+BENCHMARK(BM_integer_toom3_multiplication_same_length)->STANDARDPARAMS;
+
+static void BM_integer_toom3_squaring(benchmark::State &state)
+{
+	state.SetLabel((std::stringstream{} << state.range(0)).str());
+
+	// REUSABLE VARIABLES
+	suuri::big_int_t a, b, c;
+	auto generator = [](uint32_t min, uint32_t max) {
+		static uint32_t seed = STARTSEED;
+		return pcg_random(seed, min, max);
+	};
+
+	for (auto _: state)
+	{
+		// SETUP CODE
+		a = suuri::big_int_t::random_of_size(state.range(0), generator);
+		b = suuri::big_int_t::random_of_size(state.range(0), generator);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		// --- CODE TO BE BENCHMARKED
+
+		c = a.toom3_multiplication(a);
+
+		// ---
+		auto end = std::chrono::high_resolution_clock::now();
+		auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+		state.SetIterationTime(elapsed_seconds.count());
+	}
+}
+BENCHMARK(BM_integer_toom3_squaring)->STANDARDPARAMS;
+
+static void BM_integer_toom4_multiplication_same_length(benchmark::State &state)
+{
+	state.SetLabel((std::stringstream{} << state.range(0)).str());
+
+	// REUSABLE VARIABLES
+	suuri::big_int_t a, b, c;
+	auto generator = [](uint32_t min, uint32_t max) {
+		static uint32_t seed = STARTSEED;
+		return pcg_random(seed, min, max);
+	};
+
+	for (auto _: state)
+	{
+		// SETUP CODE
+		a = suuri::big_int_t::random_of_size(state.range(0), generator);
+		b = suuri::big_int_t::random_of_size(state.range(0), generator);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		// --- CODE TO BE BENCHMARKED
+
+		c = a.toom4_multiplication(b);
+
+		// ---
+		auto end = std::chrono::high_resolution_clock::now();
+		auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+		state.SetIterationTime(elapsed_seconds.count());
+	}
+}
+BENCHMARK(BM_integer_toom4_multiplication_same_length)->STANDARDPARAMS;
+
+static void BM_integer_toom4_squaring(benchmark::State &state)
+{
+	state.SetLabel((std::stringstream{} << state.range(0)).str());
+
+	// REUSABLE VARIABLES
+	suuri::big_int_t a, b, c;
+	auto generator = [](uint32_t min, uint32_t max) {
+		static uint32_t seed = STARTSEED;
+		return pcg_random(seed, min, max);
+	};
+
+	for (auto _: state)
+	{
+		// SETUP CODE
+		a = suuri::big_int_t::random_of_size(state.range(0), generator);
+		b = suuri::big_int_t::random_of_size(state.range(0), generator);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		// --- CODE TO BE BENCHMARKED
+
+		c = a.toom4_multiplication(a);
+
+		// ---
+		auto end = std::chrono::high_resolution_clock::now();
+		auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+		state.SetIterationTime(elapsed_seconds.count());
+	}
+}
+BENCHMARK(BM_integer_toom4_squaring)->STANDARDPARAMS;
+
+static void BM_integer_toom6h_multiplication_same_length(benchmark::State &state)
+{
+	state.SetLabel((std::stringstream{} << state.range(0)).str());
+
+	// REUSABLE VARIABLES
+	suuri::big_int_t a, b, c;
+	auto generator = [](uint32_t min, uint32_t max) {
+		static uint32_t seed = STARTSEED;
+		return pcg_random(seed, min, max);
+	};
+
+	for (auto _: state)
+	{
+		// SETUP CODE
+		a = suuri::big_int_t::random_of_size(state.range(0), generator);
+		b = suuri::big_int_t::random_of_size(state.range(0), generator);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		// --- CODE TO BE BENCHMARKED
+
+		c = a.toom6h_multiplication(b);
+
+		// ---
+		auto end = std::chrono::high_resolution_clock::now();
+		auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+		state.SetIterationTime(elapsed_seconds.count());
+	}
+}
+BENCHMARK(BM_integer_toom6h_multiplication_same_length)->STANDARDPARAMS;
+
+static void BM_integer_toom6h_squaring(benchmark::State &state)
+{
+	state.SetLabel((std::stringstream{} << state.range(0)).str());
+
+	// REUSABLE VARIABLES
+	suuri::big_int_t a, b, c;
+	auto generator = [](uint32_t min, uint32_t max) {
+		static uint32_t seed = STARTSEED;
+		return pcg_random(seed, min, max);
+	};
+
+	for (auto _: state)
+	{
+		// SETUP CODE
+		a = suuri::big_int_t::random_of_size(state.range(0), generator);
+		b = suuri::big_int_t::random_of_size(state.range(0), generator);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		// --- CODE TO BE BENCHMARKED
+
+		c = a.toom6h_multiplication(a);
+
+		// ---
+		auto end = std::chrono::high_resolution_clock::now();
+		auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+		state.SetIterationTime(elapsed_seconds.count());
+	}
+}
+BENCHMARK(BM_integer_toom6h_squaring)->STANDARDPARAMS;
+
+static void BM_integer_toom8h_multiplication_same_length(benchmark::State &state)
+{
+	state.SetLabel((std::stringstream{} << state.range(0)).str());
+
+	// REUSABLE VARIABLES
+	suuri::big_int_t a, b, c;
+	auto generator = [](uint32_t min, uint32_t max) {
+		static uint32_t seed = STARTSEED;
+		return pcg_random(seed, min, max);
+	};
+
+	for (auto _: state)
+	{
+		// SETUP CODE
+		a = suuri::big_int_t::random_of_size(state.range(0), generator);
+		b = suuri::big_int_t::random_of_size(state.range(0), generator);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		// --- CODE TO BE BENCHMARKED
+
+		c = a.toom8h_multiplication(b);
+
+		// ---
+		auto end = std::chrono::high_resolution_clock::now();
+		auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+		state.SetIterationTime(elapsed_seconds.count());
+	}
+}
+BENCHMARK(BM_integer_toom8h_multiplication_same_length)->STANDARDPARAMS;
+
+static void BM_integer_toom8h_squaring(benchmark::State &state)
+{
+	state.SetLabel((std::stringstream{} << state.range(0)).str());
+
+	// REUSABLE VARIABLES
+	suuri::big_int_t a, b, c;
+	auto generator = [](uint32_t min, uint32_t max) {
+		static uint32_t seed = STARTSEED;
+		return pcg_random(seed, min, max);
+	};
+
+	for (auto _: state)
+	{
+		// SETUP CODE
+		a = suuri::big_int_t::random_of_size(state.range(0), generator);
+		b = suuri::big_int_t::random_of_size(state.range(0), generator);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		// --- CODE TO BE BENCHMARKED
+
+		c = a.toom8h_multiplication(a);
+
+		// ---
+		auto end = std::chrono::high_resolution_clock::now();
+		auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+		state.SetIterationTime(elapsed_seconds.count());
+	}
+}
+BENCHMARK(BM_integer_toom8h_squaring)->STANDARDPARAMS;
+
+static void BM_integer_ntt_multiplication_same_length(benchmark::State &state)
+{
+	state.SetLabel((std::stringstream{} << state.range(0)).str());
+
+	// REUSABLE VARIABLES
+	suuri::big_int_t a, b, c;
+	auto generator = [](uint32_t min, uint32_t max) {
+		static uint32_t seed = STARTSEED;
+		return pcg_random(seed, min, max);
+	};
+
+	for (auto _: state)
+	{
+		// SETUP CODE
+		a = suuri::big_int_t::random_of_size(state.range(0), generator);
+		b = suuri::big_int_t::random_of_size(state.range(0), generator);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		// --- CODE TO BE BENCHMARKED
+
+		c = a.ntt_multiplication(b);
+
+		// ---
+		auto end = std::chrono::high_resolution_clock::now();
+		auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+		state.SetIterationTime(elapsed_seconds.count());
+	}
+}
+BENCHMARK(BM_integer_ntt_multiplication_same_length)->STANDARDPARAMS;
+
+static void BM_integer_ntt_squaring(benchmark::State &state)
+{
+	state.SetLabel((std::stringstream{} << state.range(0)).str());
+
+	// REUSABLE VARIABLES
+	suuri::big_int_t a, b, c;
+	auto generator = [](uint32_t min, uint32_t max) {
+		static uint32_t seed = STARTSEED;
+		return pcg_random(seed, min, max);
+	};
+
+	for (auto _: state)
+	{
+		// SETUP CODE
+		a = suuri::big_int_t::random_of_size(state.range(0), generator);
+		b = suuri::big_int_t::random_of_size(state.range(0), generator);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		// --- CODE TO BE BENCHMARKED
+
+		c = a.ntt_multiplication(a);
+
+		// ---
+		auto end = std::chrono::high_resolution_clock::now();
+		auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+		state.SetIterationTime(elapsed_seconds.count());
+	}
+}
+BENCHMARK(BM_integer_ntt_squaring)->STANDARDPARAMS;
+
+static void BM_integer_ssa_multiplication_same_length(benchmark::State &state)
+{
+	state.SetLabel((std::stringstream{} << state.range(0)).str());
+
+	// REUSABLE VARIABLES
+	suuri::big_int_t a, b, c;
+	auto generator = [](uint32_t min, uint32_t max) {
+		static uint32_t seed = STARTSEED;
+		return pcg_random(seed, min, max);
+	};
+
+	for (auto _: state)
+	{
+		// SETUP CODE
+		a = suuri::big_int_t::random_of_size(state.range(0), generator);
+		b = suuri::big_int_t::random_of_size(state.range(0), generator);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		// --- CODE TO BE BENCHMARKED
+
+		c = a.ssa_multiplication(b);
+
+		// ---
+		auto end = std::chrono::high_resolution_clock::now();
+		auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+		state.SetIterationTime(elapsed_seconds.count());
+	}
+}
+BENCHMARK(BM_integer_ssa_multiplication_same_length)->STANDARDPARAMS;
+
+static void BM_integer_ssa_squaring(benchmark::State &state)
+{
+	state.SetLabel((std::stringstream{} << state.range(0)).str());
+
+	// REUSABLE VARIABLES
+	suuri::big_int_t a, b, c;
+	auto generator = [](uint32_t min, uint32_t max) {
+		static uint32_t seed = STARTSEED;
+		return pcg_random(seed, min, max);
+	};
+
+	for (auto _: state)
+	{
+		// SETUP CODE
+		a = suuri::big_int_t::random_of_size(state.range(0), generator);
+		b = suuri::big_int_t::random_of_size(state.range(0), generator);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		// --- CODE TO BE BENCHMARKED
+
+		c = a.ssa_multiplication(a);
+
+		// ---
+		auto end = std::chrono::high_resolution_clock::now();
+		auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+		state.SetIterationTime(elapsed_seconds.count());
+	}
+}
+BENCHMARK(BM_integer_ssa_squaring)->STANDARDPARAMS;
+
+static void BM_integer_fft_multiplication_same_length(benchmark::State &state)
+{
+	state.SetLabel((std::stringstream{} << state.range(0)).str());
+
+	// REUSABLE VARIABLES
+	suuri::big_int_t a, b, c;
+	auto generator = [](uint32_t min, uint32_t max) {
+		static uint32_t seed = STARTSEED;
+		return pcg_random(seed, min, max);
+	};
+
+	for (auto _: state)
+	{
+		// SETUP CODE
+		a = suuri::big_int_t::random_of_size(state.range(0), generator);
+		b = suuri::big_int_t::random_of_size(state.range(0), generator);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		// --- CODE TO BE BENCHMARKED
+
+		c = a.fft_multiplication(b);
+
+		// ---
+		auto end = std::chrono::high_resolution_clock::now();
+		auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+		state.SetIterationTime(elapsed_seconds.count());
+	}
+}
+BENCHMARK(BM_integer_fft_multiplication_same_length)->STANDARDPARAMS;
+
+static void BM_integer_fft_squaring(benchmark::State &state)
+{
+	state.SetLabel((std::stringstream{} << state.range(0)).str());
+
+	// REUSABLE VARIABLES
+	suuri::big_int_t a, b, c;
+	auto generator = [](uint32_t min, uint32_t max) {
+		static uint32_t seed = STARTSEED;
+		return pcg_random(seed, min, max);
+	};
+
+	for (auto _: state)
+	{
+		// SETUP CODE
+		a = suuri::big_int_t::random_of_size(state.range(0), generator);
+		b = suuri::big_int_t::random_of_size(state.range(0), generator);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		// --- CODE TO BE BENCHMARKED
+
+		c = a.fft_multiplication(a);
+
+		// ---
+		auto end = std::chrono::high_resolution_clock::now();
+		auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+		state.SetIterationTime(elapsed_seconds.count());
+	}
+}
+BENCHMARK(BM_integer_fft_squaring)->STANDARDPARAMS;
+
+static void BM_integer_squaring(benchmark::State &state)
+{
+	state.SetLabel((std::stringstream{} << state.range(0)).str());
+
+	// REUSABLE VARIABLES
+	suuri::big_int_t a, b, c;
+	auto generator = [](uint32_t min, uint32_t max) {
+		static uint32_t seed = STARTSEED;
+		return pcg_random(seed, min, max);
+	};
+
+	for (auto _: state)
+	{
+		// SETUP CODE
+		a = suuri::big_int_t::random_of_size(state.range(0), generator);
+		b = suuri::big_int_t::random_of_size(state.range(0), generator);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		// --- CODE TO BE BENCHMARKED
+
+		c = a.square();
+
+		// ---
+		auto end = std::chrono::high_resolution_clock::now();
+		auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+		state.SetIterationTime(elapsed_seconds.count());
+	}
+}
+BENCHMARK(BM_integer_squaring)->STANDARDPARAMS;
+
+static void BM_integer_multiplication_same_length(benchmark::State &state)
+{
+	state.SetLabel((std::stringstream{} << state.range(0)).str());
+
+	// REUSABLE VARIABLES
+	suuri::big_int_t a, b, c;
+	auto generator = [](uint32_t min, uint32_t max) {
+		static uint32_t seed = STARTSEED;
+		return pcg_random(seed, min, max);
+	};
+
+	for (auto _: state)
+	{
+		// SETUP CODE
+		a = suuri::big_int_t::random_of_size(state.range(0), generator);
+		b = suuri::big_int_t::random_of_size(state.range(0), generator);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		// --- CODE TO BE BENCHMARKED
+
+		c = a * b;
+
+		// ---
+		auto end = std::chrono::high_resolution_clock::now();
+		auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+		state.SetIterationTime(elapsed_seconds.count());
+	}
+}
+BENCHMARK(BM_integer_multiplication_same_length)->STANDARDPARAMS;
+
+static void BM_integer_prepared_multiplication_same_length(benchmark::State &state)
+{
+	state.SetLabel((std::stringstream{} << state.range(0)).str());
+
+	// REUSABLE VARIABLES
+	suuri::big_int_t a, c;
+	auto generator = [](uint32_t min, uint32_t max) {
+		static uint32_t seed = STARTSEED;
+		return pcg_random(seed, min, max);
+	};
+	const suuri::PreparedMultiplier<> b(suuri::big_int_t::random_of_size(state.range(0), generator));
+
+	for (auto _: state)
+	{
+		// SETUP CODE
+		a = suuri::big_int_t::random_of_size(state.range(0), generator);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		// --- CODE TO BE BENCHMARKED
+
+		c = a * b;
+
+		// ---
+		auto end = std::chrono::high_resolution_clock::now();
+		auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+		state.SetIterationTime(elapsed_seconds.count());
+	}
+}
+BENCHMARK(BM_integer_prepared_multiplication_same_length)->STANDARDPARAMS;
+
+
+static void BM_integer_toom32_multiplication_ratio(benchmark::State &state)
+{
+	const auto shorter = state.range(0);
+	const auto longer = state.range(0) * state.range(1) / 100;
+	state.SetLabel((std::stringstream{} << shorter << "x" << longer).str());
+
+	// REUSABLE VARIABLES
+	suuri::big_int_t a, b, c;
+	auto generator = [](uint32_t min, uint32_t max) {
+		static uint32_t seed = STARTSEED;
+		return pcg_random(seed, min, max);
+	};
+
+	for (auto _: state)
+	{
+		// SETUP a.toom32_multiplication(b)
+		a = suuri::big_int_t::random_of_size(longer, generator);
+		b = suuri::big_int_t::random_of_size(shorter, generator);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		// --- a.toom32_multiplication(b) TO BE BENCHMARKED
+
+		c = a.toom32_multiplication(b);
+
+		// ---
+		auto end = std::chrono::high_resolution_clock::now();
+		auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+		state.SetIterationTime(elapsed_seconds.count());
+	}
+}
+BENCHMARK(BM_integer_toom32_multiplication_ratio)->RATIOPARAMS;
+
+static void BM_integer_toom42_multiplication_ratio(benchmark::State &state)
+{
+	const auto shorter = state.range(0);
+	const auto longer = state.range(0) * state.range(1) / 100;
+	state.SetLabel((std::stringstream{} << shorter << "x" << longer).str());
+
+	// REUSABLE VARIABLES
+	suuri::big_int_t a, b, c;
+	auto generator = [](uint32_t min, uint32_t max) {
+		static uint32_t seed = STARTSEED;
+		return pcg_random(seed, min, max);
+	};
+
+	for (auto _: state)
+	{
+		// SETUP a.toom42_multiplication(b)
+		a = suuri::big_int_t::random_of_size(longer, generator);
+		b = suuri::big_int_t::random_of_size(shorter, generator);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		// --- a.toom42_multiplication(b) TO BE BENCHMARKED
+
+		c = a.toom42_multiplication(b);
+
+		// ---
+		auto end = std::chrono::high_resolution_clock::now();
+		auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+		state.SetIterationTime(elapsed_seconds.count());
+	}
+}
+BENCHMARK(BM_integer_toom42_multiplication_ratio)->RATIOPARAMS;
+
+static void BM_integer_toom63_multiplication_ratio(benchmark::State &state)
+{
+	const auto shorter = state.range(0);
+	const auto longer = state.range(0) * state.range(1) / 100;
+	state.SetLabel((std::stringstream{} << shorter << "x" << longer).str());
+
+	// REUSABLE VARIABLES
+	suuri::big_int_t a, b, c;
+	auto generator = [](uint32_t min, uint32_t max) {
+		static uint32_t seed = STARTSEED;
+		return pcg_random(seed, min, max);
+	};
+
+	for (auto _: state)
+	{
+		// SETUP a.toom63_multiplication(b)
+		a = suuri::big_int_t::random_of_size(longer, generator);
+		b = suuri::big_int_t::random_of_size(shorter, generator);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		// --- a.toom63_multiplication(b) TO BE BENCHMARKED
+
+		c = a.toom63_multiplication(b);
+
+		// ---
+		auto end = std::chrono::high_resolution_clock::now();
+		auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+		state.SetIterationTime(elapsed_seconds.count());
+	}
+}
+BENCHMARK(BM_integer_toom63_multiplication_ratio)->RATIOPARAMS;
+
+static void BM_integer_chunked_multiplication_ratio(benchmark::State &state)
+{
+	const auto shorter = state.range(0);
+	const auto longer = state.range(0) * state.range(1) / 100;
+	state.SetLabel((std::stringstream{} << shorter << "x" << longer).str());
+
+	// REUSABLE VARIABLES
+	suuri::big_int_t a, b, c;
+	auto generator = [](uint32_t min, uint32_t max) {
+		static uint32_t seed = STARTSEED;
+		return pcg_random(seed, min, max);
+	};
+
+	for (auto _: state)
+	{
+		// SETUP a.chunked_multiplication(b)
+		a = suuri::big_int_t::random_of_size(longer, generator);
+		b = suuri::big_int_t::random_of_size(shorter, generator);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		// --- a.chunked_multiplication(b) TO BE BENCHMARKED
+
+		c = a.chunked_multiplication(b);
+
+		// ---
+		auto end = std::chrono::high_resolution_clock::now();
+		auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+		state.SetIterationTime(elapsed_seconds.count());
+	}
+}
+BENCHMARK(BM_integer_chunked_multiplication_ratio)->RATIOPARAMS;
+
+static void BM_integer_multiplication_ratio(benchmark::State &state)
+{
+	const auto shorter = state.range(0);
+	const auto longer = state.range(0) * state.range(1) / 100;
+	state.SetLabel((std::stringstream{} << shorter << "x" << longer).str());
+
+	// REUSABLE VARIABLES
+	suuri::big_int_t a, b, c;
+	auto generator = [](uint32_t min, uint32_t max) {
+		static uint32_t seed = STARTSEED;
+		return pcg_random(seed, min, max);
+	};
+
+	for (auto _: state)
+	{
+		// SETUP a * b
+		a = suuri::big_int_t::random_of_size(longer, generator);
+		b = suuri::big_int_t::random_of_size(shorter, generator);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		// --- a * b TO BE BENCHMARKED
+
+		c = a * b;
+
+		// ---
+		auto end = std::chrono::high_resolution_clock::now();
+		auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+		state.SetIterationTime(elapsed_seconds.count());
+	}
+}
+BENCHMARK(BM_integer_multiplication_ratio)->RATIOPARAMS;
+
+
+static void BM_integer_pow_mod(benchmark::State &state)
+{
+	// The second argument picks the emulated Montgomery kernels, or an even modulus, which takes Barrett reduction
+	state.SetLabel((std::stringstream{} << state.range(0) << (state.range(1) == 1 ? " emulated" : state.range(1) == 2 ? " even" : "")).str());
+
+	// REUSABLE VARIABLES
+	suuri::big_int_t a, e, m, c;
+	auto generator = [](uint32_t min, uint32_t max) {
+		static uint32_t seed = STARTSEED;
+		return pcg_random(seed, min, max);
+	};
+	const auto backend = state.range(1) == 1 ? suuri::ifma::Backend::emulated : suuri::ifma::best_backend();
+
+	for (auto _: state)
+	{
+		// SETUP CODE
+		a = suuri::big_int_t::random_of_size(state.range(0) / 64, generator);
+		e = suuri::big_int_t::random_of_size(state.range(0) / 64, generator);
+		m = suuri::big_int_t::random_of_size(state.range(0) / 64, generator) + suuri::big_int_t(2).pow(state.range(0) - 1);
+		if ((m % 2 == 0) != (state.range(1) == 2))
+			m += 1;
+		if (a >= m)
+			a -= m;
+
+		auto start = std::chrono::high_resolution_clock::now();
+		// --- CODE TO BE BENCHMARKED
+
+		c = a.pow_mod(e, m, backend);
+
+		// ---
+		auto end = std::chrono::high_resolution_clock::now();
+		auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+		state.SetIterationTime(elapsed_seconds.count());
+	}
+}
+BENCHMARK(BM_integer_pow_mod)->MODULUSPARAMS;
 
 BENCHMARK_MAIN();
\ No newline at end of file
@@ -3,93 +3,123 @@
 #include "suuri_concept.hpp"
 #include "suuri_core.hpp"
 #include "suuri_exception.hpp"
+#include "suuri_fft.hpp"
+#include "suuri_ifma.hpp"
+#include "suuri_limbs.hpp"
+#include "suuri_ntt.hpp"
+#include "suuri_parallel.hpp"
 
 #include <algorithm>
 #include <assert.h>
+#include <bit>
 #include <concepts>
+#include <cstddef>
+#include <cstring>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <memory_resource>
 #include <ostream>
+#include <span>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 namespace suuri
 {
 
-class BigInt
+/**
+ * Order of the words in a buffer that a big integer is imported from or exported to.
+ */
+enum class word_order
 {
-private:
-	struct BigIntView {
-		constexpr BigIntView(const BigInt &rhs, bool negative = false) : digits_{rhs.digits_} {};
-
-		const digit_storage_t &digits_;
-	};
-
-	struct BigIntMutView {
-		constexpr BigIntMutView(BigInt &rhs, bool negative = false) : digits_{rhs.digits_} {};
-
-		digit_storage_t &digits_;
-	};
-
-	struct BigIntViewWithSign {
-		constexpr BigIntViewWithSign(const BigInt &rhs, bool negative = false) : digits_{rhs.digits_}, negative_{negative} {};
-
-		const digit_storage_t &digits_;
-		bool negative_;
-	};
+	least_significant_first,
+	most_significant_first,
+};
 
-	struct BigIntMutViewWithSign {
-		constexpr BigIntMutViewWithSign(BigInt &rhs, bool negative = false) : digits_{rhs.digits_}, negative_{negative} {};
+/**
+ * Arbitrary precision integer.
+ * @tparam Allocator Allocator used for the digits, and for every temporary created while computing with them.
+ */
+template<typename Allocator = std::allocator<digit_t>>
+class BasicBigInt
+{
+public:
+	typedef Allocator allocator_type;
+	typedef basic_digit_storage_t<Allocator> storage_type;
 
-		digit_storage_t &digits_;
-		bool negative_;
-	};
+	/**
+	 * From this number of chunks of characters, as many as fit in a limb each, the string constructor combines them by
+	 * divide and conquer, with a multiplication by a power of the base at every level, instead of one after the other.
+	 */
+	static SUURI_THRESHOLD(from_string_dc_threshold, SUURI_FROM_STRING_DC_THRESHOLD);
+	/**
+	 * From this number of limbs, to_string splits the value by divide and conquer, with a division by a power of ten at
+	 * every level, instead of dividing off one chunk of decimal digits after the other.
+	 */
+	static SUURI_THRESHOLD(to_string_dc_threshold, SUURI_TO_STRING_DC_THRESHOLD);
 
-public:
 	//// Constructors
 
 	/**
 	 * Initialises to positive 0
 	 */
-	constexpr BigInt()
-		: digits_({0}), negative_(false)
+	constexpr BasicBigInt()
+		: BasicBigInt(Allocator())
+	{}
+	/**
+	 * Initialises to positive 0
+	 * @param alloc The allocator to use for the digits.
+	 */
+	constexpr explicit BasicBigInt(const Allocator &alloc)
+		: digits_({0}, alloc), negative_(false)
 	{}
 	/**
 	 * Initialises with a primitive integer type
 	 * @tparam Must be a builtin primitive integral type
 	 */
-	template<typename T>
-		requires std::is_fundamental_v<T> && std::integral<T>
-	constexpr BigInt(T num)
-		: digits_(), negative_(num < 0)
+	template<primitive_integral T>
+	constexpr BasicBigInt(T num, const Allocator &alloc = Allocator())
+		: digits_({static_cast<digit_t>(num)}, alloc), negative_(num < 0)
 	{
-		num = negative_ ? -num : num;
+		static_assert(sizeof(T) <= sizeof(digit_t), "Primitive must fit in a single digit");
 
-		while (num >= base)
-		{
-			digits_.push_back(num % base);
-			num /= base;
-		}
-		digits_.push_back(num);
+		// Negating in unsigned arithmetic also handles the minimum value of signed types
+		if (negative_)
+			digits_[0] = 0 - digits_[0];
 	}
 	/**
-	 * @param digits An	 rvalue reference to a digit_storage_t container holding the digits of the integer.
+	 * @param digits An	 rvalue reference to a storage_type container holding the digits of the integer.
 	 * @param negative Flag indicating if the integer is negative. Defaults to false.
 	 */
-	constexpr explicit BigInt(digit_storage_t &&digits, bool negative = false)
+	constexpr explicit BasicBigInt(storage_type &&digits, bool negative = false)
 		: digits_(std::move(digits)), negative_(negative)
 	{}
 	/**
-	 * @param digits A reference to a digit_storage_t container holding the digits of the integer.
+	 * @param digits A reference to a storage_type container holding the digits of the integer.
+	 * @param negative Flag indicating if the integer is negative. Defaults to false.
+	 */
+	constexpr explicit BasicBigInt(const storage_type &digits, bool negative = false)
+		: digits_(digits), negative_(negative)
+	{}
+	/**
+	 * @param digits A range holding the digits of the integer, least significant first. No check is made on the values of the digits.
 	 * @param negative Flag indicating if the integer is negative. Defaults to false.
+	 * @param alloc The allocator to use for the digits.
 	 */
-	constexpr explicit BigInt(const digit_storage_t &digits, bool negative = false)
-		: digits_(digits.begin(), digits.end()), negative_(negative)
+	template<typename Range>
+		requires range_of_integral<Range>
+	constexpr explicit BasicBigInt(const Range &digits, bool negative = false, const Allocator &alloc = Allocator())
+		: digits_(std::ranges::begin(digits), std::ranges::end(digits), alloc), negative_(negative)
 	{}
 	/**
 	 * Initialise using a string view
 	 * @param str A string view containing the digits of the integer (see spec for how to specify a base other than 10).
+	 * @param alloc The allocator to use for the digits.
 	 */
-	constexpr explicit BigInt(const std::string &str)
-		: digits_({0}), negative_(false)
+	constexpr explicit BasicBigInt(const std::string &str, const Allocator &alloc = Allocator())
+		: digits_({0}, alloc), negative_(false)
 	{
 		uint32_t b;
 
@@ -108,7 +138,7 @@ public:
 				b = std::stoi(str.substr(i, i + 2));
 				i += 2;
 			}
-			if (str[i] != '_' || b > 36)
+			if (str[i] != '_' || b < 2 || b > 36)
 				throw std::invalid_argument("Invalid base argument!");
 			i++;
 		} else
@@ -122,33 +152,45 @@ public:
 		} else
 			negative = false;
 
-		*this += BigInt(convert_char_to_int(str[i], b));
-		i++;
-		for (; i < str.size(); i++)
-		{
-			*this *= BigInt(b);
-			*this += BigInt(convert_char_to_int(str[i], b));
-		}
+		if (i == str.size())
+			throw std::invalid_argument("Invalid character");
 
+		*this = from_characters(std::string_view(str).substr(i), b, alloc);
 		negative_ = negative;
 	}
 
 	// Copy constructor and move constructor
 
-	constexpr BigInt(const BigInt &rhs) = default;
-	constexpr BigInt(BigInt &&rhs) = default;
+	constexpr BasicBigInt(const BasicBigInt &rhs) = default;
+	constexpr BasicBigInt(BasicBigInt &&rhs) = default;
+	constexpr BasicBigInt(const BasicBigInt &rhs, const Allocator &alloc)
+		: digits_(rhs.digits_, alloc), negative_(rhs.negative_)
+	{}
+	constexpr BasicBigInt(BasicBigInt &&rhs, const Allocator &alloc)
+		: digits_(std::move(rhs.digits_), alloc), negative_(rhs.negative_)
+	{}
 
 
 	//// Operators
 
 	/// Assignment Operators
 
-	constexpr BigInt &operator=(const BigInt &rhs) = default;
-	constexpr BigInt &operator=(BigInt &&rhs) = default;
+	constexpr BasicBigInt &operator=(const BasicBigInt &rhs) = default;
+	constexpr BasicBigInt &operator=(BasicBigInt &&rhs) = default;
+	/**
+	 * @brief Evaluates a lazy expression (see suuri_expression.hpp) straight into this value.
+	 */
+	template<typename Expression>
+		requires is_big_int_expression_v<Expression>
+	constexpr BasicBigInt &operator=(const Expression &expression)
+	{
+		expression.assign_to(*this);
+		return *this;
+	}
 
 	/// Comparison Operators
 
-	constexpr bool operator==(const BigInt &rhs) const
+	constexpr bool operator==(const BasicBigInt &rhs) const
 	{
 		if (digits_.size() != rhs.digits_.size())
 			return false;
@@ -164,28 +206,28 @@ public:
 
 		return true;
 	}
-	constexpr bool operator<(const BigInt &rhs) const
+	constexpr bool operator<(const BasicBigInt &rhs) const
 	{
 		if (is_zero() && rhs.is_zero())
 			return false;
 		if (negative_ != rhs.negative_)
 			return negative_;
 
-		auto compareResult = digits_compare(digits_, rhs.digits_);
+		auto compareResult = limbs::cmp(digits_, rhs.digits_);
 
 		if (negative_)
 			return compareResult == std::strong_ordering::greater;
 
 		return compareResult == std::strong_ordering::less;
 	}
-	constexpr bool operator<=(const BigInt &rhs) const
+	constexpr bool operator<=(const BasicBigInt &rhs) const
 	{
 		if (is_zero() && rhs.is_zero())
 			return true;
 		if (negative_ != rhs.negative_)
 			return negative_;
 
-		auto compareResult = digits_compare(digits_, rhs.digits_);
+		auto compareResult = limbs::cmp(digits_, rhs.digits_);
 		if (compareResult == std::strong_ordering::equal)
 			return true;
 		if (negative_)
@@ -193,28 +235,28 @@ public:
 
 		return compareResult == std::strong_ordering::less;
 	}
-	constexpr bool operator>(const BigInt &rhs) const
+	constexpr bool operator>(const BasicBigInt &rhs) const
 	{
 		if (is_zero() && rhs.is_zero())
 			return false;
 		if (negative_ != rhs.negative_)
 			return rhs.negative_;
 
-		auto compareResult = digits_compare(digits_, rhs.digits_);
+		auto compareResult = limbs::cmp(digits_, rhs.digits_);
 
 		if (negative_)
 			return compareResult == std::strong_ordering::less;
 
 		return compareResult == std::strong_ordering::greater;
 	}
-	constexpr bool operator>=(const BigInt &rhs) const
+	constexpr bool operator>=(const BasicBigInt &rhs) const
 	{
 		if (is_zero() && rhs.is_zero())
 			return true;
 		if (negative_ != rhs.negative_)
 			return rhs.negative_;
 
-		auto compareResult = digits_compare(digits_, rhs.digits_);
+		auto compareResult = limbs::cmp(digits_, rhs.digits_);
 		if (compareResult == std::strong_ordering::equal)
 			return true;
 		if (negative_)
@@ -222,7 +264,20 @@ public:
 
 		return compareResult == std::strong_ordering::greater;
 	}
-	constexpr std::strong_ordering operator<=>(const BigInt &rhs) const
+	/**
+	 * @brief Compares with a primitive directly, without converting it to a big integer. <, <=, > and >= are rewritten to use <=>.
+	 */
+	template<primitive_integral T>
+	constexpr bool operator==(T rhs) const noexcept
+	{
+		return compare_primitive(rhs) == std::strong_ordering::equal;
+	}
+	template<primitive_integral T>
+	constexpr std::strong_ordering operator<=>(T rhs) const noexcept
+	{
+		return compare_primitive(rhs);
+	}
+	constexpr std::strong_ordering operator<=>(const BasicBigInt &rhs) const
 	{
 		if (is_zero() && rhs.is_zero())
 			return std::strong_ordering::equal;
@@ -234,27 +289,55 @@ public:
 		}
 
 		if (negative_)
-			return digits_compare(rhs.digits_, digits_);
-		return digits_compare(digits_, rhs.digits_);
+			return limbs::cmp(rhs.digits_, digits_);
+		return limbs::cmp(digits_, rhs.digits_);
 	}
 
 	/// Arithmetic Operators
 
 	// ---------- Addition
+	// The rvalue overloads add into the storage of a temporary operand instead of copying, so chains like a + b + c only allocate once.
+	// A temporary is only reused if it shares the allocator of the left operand, which is the allocator a result always gets.
+
+	constexpr BasicBigInt operator+(const BasicBigInt &rhs) const &
+	{
+		// Returning the result of += would copy it, and copies do not keep the allocator
+		BasicBigInt ret{*this, get_allocator()};
+		ret += rhs;
+		return ret;
+	}
+	constexpr BasicBigInt operator+(const BasicBigInt &rhs) &&
+	{
+		*this += rhs;
+		return std::move(*this);
+	}
+	friend constexpr BasicBigInt operator+(const BasicBigInt &lhs, BasicBigInt &&rhs)
+	{
+		if (lhs.get_allocator() != rhs.get_allocator())
+			return lhs + std::as_const(rhs);
 
-	constexpr BigInt operator+(const BigInt &rhs) const
+		rhs += lhs;
+		return std::move(rhs);
+	}
+	friend constexpr BasicBigInt operator+(BasicBigInt &&lhs, BasicBigInt &&rhs)
 	{
-		return (BigInt(*this) += rhs);
+		return std::move(lhs) + std::as_const(rhs);
 	}
-	constexpr BigInt &operator+=(const BigInt &rhs)
+	constexpr BasicBigInt &operator+=(const BasicBigInt &rhs)
 	{
+		if (digits_.size() == 1 && rhs.digits_.size() == 1) [[likely]]
+		{
+			add_single_digit(rhs.digits_[0], rhs.negative_);
+			return *this;
+		}
+
 		if (rhs.is_zero())
 			return *this;
 
 		if (negative_ == rhs.negative_)
 		{
 			add_digits(rhs);
-		} else if (digits_compare(digits_, rhs.digits_) == std::strong_ordering::greater)
+		} else if (limbs::cmp(digits_, rhs.digits_) == std::strong_ordering::greater)
 		{
 			subtract_digits(rhs);
 		} else
@@ -269,19 +352,46 @@ public:
 
 	// ---------- Subtraction
 
-	constexpr BigInt operator-(const BigInt &rhs) const
+	constexpr BasicBigInt operator-(const BasicBigInt &rhs) const &
+	{
+		BasicBigInt ret{*this, get_allocator()};
+		ret -= rhs;
+		return ret;
+	}
+	constexpr BasicBigInt operator-(const BasicBigInt &rhs) &&
+	{
+		*this -= rhs;
+		return std::move(*this);
+	}
+	friend constexpr BasicBigInt operator-(const BasicBigInt &lhs, BasicBigInt &&rhs)
+	{
+		if (lhs.get_allocator() != rhs.get_allocator())
+			return lhs - std::as_const(rhs);
+
+		// lhs - rhs = -(rhs - lhs)
+		rhs -= lhs;
+		rhs.negate();
+		return std::move(rhs);
+	}
+	friend constexpr BasicBigInt operator-(BasicBigInt &&lhs, BasicBigInt &&rhs)
 	{
-		return BigInt(*this) -= rhs;
+		return std::move(lhs) - std::as_const(rhs);
 	}
-	constexpr BigInt &operator-=(const BigInt &rhs)
+	constexpr BasicBigInt &operator-=(const BasicBigInt &rhs)
 	{
+		if (digits_.size() == 1 && rhs.digits_.size() == 1) [[likely]]
+		{
+			add_single_digit(rhs.digits_[0], !rhs.negative_);
+			return *this;
+		}
+
 		if (rhs.is_zero())
 			return *this;
 
 		if (negative_ != rhs.negative_)
 		{
 			add_digits(rhs);
-		} else if (digits_compare(digits_, rhs.digits_) == std::strong_ordering::greater)
+		} else if (limbs::cmp(digits_, rhs.digits_) == std::strong_ordering::greater)
 		{
 			subtract_digits(rhs);
 		} else
@@ -294,56 +404,262 @@ public:
 
 		return *this;
 	}
-	constexpr BigInt operator-()
+	constexpr BasicBigInt operator-() const &
 	{
-		auto ret = BigInt(*this);
+		auto ret = BasicBigInt(*this, get_allocator());
 		ret.negative_ = !negative_;
 		return ret;
 	}
+	constexpr BasicBigInt operator-() &&
+	{
+		negate();
+		return std::move(*this);
+	}
 
 	// ---------- Multiplication
 
-	constexpr BigInt operator*(const BigInt &rhs) const
+	constexpr BasicBigInt operator*(const BasicBigInt &rhs) const &
+	{
+		if (digits_.size() == 1 && rhs.digits_.size() == 1) [[likely]]
+		{
+			BasicBigInt ret{*this, get_allocator()};
+			ret.multiply_single_digit(rhs.digits_[0], rhs.negative_);
+			return ret;
+		}
+
+		return multiply(rhs);
+	}
+	constexpr BasicBigInt operator*(const BasicBigInt &rhs) &&
+	{
+		*this *= rhs;
+		return std::move(*this);
+	}
+	friend constexpr BasicBigInt operator*(const BasicBigInt &lhs, BasicBigInt &&rhs)
+	{
+		if (lhs.get_allocator() != rhs.get_allocator())
+			return lhs * std::as_const(rhs);
+
+		rhs *= lhs;
+		return std::move(rhs);
+	}
+	friend constexpr BasicBigInt operator*(BasicBigInt &&lhs, BasicBigInt &&rhs)
 	{
-		return long_multiplication(rhs);
+		return std::move(lhs) * std::as_const(rhs);
 	}
-	constexpr BigInt &operator*=(const BigInt &rhs)
+	constexpr BasicBigInt &operator*=(const BasicBigInt &rhs)
 	{
-		*this = long_multiplication(rhs);
+		if (digits_.size() == 1 && rhs.digits_.size() == 1) [[likely]]
+		{
+			multiply_single_digit(rhs.digits_[0], rhs.negative_);
+			return *this;
+		}
+
+		// Schoolbook multiplication can reuse the storage, but squaring in place would overwrite the digits of rhs while they are still needed
+		if (&rhs == this)
+		{
+			*this = square();
+			return *this;
+		}
+		if (std::min(digits_.size(), rhs.digits_.size()) >= limbs::karatsuba_threshold)
+		{
+			*this = multiply(rhs);
+			return *this;
+		}
+
+		multiply_in_place(rhs);
 		return *this;
 	}
 
 	// ---------- Division
 
-	constexpr BigInt operator/(const BigInt &rhs) const
+	constexpr BasicBigInt operator/(const BasicBigInt &rhs) const
 	{
-		if (rhs.is_zero())
-			throw divide_by_zero();
+		return std::move(divide_with_remainder(rhs).first);
+	}
+	constexpr BasicBigInt &operator/=(const BasicBigInt &rhs)
+	{
+		*this = std::move(divide_with_remainder(rhs).first);
+		return *this;
+	}
+	constexpr BasicBigInt operator%(const BasicBigInt &rhs) const
+	{
+		return std::move(divide_with_remainder(rhs).second);
+	}
+	constexpr BasicBigInt &operator%=(const BasicBigInt &rhs)
+	{
+		*this = *this % rhs;
+
+		return *this;
+	}
 
-		if (rhs.digits_.size() == 1)
-			return divide_small(static_cast<int64_t>(rhs.digits_[0]) * (rhs.negative_ * -1 + !rhs.negative_)).first;
+	// ---------- Primitive operands
+	// Integral primitives go straight to the single limb kernels instead of being converted to a big integer, so the
+	// compound assignments never allocate unless the value grows past its storage.
+
+	template<primitive_integral T>
+	constexpr BasicBigInt operator+(T rhs) const &
+	{
+		BasicBigInt ret{*this, get_allocator()};
+		ret += rhs;
+		return ret;
+	}
+	template<primitive_integral T>
+	constexpr BasicBigInt operator+(T rhs) &&
+	{
+		*this += rhs;
+		return std::move(*this);
+	}
+	template<primitive_integral T>
+	friend constexpr BasicBigInt operator+(T lhs, const BasicBigInt &rhs)
+	{
+		return rhs + lhs;
+	}
+	template<primitive_integral T>
+	friend constexpr BasicBigInt operator+(T lhs, BasicBigInt &&rhs)
+	{
+		return std::move(rhs) + lhs;
+	}
+	template<primitive_integral T>
+	constexpr BasicBigInt &operator+=(T rhs)
+	{
+		add_digit(magnitude_of(rhs), rhs < 0);
+		return *this;
+	}
 
-		return divide_binary_search(rhs);
+	template<primitive_integral T>
+	constexpr BasicBigInt operator-(T rhs) const &
+	{
+		BasicBigInt ret{*this, get_allocator()};
+		ret -= rhs;
+		return ret;
+	}
+	template<primitive_integral T>
+	constexpr BasicBigInt operator-(T rhs) &&
+	{
+		*this -= rhs;
+		return std::move(*this);
+	}
+	template<primitive_integral T>
+	friend constexpr BasicBigInt operator-(T lhs, const BasicBigInt &rhs)
+	{
+		// lhs - rhs = -(rhs - lhs)
+		BasicBigInt ret = rhs - lhs;
+		ret.negate();
+		return ret;
 	}
-	constexpr BigInt &operator/=(const BigInt &rhs)
+	template<primitive_integral T>
+	friend constexpr BasicBigInt operator-(T lhs, BasicBigInt &&rhs)
 	{
-		*this = divide_binary_search(rhs);
+		rhs -= lhs;
+		rhs.negate();
+		return std::move(rhs);
+	}
+	template<primitive_integral T>
+	constexpr BasicBigInt &operator-=(T rhs)
+	{
+		add_digit(magnitude_of(rhs), !(rhs < 0));
 		return *this;
 	}
-	constexpr BigInt operator%(const BigInt &rhs) const
+
+	template<primitive_integral T>
+	constexpr BasicBigInt operator*(T rhs) const &
 	{
-		if (rhs.is_zero())
+		BasicBigInt ret{*this, get_allocator()};
+		ret *= rhs;
+		return ret;
+	}
+	template<primitive_integral T>
+	constexpr BasicBigInt operator*(T rhs) &&
+	{
+		*this *= rhs;
+		return std::move(*this);
+	}
+	template<primitive_integral T>
+	friend constexpr BasicBigInt operator*(T lhs, const BasicBigInt &rhs)
+	{
+		return rhs * lhs;
+	}
+	template<primitive_integral T>
+	friend constexpr BasicBigInt operator*(T lhs, BasicBigInt &&rhs)
+	{
+		return std::move(rhs) * lhs;
+	}
+	template<primitive_integral T>
+	constexpr BasicBigInt &operator*=(T rhs)
+	{
+		multiply_digit(magnitude_of(rhs), rhs < 0);
+		return *this;
+	}
+
+	/**
+	 * @throws divide_by_zero If rhs is 0.
+	 */
+	template<primitive_integral T>
+	constexpr BasicBigInt operator/(T rhs) const &
+	{
+		BasicBigInt ret{*this, get_allocator()};
+		ret /= rhs;
+		return ret;
+	}
+	template<primitive_integral T>
+	constexpr BasicBigInt operator/(T rhs) &&
+	{
+		*this /= rhs;
+		return std::move(*this);
+	}
+	template<primitive_integral T>
+	friend constexpr BasicBigInt operator/(T lhs, const BasicBigInt &rhs)
+	{
+		return BasicBigInt(lhs, rhs.get_allocator()) / rhs;
+	}
+	/**
+	 * @brief Divides in place by a primitive, truncating towards zero like operator/.
+	 * @throws divide_by_zero If rhs is 0.
+	 */
+	template<primitive_integral T>
+	constexpr BasicBigInt &operator/=(T rhs)
+	{
+		if (rhs == 0)
 			throw divide_by_zero();
 
-		if (rhs.digits_.size() == 1)
-			return divide_small(static_cast<int64_t>(rhs.digits_[0]) * (rhs.negative_ * -1 + !rhs.negative_)).second;
+		limbs::divrem_1(digits_, digits_, magnitude_of(rhs));
+		remove_leading_zeros();
+		negative_ = !is_zero() && negative_ != (rhs < 0);
+		return *this;
+	}
+
+	/**
+	 * @return The remainder, which has the sign of this value like operator%. It has a single digit, so it is stored inline.
+	 * @throws divide_by_zero If rhs is 0.
+	 */
+	template<primitive_integral T>
+	constexpr BasicBigInt operator%(T rhs) const
+	{
+		if (rhs == 0)
+			throw divide_by_zero();
 
-		return *this - rhs * (*this / rhs);
+		BasicBigInt ret{limbs::mod_1(digits_, magnitude_of(rhs)), get_allocator()};
+		ret.negative_ = negative_ && !ret.is_zero();
+		return ret;
 	}
-	constexpr BigInt &operator%=(const BigInt &rhs)
+	template<primitive_integral T>
+	friend constexpr BasicBigInt operator%(T lhs, const BasicBigInt &rhs)
 	{
-		*this = *this % rhs;
+		return BasicBigInt(lhs, rhs.get_allocator()) % rhs;
+	}
+	/**
+	 * @throws divide_by_zero If rhs is 0.
+	 */
+	template<primitive_integral T>
+	constexpr BasicBigInt &operator%=(T rhs)
+	{
+		if (rhs == 0)
+			throw divide_by_zero();
 
+		const digit_t remainder = limbs::mod_1(digits_, magnitude_of(rhs));
+		digits_.resize(1);
+		digits_[0] = remainder;
+		negative_ = negative_ && remainder != 0;
 		return *this;
 	}
 
@@ -362,7 +678,25 @@ public:
 	//// State mutator methods
 
 	/**
-	 * @brief Negates the BigInt object.
+	 * @brief Sets the value to zero, keeping the allocated storage.
+	 */
+	constexpr void clear() noexcept
+	{
+		digits_.resize(1);
+		digits_[0] = 0;
+		negative_ = false;
+	}
+
+	/**
+	 * @brief Makes sure the value can grow to the given number of digits without allocating.
+	 */
+	constexpr void reserve(size_t digits)
+	{
+		digits_.reserve(digits);
+	}
+
+	/**
+	 * @brief Negates the BasicBigInt object.
 	 *
 	 * @return True if the resulting object is now negative. False otherwise.
 	 * @note Always returns false if the object is the zero value.
@@ -375,169 +709,527 @@ public:
 
 	//// Multiplication methods
 
-	[[nodiscard]] constexpr BigInt long_multiplication(const BigInt &rhs) const
+	[[nodiscard]] constexpr BasicBigInt long_multiplication(const BasicBigInt &rhs) const
 	{
-		BigInt ret{digit_storage_t(digits_.size() + rhs.digits_.size()), static_cast<bool>(negative_ ^ rhs.negative_)};
-
-		for (size_t i = 0; i < digits_.size(); i++)
-		{
-			for (size_t j = 0; j < rhs.digits_.size(); j++)
-			{
-				uint64_t res =
-						static_cast<uint64_t>(ret.digits_[i + j]) +
-						static_cast<uint64_t>(digits_[i]) * static_cast<uint64_t>(rhs.digits_[j]);
-				ret.digits_[i + j + 1] += res / base;
-				ret.digits_[i + j] = static_cast<uint32_t>(res % base);
-			}
-		}
+		BasicBigInt ret{storage_type(digits_.size() + rhs.digits_.size(), get_allocator()), static_cast<bool>(negative_ ^ rhs.negative_)};
 
-		if (ret.digits_.back() == 0)
-			ret.digits_.pop_back();
+		limbs::mul_basecase(ret.digits_, digits_, rhs.digits_);
+		ret.remove_leading_zeros();
 
 		return ret;
 	}
 
-	// [[nodiscard]] constexpr BigInt karatsuba_multiplication(const BigInt &rhs) const
-	// {
-	// 	digit_storage_t storage;
-	// 	storage.reserve(digits_.size() + rhs.digits_.size());
-	// 	BigInt ret{std::move(storage), negative_};
-	// 	ret.copy_digits_from(*this);
-	// 	return ret.karatsuba_multiplication_ref(rhs);
-	// }
-
-	[[nodiscard]] constexpr BigInt karatsuba_multiplication(const BigInt &rhs) const
+	/**
+	 * @brief Adds lhs * rhs to this value, without creating a temporary for the product.
+	 */
+	constexpr BasicBigInt &addmul(const BasicBigInt &lhs, const BasicBigInt &rhs)
 	{
-		auto ret =
-				karatsuba_multiplication_assume_positive(
-						BigIntView(*this, false),
-						BigIntView(rhs, false),
-						digits_.size() + rhs.digits_.size());
-		ret.negative_ = negative_ ^ rhs.negative_;
-		return ret;
+		return multiply_accumulate(lhs, rhs, lhs.negative_ != rhs.negative_);
 	}
 
-	//// Division methods
-
-	[[nodiscard]] constexpr std::pair<BigInt, BigInt> divide_small(int64_t rhs) const
+	/**
+	 * @brief Subtracts lhs * rhs from this value, without creating a temporary for the product.
+	 */
+	constexpr BasicBigInt &submul(const BasicBigInt &lhs, const BasicBigInt &rhs)
 	{
-		uint64_t remainder = 0;
-		digit_storage_t digits;
-		bool result_negative = negative_ != (rhs < 0);
-		rhs = rhs < 0 ? -rhs : rhs;
-
-		for (size_t i = digits_.size() - 1; i < static_cast<size_t>(-1); i--)
-		{
-			digit_t next = (digits_[i] + remainder * base) / rhs;
-			remainder = (digits_[i] + remainder * base) % rhs;
-			digits.push_back(next);
-		}
-
-		std::ranges::reverse(digits);
-
-		auto quotient = BigInt{std::move(digits)};
-		quotient.remove_leading_zeros();
-		quotient.negative_ = result_negative;
-		auto ret_remainder = BigInt{remainder};
-		ret_remainder.negative_ = negative_;
-
-		return {quotient, ret_remainder};
+		return multiply_accumulate(lhs, rhs, lhs.negative_ == rhs.negative_);
 	}
 
-	[[nodiscard]] constexpr BigInt divide_binary_search(const BigInt &rhs) const
+	/**
+	 * @brief Multiplies using Karatsuba's algorithm.
+	 *
+	 * All temporary space needed by the recursion is allocated once up front, and the product is written straight into the result.
+	 */
+	[[nodiscard]] constexpr BasicBigInt karatsuba_multiplication(const BasicBigInt &rhs) const
 	{
-		BigInt low{0};
-		BigInt mid;
-		BigInt high{*this};
-		high.negative_ = false;
-
-		BigInt quotient{0};
-		while (low <= high)
-		{
-			mid = low + (high - low).divide_small(2).first;
-
-			if (digits_compare((mid * rhs).digits_, digits_) == std::strong_ordering::greater)
-			{
-				high = mid - 1;
-			} else
-			{
-				quotient = mid;
-				low = mid + 1;
-			}
-		}
+		BasicBigInt ret{storage_type(digits_.size() + rhs.digits_.size(), get_allocator()), static_cast<bool>(negative_ ^ rhs.negative_)};
+		storage_type scratch(limbs::karatsuba_scratch_size(std::max(digits_.size(), rhs.digits_.size())), get_allocator());
 
-		quotient.negative_ = negative_ != rhs.negative_;
+		limbs::mul_karatsuba(ret.digits_, digits_, rhs.digits_, scratch);
+		ret.remove_leading_zeros();
 
-		return quotient;
+		return ret;
 	}
 
-	//// Misc mutators
-
-	/// Shift methods
-
-	constexpr BigInt &left_shift(uint64_t shift_by)
+	/**
+	 * @brief Multiplies using Toom-3, evaluating at 0, 1, -1, 2 and infinity. Squares with the Toom-3 squaring when rhs is this value.
+	 *
+	 * Operands too small or too unbalanced for Toom-3 are multiplied by the multiplication dispatcher instead.
+	 */
+	[[nodiscard]] constexpr BasicBigInt toom3_multiplication(const BasicBigInt &rhs) const
 	{
-		if (is_zero())
-			return *this;
-
-		digits_.resize(digits_.size() + shift_by);
+		const size_t lhs_size = digits_.size();
+		const size_t rhs_size = rhs.digits_.size();
+		if (!limbs::toom3_applicable(lhs_size, rhs_size))
+			return multiply(rhs);
 
-		for (size_t i = digits_.size() - 1; i > shift_by - 1; i--)
+		BasicBigInt ret{storage_type(lhs_size + rhs_size, get_allocator()), static_cast<bool>(negative_ ^ rhs.negative_)};
+		if (&rhs == this)
 		{
-			digits_[i] = digits_[i - shift_by];
-		}
-		for (size_t i = 0; i < shift_by; i++)
+			storage_type scratch(limbs::sqr_toom3_scratch_size(lhs_size), get_allocator());
+			limbs::sqr_toom3(ret.digits_, digits_, scratch);
+		} else
 		{
-			digits_[i] = 0;
+			storage_type scratch(limbs::toom3_scratch_size(lhs_size, rhs_size), get_allocator());
+			limbs::mul_toom3(ret.digits_, digits_, rhs.digits_, scratch);
 		}
+		ret.remove_leading_zeros();
 
-		return *this;
+		return ret;
 	}
 
-	constexpr BigInt &right_shift(uint64_t shift_by)
+	/**
+	 * @brief Multiplies using Toom-4, evaluating at 0, infinity and 1, -1, 2, -2, 3. Squares when rhs is this value.
+	 *
+	 * Operands too small or too unbalanced for Toom-4 are multiplied by the multiplication dispatcher instead.
+	 */
+	[[nodiscard]] constexpr BasicBigInt toom4_multiplication(const BasicBigInt &rhs) const
 	{
-		if (shift_by >= digits_.size())
-		{
-			digits_ = {0};
-			return *this;
-		}
-
-		digits_.erase(digits_.begin(), digits_.begin() + shift_by);
-
-		return *this;
+		return toom_multiplication(rhs, limbs::toom4_points);
 	}
 
-	//// State accessor methods
-	// None so far
-
-	//// Conversion methods
-
-	// TODO: Convert to different base string
-	[[nodiscard]] constexpr std::string to_string() const
+	/**
+	 * @brief Multiplies using Toom-6.5, which evaluates at 12 points. Squares with Toom-6 when rhs is this value.
+	 *
+	 * Operands too small or too unbalanced for Toom-6.5 are multiplied by the multiplication dispatcher instead.
+	 */
+	[[nodiscard]] constexpr BasicBigInt toom6h_multiplication(const BasicBigInt &rhs) const
 	{
-		// TODO: This is slow ish, but definitely usable for most things. Make it faster.
-		std::vector<char> digits;
+		return toom_multiplication(rhs, limbs::toom6h_points);
+	}
 
-		BigInt num = *this;
-		num.negative_ = false;
+	/**
+	 * @brief Multiplies using Toom-8.5, which evaluates at 16 points. Squares with Toom-8 when rhs is this value.
+	 *
+	 * Operands too small or too unbalanced for Toom-8.5 are multiplied by the multiplication dispatcher instead.
+	 */
+	[[nodiscard]] constexpr BasicBigInt toom8h_multiplication(const BasicBigInt &rhs) const
+	{
+		return toom_multiplication(rhs, limbs::toom8h_points);
+	}
 
-		while (num >= 10)
-		{
-			auto division_result = num.divide_small(10);
-			num = division_result.first;
-			auto nextDigit = static_cast<char>(division_result.second.digits_[0]);
-			digits.push_back(nextDigit);
+	/**
+	 * @brief Multiplies using Toom-32, which splits the longer operand in 3 pieces and the shorter in 2.
+	 *
+	 * Meant for operands of which one is about one and a half times as long as the other. Operands too small or too unbalanced
+	 * for Toom-32 are multiplied by the multiplication dispatcher instead.
+	 */
+	[[nodiscard]] constexpr BasicBigInt toom32_multiplication(const BasicBigInt &rhs) const
+	{
+		return toom_pieces_multiplication(rhs, 3, 2);
+	}
+
+	/**
+	 * @brief Multiplies using Toom-42, which splits the longer operand in 4 pieces and the shorter in 2.
+	 *
+	 * Meant for operands of which one is about twice as long as the other. Operands too small or too unbalanced
+	 * for Toom-42 are multiplied by the multiplication dispatcher instead.
+	 */
+	[[nodiscard]] constexpr BasicBigInt toom42_multiplication(const BasicBigInt &rhs) const
+	{
+		return toom_pieces_multiplication(rhs, 4, 2);
+	}
+
+	/**
+	 * @brief Multiplies using Toom-63, which splits the longer operand in 6 pieces and the shorter in 3.
+	 *
+	 * Meant for larger operands of which one is about twice as long as the other. Operands too small or too unbalanced
+	 * for Toom-63 are multiplied by the multiplication dispatcher instead.
+	 */
+	[[nodiscard]] constexpr BasicBigInt toom63_multiplication(const BasicBigInt &rhs) const
+	{
+		return toom_pieces_multiplication(rhs, 6, 3);
+	}
+
+	/**
+	 * @brief Multiplies the shorter operand with chunks of the longer one of its own size, and adds up the products.
+	 */
+	[[nodiscard]] constexpr BasicBigInt chunked_multiplication(const BasicBigInt &rhs) const
+	{
+		const size_t lhs_size = digits_.size();
+		const size_t rhs_size = rhs.digits_.size();
+
+		BasicBigInt ret{storage_type(lhs_size + rhs_size, get_allocator()), static_cast<bool>(negative_ ^ rhs.negative_)};
+		storage_type scratch(limbs::chunked_scratch_size(lhs_size, rhs_size), get_allocator());
+
+		limbs::mul_chunked(ret.digits_, digits_, rhs.digits_, scratch);
+		ret.remove_leading_zeros();
+
+		return ret;
+	}
+
+	/**
+	 * @brief Multiplies using number theoretic transforms modulo three primes. Squares when rhs is this value.
+	 *
+	 * Only pays off for very large operands, but works for any size.
+	 */
+	[[nodiscard]] constexpr BasicBigInt ntt_multiplication(const BasicBigInt &rhs) const
+	{
+		const size_t lhs_size = digits_.size();
+		const size_t rhs_size = rhs.digits_.size();
+
+		BasicBigInt ret{storage_type(lhs_size + rhs_size, get_allocator()), static_cast<bool>(negative_ ^ rhs.negative_)};
+		if (&rhs == this)
+		{
+			storage_type scratch(ntt::sqr_scratch_size(lhs_size), get_allocator());
+			ntt::sqr(ret.digits_, digits_, scratch);
+		} else
+		{
+			storage_type scratch(ntt::mul_scratch_size(lhs_size, rhs_size), get_allocator());
+			ntt::mul(ret.digits_, digits_, rhs.digits_, scratch);
+		}
+		ret.remove_leading_zeros();
+
+		return ret;
+	}
+
+	/**
+	 * @brief Multiplies using a floating point FFT. Squares when rhs is this value.
+	 *
+	 * The operands are cut into as many bits per point as a proven bound on the rounding error allows, so the product is exact.
+	 * Operands too long for the bound to hold at any split are multiplied by the multiplication dispatcher instead.
+	 */
+	[[nodiscard]] BasicBigInt fft_multiplication(const BasicBigInt &rhs) const
+	{
+		const size_t lhs_size = digits_.size();
+		const size_t rhs_size = rhs.digits_.size();
+		if (!fft::applicable(lhs_size, rhs_size))
+			return multiply(rhs);
+
+		BasicBigInt ret{storage_type(lhs_size + rhs_size, get_allocator()), static_cast<bool>(negative_ ^ rhs.negative_)};
+		storage_type scratch(fft::scratch_size(lhs_size, rhs_size), get_allocator());
+		if (&rhs == this)
+			fft::sqr(ret.digits_, digits_, fft::as_real(scratch));
+		else
+			fft::mul(ret.digits_, digits_, rhs.digits_, fft::as_real(scratch));
+		ret.remove_leading_zeros();
+
+		return ret;
+	}
+
+	/**
+	 * @brief Multiplies using the Schönhage-Strassen algorithm modulo 2^N + 1. Squares when rhs is this value.
+	 *
+	 * Multiplication falls back to it for products too long for the number theoretic transforms, but it works for any size.
+	 */
+	[[nodiscard]] constexpr BasicBigInt ssa_multiplication(const BasicBigInt &rhs) const
+	{
+		const size_t lhs_size = digits_.size();
+		const size_t rhs_size = rhs.digits_.size();
+
+		BasicBigInt ret{storage_type(lhs_size + rhs_size, get_allocator()), static_cast<bool>(negative_ ^ rhs.negative_)};
+		if (&rhs == this)
+		{
+			storage_type scratch(limbs::ssa_scratch_size(lhs_size, lhs_size, true), get_allocator());
+			limbs::sqr_ssa(ret.digits_, digits_, scratch);
+		} else
+		{
+			storage_type scratch(limbs::ssa_scratch_size(lhs_size, rhs_size), get_allocator());
+			limbs::mul_ssa(ret.digits_, digits_, rhs.digits_, scratch);
+		}
+		ret.remove_leading_zeros();
+
+		return ret;
+	}
+
+	/**
+	 * @brief Multiplies schoolbook style in radix 2^52 with the AVX-512 IFMA kernels. Squares when rhs is this value.
+	 *
+	 * CPUs without IFMA, and constant evaluation, run the portable emulation of the kernels, which backend can also pick explicitly.
+	 */
+	[[nodiscard]] constexpr BasicBigInt ifma_multiplication(const BasicBigInt &rhs, ifma::Backend backend = ifma::best_backend()) const
+	{
+		const size_t lhs_size = digits_.size();
+		const size_t rhs_size = rhs.digits_.size();
+
+		BasicBigInt ret{storage_type(lhs_size + rhs_size, get_allocator()), static_cast<bool>(negative_ ^ rhs.negative_)};
+		if (&rhs == this)
+			ifma::sqr(ret.digits_, digits_, backend);
+		else
+			ifma::mul(ret.digits_, digits_, rhs.digits_, backend);
+		ret.remove_leading_zeros();
+
+		return ret;
+	}
+
+	//// Division methods
+
+	[[nodiscard]] constexpr std::pair<BasicBigInt, BasicBigInt> divide_small(int64_t rhs) const
+	{
+		const bool rhs_negative = rhs < 0;
+
+		return divide_by_digit(rhs_negative ? 0 - static_cast<digit_t>(rhs) : static_cast<digit_t>(rhs), rhs_negative);
+	}
+
+	/**
+	 * @brief Divides by rhs with limbs::divrem, which divides by divide and conquer on top of the multiplication dispatcher
+	 * for long divisors and quotients.
+	 *
+	 * @return The quotient, truncated towards zero, and the remainder, which has the sign of this value.
+	 * @throws divide_by_zero If rhs is 0.
+	 */
+	[[nodiscard]] constexpr std::pair<BasicBigInt, BasicBigInt> divide_with_remainder(const BasicBigInt &rhs) const
+	{
+		if (rhs.is_zero())
+			throw divide_by_zero();
+
+		const size_t lhs_size = digits_.size();
+		const size_t rhs_size = rhs.digits_.size();
+		if (rhs_size == 1)
+			return divide_by_digit(rhs.digits_[0], rhs.negative_);
+		if (lhs_size < rhs_size)
+			return {BasicBigInt(0, get_allocator()), BasicBigInt(*this, get_allocator())};
+
+		BasicBigInt quotient{storage_type(lhs_size - rhs_size + 1, get_allocator()), negative_ != rhs.negative_};
+		BasicBigInt remainder{storage_type(rhs_size, get_allocator()), negative_};
+		storage_type scratch(limbs::divrem_scratch_size(lhs_size, rhs_size), get_allocator());
+		limbs::divrem(quotient.digits_, remainder.digits_, digits_, rhs.digits_, scratch);
+		quotient.remove_leading_zeros();
+		remainder.remove_leading_zeros();
+		quotient.negative_ = quotient.negative_ && !quotient.is_zero();
+		remainder.negative_ = remainder.negative_ && !remainder.is_zero();
+
+		return {std::move(quotient), std::move(remainder)};
+	}
+
+	//// Misc mutators
+
+	/// Shift methods
+
+	constexpr BasicBigInt &left_shift(uint64_t shift_by)
+	{
+		if (is_zero())
+			return *this;
+
+		digits_.resize(digits_.size() + shift_by);
+
+		for (size_t i = digits_.size() - 1; i > shift_by - 1; i--)
+		{
+			digits_[i] = digits_[i - shift_by];
+		}
+		for (size_t i = 0; i < shift_by; i++)
+		{
+			digits_[i] = 0;
+		}
+
+		return *this;
+	}
+
+	constexpr BasicBigInt &right_shift(uint64_t shift_by)
+	{
+		if (shift_by >= digits_.size())
+		{
+			digits_ = {0};
+			return *this;
 		}
-		digits.push_back(static_cast<char>(num.digits_[0]));
 
-		std::string ret;
-		ret.resize(digits.size());
+		digits_.erase(digits_.begin(), digits_.begin() + shift_by);
+
+		return *this;
+	}
+
+	//// State accessor methods
+
+	[[nodiscard]] constexpr allocator_type get_allocator() const noexcept
+	{
+		return digits_.get_allocator();
+	}
+
+	/**
+	 * @return True if the sign of the value is negative. No arithmetic leaves a negative zero.
+	 */
+	[[nodiscard]] constexpr bool is_negative() const noexcept
+	{
+		return negative_;
+	}
+
+	/**
+	 * @return The digits of the absolute value, least significant first. There are no leading zero digits, except for the single digit of zero.
+	 */
+	[[nodiscard]] constexpr std::span<const digit_t> digits() const noexcept
+	{
+		return digits_;
+	}
+
+	//// Conversion methods
 
-		for (int i = 0; i < ret.size(); i++)
+	// TODO: Convert to different base string
+	/**
+	 * @param char_alloc The allocator for the returned string. Temporaries made during the conversion use the allocator of this object.
+	 */
+	template<typename CharAllocator = std::allocator<char>>
+	[[nodiscard]] constexpr std::basic_string<char, std::char_traits<char>, CharAllocator> to_string(const CharAllocator &char_alloc = CharAllocator()) const
+	{
+		std::vector<char, typename std::allocator_traits<Allocator>::template rebind_alloc<char>> digits(get_allocator());
+		digits.reserve(digits_.size() * 20);
+
+		if (digits_.size() < to_string_dc_threshold)
+		{
+			write_decimal(digits, 0, {});
+		} else
 		{
-			ret[ret.size() - i - 1] = static_cast<char>('0' + digits[i]);
+			// Powers 10^(19 * 2^k), up to the largest with at most half the limbs of the value
+			std::vector<BasicBigInt, typename std::allocator_traits<Allocator>::template rebind_alloc<BasicBigInt>> powers(get_allocator());
+			powers.push_back(BasicBigInt(decimal_chunk_divisor, get_allocator()));
+			while (2 * powers.back().digits_.size() <= digits_.size())
+				powers.push_back(powers.back().square());
+
+			abs().write_decimal(digits, 0, powers);
 		}
 
+		return std::basic_string<char, std::char_traits<char>, CharAllocator>(digits.begin(), digits.end(), char_alloc);
+	}
+
+	//// Import and export methods
+	// Buffers are sequences of words of word_size bytes. The order of the words, and the order of the bytes within each word, are given
+	// separately. The top nails bits of every word are not part of the value. These are the same conventions as mpz_import / mpz_export.
+
+	/**
+	 * @brief Creates a non-negative value from a buffer of words, in linear time.
+	 *
+	 * @param data The words. Any bytes after the last whole word are ignored.
+	 * @param word_size The number of bytes per word.
+	 * @param order The order of the words.
+	 * @param endianness The order of the bytes within each word. std::endian::native may be used.
+	 * @param nails The number of most significant bits of each word to ignore. Must be less than 8 * word_size.
+	 */
+	[[nodiscard]] static constexpr BasicBigInt import_words(std::span<const std::byte> data, size_t word_size, word_order order,
+															std::endian endianness, size_t nails = 0, const Allocator &alloc = Allocator())
+	{
+		assert(word_size > 0 && nails < 8 * word_size && "Every word has to hold at least one bit of the value");
+
+		const size_t count = data.size() / word_size;
+		const size_t word_bits = 8 * word_size - nails;
+
+		BasicBigInt ret{alloc};
+		ret.digits_.resize(std::max<size_t>(1, (count * word_bits + digit_bits - 1) / digit_bits));
+
+		// With no nails and the least significant byte first overall, the buffer is already laid out like the digits in memory
+		if (!std::is_constant_evaluated() && count > 0 && std::endian::native == std::endian::little && nails == 0 &&
+			order == word_order::least_significant_first && endianness == std::endian::little)
+		{
+			std::memcpy(ret.digits_.data(), data.data(), count * word_size);
+		} else
+		{
+			digit_t accumulator = 0;
+			size_t accumulated_bits = 0;
+			size_t out = 0;
+
+			for (size_t w = 0; w < count; w++)
+			{
+				const auto word = data.subspan((order == word_order::least_significant_first ? w : count - 1 - w) * word_size, word_size);
+
+				size_t remaining = word_bits;
+				for (size_t b = 0; remaining > 0; b++)
+				{
+					const size_t take = std::min<size_t>(8, remaining);
+					const auto byte = word[endianness == std::endian::little ? b : word_size - 1 - b];
+					const digit_t value = std::to_integer<digit_t>(byte) & ((digit_t{1} << take) - 1);
+
+					accumulator |= value << accumulated_bits;
+					accumulated_bits += take;
+					if (accumulated_bits >= digit_bits)
+					{
+						ret.digits_[out++] = accumulator;
+						accumulated_bits -= digit_bits;
+						accumulator = accumulated_bits ? value >> (take - accumulated_bits) : 0;
+					}
+
+					remaining -= take;
+				}
+			}
+
+			if (accumulated_bits)
+				ret.digits_[out] = accumulator;
+		}
+
+		ret.remove_leading_zeros();
+		return ret;
+	}
+
+	/**
+	 * @brief Creates a non-negative value from a span of unsigned integer words, which are read in native byte order.
+	 */
+	template<std::unsigned_integral Word>
+	[[nodiscard]] static constexpr BasicBigInt import_words(std::span<const Word> words, word_order order, size_t nails = 0, const Allocator &alloc = Allocator())
+	{
+		return import_words(std::as_bytes(words), sizeof(Word), order, std::endian::native, nails, alloc);
+	}
+
+	/**
+	 * @return The number of bits in the absolute value, not counting leading zeros. Zero has a width of 0.
+	 */
+	[[nodiscard]] constexpr size_t bit_width() const noexcept
+	{
+		return (digits_.size() - 1) * digit_bits + static_cast<size_t>(std::bit_width(digits_.back()));
+	}
+
+	/**
+	 * @return The number of words export_words writes for the absolute value. Zero takes no words.
+	 */
+	[[nodiscard]] constexpr size_t export_size(size_t word_size, size_t nails = 0) const noexcept
+	{
+		const size_t word_bits = 8 * word_size - nails;
+		return (bit_width() + word_bits - 1) / word_bits;
+	}
+
+	/**
+	 * @brief Writes the absolute value into a caller provided buffer, in linear time. The sign is not exported.
+	 *
+	 * The parameters have the same meaning as for import_words, and nail bits are written as zero.
+	 *
+	 * @throws buffer_too_small If the buffer holds fewer than export_size(word_size, nails) words.
+	 * @return The part of the buffer that was written.
+	 */
+	constexpr std::span<std::byte> export_words(std::span<std::byte> buffer, size_t word_size, word_order order, std::endian endianness, size_t nails = 0) const
+	{
+		assert(word_size > 0 && nails < 8 * word_size && "Every word has to hold at least one bit of the value");
+
+		const size_t count = export_size(word_size, nails);
+		const size_t word_bits = 8 * word_size - nails;
+		if (buffer.size() < count * word_size)
+			throw buffer_too_small();
+
+		auto written = buffer.first(count * word_size);
+
+		if (!std::is_constant_evaluated() && count > 0 && std::endian::native == std::endian::little && nails == 0 &&
+			order == word_order::least_significant_first && endianness == std::endian::little)
+		{
+			// The last word may reach past the top digit
+			const size_t copied = std::min(written.size(), digits_.size() * sizeof(digit_t));
+			std::memcpy(written.data(), digits_.data(), copied);
+			std::fill(written.begin() + static_cast<ptrdiff_t>(copied), written.end(), std::byte{0});
+			return written;
+		}
+
+		size_t position = 0;
+		for (size_t w = 0; w < count; w++)
+		{
+			auto word = written.subspan((order == word_order::least_significant_first ? w : count - 1 - w) * word_size, word_size);
+
+			size_t remaining = word_bits;
+			for (size_t b = 0; b < word_size; b++)
+			{
+				const size_t take = std::min<size_t>(8, remaining);
+				word[endianness == std::endian::little ? b : word_size - 1 - b] = static_cast<std::byte>(bits_at(position, take));
+
+				position += take;
+				remaining -= take;
+			}
+		}
+
+		return written;
+	}
+
+	/**
+	 * @brief Exports the absolute value into a new buffer. See the overload writing to a caller provided buffer.
+	 */
+	template<typename ByteAllocator = std::allocator<std::byte>>
+	[[nodiscard]] constexpr std::vector<std::byte, ByteAllocator> export_words(size_t word_size, word_order order, std::endian endianness, size_t nails = 0,
+																				const ByteAllocator &byte_alloc = ByteAllocator()) const
+	{
+		std::vector<std::byte, ByteAllocator> ret(export_size(word_size, nails) * word_size, byte_alloc);
+		export_words(ret, word_size, order, endianness, nails);
 		return ret;
 	}
 
@@ -551,23 +1243,42 @@ public:
 		return negative_ ? -1 : 1;
 	}
 
-	[[nodiscard]] constexpr BigInt abs() const noexcept
+	[[nodiscard]] constexpr BasicBigInt abs() const noexcept
 	{
-		BigInt ret = *this;
+		BasicBigInt ret{*this, get_allocator()};
 		ret.negative_ = false;
 		return ret;
 	}
 
-	[[nodiscard]] constexpr BigInt pow(uint64_t n) const
+	/**
+	 * @brief Squares this value, using squaring algorithms at every size. These skip the cross products that are
+	 * computed twice when multiplying, or transform the operand once instead of twice.
+	 */
+	[[nodiscard]] constexpr BasicBigInt square() const
+	{
+		if (digits_.size() == 1)
+		{
+			digit_t high = 0;
+			const digit_t low = multiply_digits(digits_[0], digits_[0], high);
+
+			BasicBigInt ret{storage_type({low, high}, get_allocator())};
+			ret.remove_leading_zeros();
+			return ret;
+		}
+
+		return multiply(*this);
+	}
+
+	[[nodiscard]] constexpr BasicBigInt pow(uint64_t n) const
 	{
 #ifndef ZERO_POW_ZERO_IS_ONE
 		assert(!(is_zero() && n == 0) && "0 to the power of 0 is undefined");
 #endif
 		if (n == 0)
-			return 1;
+			return BasicBigInt(1, get_allocator());
 
-		auto x = *this;
-		decltype(x) y = 1;
+		BasicBigInt x{*this, get_allocator()};
+		BasicBigInt y{1, get_allocator()};
 		while (n > 1)
 		{
 			if (n % 2)
@@ -575,45 +1286,112 @@ public:
 				y = x * y;
 				n--;
 			}
-			x *= x;
+			x = x.square();
 			n /= 2;
 		}
 		return x * y;
 	}
 
+	/**
+	 * @brief Computes this^exponent modulo modulus, as a value from 0 up to the absolute value of modulus.
+	 *
+	 * Odd moduli of up to ifma::montgomery_max_digits 52 bit digits, which covers 4096 bit RSA, run on Montgomery
+	 * multiplication in radix 2^52, with the AVX-512 IFMA kernels where the CPU has them and their emulation elsewhere.
+	 * Other moduli reduce every product by Barrett reduction, whose quotient and remainder are short products.
+	 *
+	 * @param backend The kernels Montgomery multiplication runs on.
+	 * @throws divide_by_zero If modulus is 0.
+	 */
+	[[nodiscard]] constexpr BasicBigInt pow_mod(const BasicBigInt &exponent, const BasicBigInt &modulus,
+												ifma::Backend backend = ifma::best_backend()) const
+	{
+		assert(!exponent.negative_ && "The exponent cannot be negative");
+		if (modulus.is_zero())
+			throw divide_by_zero();
+
+		const BasicBigInt m = modulus.abs();
+		if (m == 1)
+			return BasicBigInt(0, get_allocator());
+
+		// Division is only needed when the base is not already reduced
+		BasicBigInt base{*this, get_allocator()};
+		if (negative_ || *this >= m)
+		{
+			base = *this % m;
+			if (base.negative_)
+				base += m;
+		}
+
+		const size_t size = ifma::montgomery_size(m.bit_width());
+		if (m.digits_[0] % 2 == 1 && size <= ifma::montgomery_max_digits)
+		{
+			storage_type digits(3 * size, get_allocator());
+			const auto modulus_digits = std::span(digits).first(size);
+			const auto base_digits = std::span(digits).subspan(size, size);
+			const auto result_digits = std::span(digits).subspan(2 * size);
+			ifma::to_radix52(modulus_digits, m.digits_);
+			ifma::to_radix52(base_digits, base.digits_);
+			ifma::montgomery_pow(result_digits, base_digits, exponent.digits_, modulus_digits, backend);
+
+			BasicBigInt ret{storage_type(m.digits_.size(), get_allocator())};
+			ifma::from_radix52(ret.digits_, result_digits);
+			ret.remove_leading_zeros();
+			return ret;
+		}
+
+		const size_t k = m.digits_.size();
+		storage_type digits(5 * k + 1, get_allocator());
+		const auto inverse = std::span(digits).first(k + 1);
+		const auto base_digits = std::span(digits).subspan(k + 1, k);
+		const auto power = std::span(digits).subspan(2 * k + 1, k);
+		const auto product = std::span(digits).subspan(3 * k + 1);
+		storage_type scratch(std::max({limbs::barrett_inverse_scratch_size(k), limbs::barrett_reduce_scratch_size(k),
+									   limbs::mul_scratch_size(k, k), limbs::sqr_scratch_size(k)}),
+							 get_allocator());
+
+		limbs::barrett_inverse(inverse, m.digits_, scratch);
+		std::copy(base.digits_.begin(), base.digits_.end(), base_digits.begin());
+		power[0] = 1;
+		for (size_t bit = exponent.bit_width(); bit-- > 0;)
+		{
+			limbs::sqr(product, power, scratch);
+			limbs::barrett_reduce(power, product, m.digits_, inverse, scratch);
+			if (exponent.digits_[bit / digit_bits] >> (bit % digit_bits) & 1)
+			{
+				limbs::mul(product, power, base_digits, scratch);
+				limbs::barrett_reduce(power, product, m.digits_, inverse, scratch);
+			}
+		}
+
+		BasicBigInt ret{storage_type(power.begin(), power.end(), get_allocator())};
+		ret.remove_leading_zeros();
+		return ret;
+	}
+
 	//// Static methods
 
 	template<typename Generator>
 		requires std::invocable<Generator, uint32_t, uint32_t>
-	static constexpr BigInt random_of_size(size_t num_digits, Generator &&generator)
+	static constexpr BasicBigInt random_of_size(size_t num_digits, Generator &&generator, const Allocator &alloc = Allocator())
 	{
 		if (num_digits == 0)
-			return 0;
+			return BasicBigInt(0, alloc);
 
-		BigInt ret;
+		BasicBigInt ret{alloc};
 		ret.digits_.resize(num_digits);
 
+		// The generator produces half digits, so every digit is built from two calls
 		for (auto &digit: ret.digits_)
-			digit = generator(0, base);
+			digit = (static_cast<digit_t>(generator(0, std::numeric_limits<uint32_t>::max())) << 32) |
+					static_cast<digit_t>(generator(0, std::numeric_limits<uint32_t>::max()));
 
 		return ret;
 	}
 
 private:
-	digit_storage_t digits_;
+	storage_type digits_;
 	bool negative_;
 
-	/// Private constructors
-
-	constexpr explicit BigInt(BigIntView view)
-		: digits_(view.digits_), negative_(false)
-	{}
-
-
-	//// Static constexpr member variables
-
-	static constexpr size_t long_multiplication_digit_threshold = 3;
-
 	//// Private methods
 
 	/// Helper methods
@@ -642,241 +1420,552 @@ private:
 		return true;
 	}
 
-	constexpr BigInt &copy_digits_from(const BigInt &rhs)
-	{
-		digits_.resize(rhs.digits_.size());
-		for (size_t i = 0; i < digits_.size(); ++i)
-			digits_[i] = rhs.digits_[i];
-
-		return *this;
-	}
+	/// Conversion helpers
 
-	/// Addition methods
+	/**
+	 * The largest power of ten that fits in a digit, which to_string divides off 19 decimal digits at a time with.
+	 */
+	static constexpr digit_t decimal_chunk_divisor = 10000000000000000000ull;
+	static constexpr size_t decimal_chunk_length = 19;
 
-	constexpr BigInt &add_digits(const BigInt &rhs)
+	/**
+	 * @brief Converts characters in base b, most significant first, to a non-negative value.
+	 *
+	 * As many characters as fit in a digit are converted at once, and the resulting chunks are combined by combine_chunks.
+	 */
+	static constexpr BasicBigInt from_characters(std::string_view chars, uint32_t b, const Allocator &alloc)
 	{
-		// We're going to need at least as much storage for the digits as rhs.
-		// TODO: Add optimisation that checks if we need rhs.size() + 1
-		if (rhs.digits_.size() > digits_.size())
+		if (b < 2 || b > 36)
+			throw std::invalid_argument("Invalid base argument!");
+
+		digit_t chunk_base = b;
+		size_t chunk_length = 1;
+		while (chunk_base <= std::numeric_limits<digit_t>::max() / b)
 		{
-			digits_.resize(rhs.digits_.size());
+			chunk_base *= b;
+			chunk_length++;
 		}
 
-		// Add the digits
-		digit_t carry = 0;
-		for (size_t i = 0; i < rhs.digits_.size(); i++)
+		// The most significant chunk takes the characters left over
+		const size_t chunk_count = (chars.size() + chunk_length - 1) / chunk_length;
+		std::vector<digit_t, Allocator> chunks(chunk_count, alloc);
+		size_t length = chars.size() - (chunk_count - 1) * chunk_length;
+		size_t position = 0;
+		for (auto &chunk: chunks)
 		{
-			digit_t sum = digits_[i] + rhs.digits_[i] + carry;
-
-			bool overflow = sum >= suuri::base;
-			digits_[i] = static_cast<uint32_t>(sum - suuri::base * overflow);
-			carry = overflow;
-
-			// TODO: Benchmark
-			//digits_[i] = sum % suuri::base;
-			//carry = sum / suuri::base;
+			chunk = 0;
+			for (size_t end = position + length; position < end; position++)
+				chunk = chunk * b + convert_char_to_int(chars[position], b);
+			length = chunk_length;
 		}
 
-		if (carry)
+		std::vector<BasicBigInt, typename std::allocator_traits<Allocator>::template rebind_alloc<BasicBigInt>> powers(alloc);
+		if (chunk_count >= from_string_dc_threshold)
 		{
-			// This has to be done before in case rhs is lhs
-			auto n = rhs.digits_.size();
+			// Powers chunk_base^(2^k), for low halves of up to half the chunks
+			powers.push_back(BasicBigInt(chunk_base, alloc));
+			while (size_t{2} << (powers.size() - 1) < chunk_count)
+				powers.push_back(powers.back().square());
+		}
 
-			digits_.resize(digits_.size() + 1);
+		return combine_chunks(chunks, chunk_base, powers, alloc);
+	}
 
-			while (digits_[n] == suuri::base - 1)
+	/**
+	 * @brief Combines chunks, most significant first, into the value they are the digits of in base chunk_base.
+	 *
+	 * Below from_string_dc_threshold chunks they are combined one after the other. Above it, the low part takes the largest
+	 * power of two number of chunks below the total, k, and the value is high * chunk_base^k + low.
+	 *
+	 * @param powers chunk_base^(2^i) for each i up to the number of times the chunks can be halved.
+	 */
+	static constexpr BasicBigInt combine_chunks(std::span<const digit_t> chunks, digit_t chunk_base, std::span<const BasicBigInt> powers,
+												const Allocator &alloc)
+	{
+		if (chunks.size() < from_string_dc_threshold || chunks.size() == 1)
+		{
+			// Each step multiplies by chunk_base and adds a chunk below it, which grows the value by at most one digit
+			storage_type digits(chunks.size(), alloc);
+			digits[0] = chunks[0];
+			size_t size = 1;
+			for (size_t i = 1; i < chunks.size(); i++)
 			{
-				digits_[n] = 0;
-				n++;
+				const auto value = std::span(digits).first(size);
+				digit_t high = limbs::mul_1(value, value, chunk_base);
+				high += limbs::add_1(value, value, chunks[i]);
+				if (high != 0)
+					digits[size++] = high;
 			}
+			digits.resize(size);
 
-			digits_[n]++;
+			BasicBigInt ret{std::move(digits)};
+			ret.remove_leading_zeros();
+			return ret;
 		}
 
-		return *this;
+		const size_t level = static_cast<size_t>(std::bit_width(chunks.size() - 1)) - 1;
+		const size_t low_count = size_t{1} << level;
+
+		BasicBigInt ret = combine_chunks(chunks.first(chunks.size() - low_count), chunk_base, powers, alloc) * powers[level];
+		ret += combine_chunks(chunks.last(low_count), chunk_base, powers, alloc);
+		return ret;
 	}
 
-	constexpr BigInt &subtract_digits(const BigInt &rhs)
+	/**
+	 * @brief Appends the decimal digits of this non-negative value to out, most significant first, padded with zeros to
+	 * at least width characters.
+	 *
+	 * From to_string_dc_threshold limbs, the value is split by the largest of powers with at most half its limbs, and each
+	 * part written recursively, the low part padded to the number of digits of the power.
+	 *
+	 * @param powers 10^(19 * 2^i) for each i, up to the largest power with at most half the limbs of the value.
+	 */
+	template<typename CharVector>
+	constexpr void write_decimal(CharVector &out, size_t width, std::span<const BasicBigInt> powers) const
 	{
-		int64_t carry = 0;
-		size_t i = 0;
-		for (; i < rhs.digits_.size(); i++)
+		if (digits_.size() < to_string_dc_threshold || powers.empty())
 		{
-			int64_t diff = static_cast<int64_t>(digits_[i]) - static_cast<int64_t>(rhs.digits_[i]) - carry;
+			// Repeatedly divide a copy of the digits by the largest power of ten that fits in a digit, which yields 19
+			// decimal digits per division. The digits are produced least significant first, and reversed at the end.
+			const size_t start = out.size();
+			storage_type num{digits_, get_allocator()};
+			std::span<digit_t> remaining{num};
+			while (remaining.size() > 1 || remaining[0] >= decimal_chunk_divisor)
+			{
+				digit_t chunk = limbs::divrem_1(remaining, remaining, decimal_chunk_divisor);
+				while (remaining.size() > 1 && remaining.back() == 0)
+					remaining = remaining.first(remaining.size() - 1);
+
+				for (size_t i = 0; i < decimal_chunk_length; i++)
+				{
+					out.push_back(static_cast<char>('0' + chunk % 10));
+					chunk /= 10;
+				}
+			}
 
-			bool underflow = diff < 0;
-			digits_[i] = static_cast<uint32_t>(diff + suuri::base * underflow);
-			carry = underflow;
+			// The most significant chunk is written without leading zeros
+			digit_t chunk = remaining[0];
+			do
+			{
+				out.push_back(static_cast<char>('0' + chunk % 10));
+				chunk /= 10;
+			} while (chunk != 0);
+
+			while (out.size() - start < width)
+				out.push_back('0');
+			std::reverse(out.begin() + static_cast<ptrdiff_t>(start), out.end());
+			return;
 		}
 
-		while (carry)
-		{
-			int64_t diff = static_cast<int64_t>(digits_[i]) - carry;
+		size_t level = 0;
+		while (level + 1 < powers.size() && 2 * powers[level + 1].digits_.size() <= digits_.size())
+			level++;
 
-			bool underflow = diff < 0;
-			digits_[i] = static_cast<uint32_t>(diff + suuri::base * underflow);
-			carry = underflow;
+		const auto [high, low] = divide_with_remainder(powers[level]);
+		const size_t low_width = decimal_chunk_length << level;
+		high.write_decimal(out, width > low_width ? width - low_width : 0, powers);
+		low.write_decimal(out, low_width, powers.first(level));
+	}
 
-			i++;
-		}
+	/**
+	 * @return The count bits of the absolute value starting at bit position, in the low bits. Bits above the value are zero.
+	 * @pre count < digit_bits.
+	 */
+	[[nodiscard]] constexpr digit_t bits_at(size_t position, size_t count) const noexcept
+	{
+		const size_t digit = position / digit_bits;
+		const size_t offset = position % digit_bits;
+		if (digit >= digits_.size() || count == 0)
+			return 0;
+
+		digit_t value = digits_[digit] >> offset;
+		if (offset + count > digit_bits && digit + 1 < digits_.size())
+			value |= digits_[digit + 1] << (digit_bits - offset);
 
-		if (digits_[digits_.size() - 1] == 0)
-			digits_.pop_back();
+		return value & ((digit_t{1} << count) - 1);
+	}
+
+	constexpr BasicBigInt &copy_digits_from(const BasicBigInt &rhs)
+	{
+		digits_.resize(rhs.digits_.size());
+		for (size_t i = 0; i < digits_.size(); ++i)
+			digits_[i] = rhs.digits_[i];
 
 		return *this;
 	}
 
-	constexpr BigInt &subtract_lhs_from_rhs_digits(const BigInt &rhs)
+	/// Single digit methods
+	// Values that fit in one digit are stored inline, and these do their arithmetic directly on that digit in hardware.
+	// The storage only grows to a second (still inline) digit when the result overflows.
+
+	/**
+	 * @brief Adds a signed single digit value to this single digit value.
+	 *
+	 * @param magnitude The absolute value to add.
+	 * @param negative Flag indicating if the value to add is negative.
+	 */
+	constexpr void add_single_digit(digit_t magnitude, bool negative) noexcept
 	{
-		//assert(!digitsLessThanFullPrecision(rhs, digits_) && "Subtraction result would be negative, and does thus not works with this function.");
+		assert(digits_.size() == 1 && "The fast path only works on single digit values");
 
-		if (rhs.digits_.size() > digits_.size())
+		digit_t &digit = digits_[0];
+		if (negative_ == negative)
 		{
-			digits_.resize(rhs.digits_.size());
+			digit_t carry = 0;
+			digit = add_with_carry(digit, magnitude, carry);
+			if (carry)
+				digits_.push_back(carry);
+		} else if (digit >= magnitude)
+		{
+			digit -= magnitude;
+			if (digit == 0)
+				negative_ = false;
+		} else
+		{
+			digit = magnitude - digit;
+			negative_ = !negative_;
 		}
+	}
 
-		int64_t carry = 0;
-		size_t i = 0;
-		for (; i < rhs.digits_.size(); i++)
-		{
-			int64_t diff = static_cast<int64_t>(rhs.digits_[i]) - static_cast<int64_t>(digits_[i]) - carry;
+	/**
+	 * @brief Multiplies this single digit value by a signed single digit value.
+	 *
+	 * @param magnitude The absolute value to multiply by.
+	 * @param negative Flag indicating if the value to multiply by is negative.
+	 */
+	constexpr void multiply_single_digit(digit_t magnitude, bool negative) noexcept
+	{
+		assert(digits_.size() == 1 && "The fast path only works on single digit values");
 
-			bool underflow = diff < 0;
-			digits_[i] = static_cast<uint32_t>(diff + suuri::base * underflow);
-			carry = underflow;
-		}
+		digit_t high;
+		digits_[0] = multiply_digits(digits_[0], magnitude, high);
+		if (high)
+			digits_.push_back(high);
+
+		negative_ = negative_ != negative && (digits_[0] != 0 || high != 0);
+	}
+
+	/**
+	 * @return The absolute value of a primitive, as a digit.
+	 */
+	template<primitive_integral T>
+	static constexpr digit_t magnitude_of(T value) noexcept
+	{
+		static_assert(sizeof(T) <= sizeof(digit_t), "Primitive must fit in a single digit");
+
+		// Negating in unsigned arithmetic also handles the minimum value of signed types
+		return value < 0 ? 0 - static_cast<digit_t>(value) : static_cast<digit_t>(value);
+	}
+
+	/**
+	 * @brief Compares with a primitive, looking at the top digit only when this value has a single digit.
+	 */
+	template<primitive_integral T>
+	constexpr std::strong_ordering compare_primitive(T value) const noexcept
+	{
+		const digit_t magnitude = magnitude_of(value);
+		if (is_zero() && magnitude == 0)
+			return std::strong_ordering::equal;
+		if (negative_ != (value < 0))
+			return negative_ ? std::strong_ordering::less : std::strong_ordering::greater;
 
-		while (carry)
+		const std::strong_ordering magnitude_order = digits_.size() > 1 ? std::strong_ordering::greater : digits_[0] <=> magnitude;
+		return negative_ ? 0 <=> magnitude_order : magnitude_order;
+	}
+
+	/**
+	 * @brief Adds a signed single digit value to this value of any length.
+	 *
+	 * @param magnitude The absolute value to add.
+	 * @param negative Flag indicating if the value to add is negative.
+	 */
+	constexpr void add_digit(digit_t magnitude, bool negative)
+	{
+		if (digits_.size() == 1)
 		{
-			int64_t diff = static_cast<int64_t>(rhs.digits_[i]) - carry;
+			add_single_digit(magnitude, negative);
+			return;
+		}
 
-			bool underflow = diff < 0;
-			digits_[i] = static_cast<uint32_t>(diff + suuri::base * underflow);
-			carry = underflow;
+		if (negative_ == negative)
+		{
+			if (limbs::add_1(digits_, digits_, magnitude))
+				digits_.push_back(1);
+		} else
+		{
+			// A value of several digits is larger than any single digit, so the sign stays
+			limbs::sub_1(digits_, digits_, magnitude);
+			remove_leading_zeros();
+		}
+	}
 
-			i++;
+	/**
+	 * @brief Multiplies this value of any length by a signed single digit value.
+	 *
+	 * @param magnitude The absolute value to multiply by.
+	 * @param negative Flag indicating if the value to multiply by is negative.
+	 */
+	constexpr void multiply_digit(digit_t magnitude, bool negative)
+	{
+		if (digits_.size() == 1)
+		{
+			multiply_single_digit(magnitude, negative);
+			return;
+		}
+		if (magnitude == 0)
+		{
+			clear();
+			return;
 		}
 
-		if (digits_[digits_.size() - 1] == 0)
-			digits_.pop_back();
+		const digit_t high = limbs::mul_1(digits_, digits_, magnitude);
+		if (high)
+			digits_.push_back(high);
 
-		return *this;
+		negative_ = negative_ != negative;
 	}
 
 	/// Multiplication methods
 
-	[[nodiscard]] constexpr static BigInt long_multiplication_assume_positive(BigIntView lhs, BigIntView rhs, size_t result_size)
+	/**
+	 * @brief Multiplies with the algorithm limbs::mul picks for the operand sizes, using a single scratch allocation.
+	 *
+	 * Products large enough are spread over the threads configured with parallel::set_thread_count. The scratch is still
+	 * allocated here, on the calling thread, so the allocator does not need to be thread safe.
+	 */
+	[[nodiscard]] constexpr BasicBigInt multiply(const BasicBigInt &rhs) const
 	{
-		assert(result_size >= lhs.digits_.size() + rhs.digits_.size() && "result_size too small to fit result");
-
-		digit_storage_t storage;
-		storage.reserve(result_size);
+		const size_t lhs_size = digits_.size();
+		const size_t rhs_size = rhs.digits_.size();
 
-		BigInt ret{std::move(storage), false};
-		ret.digits_.resize(lhs.digits_.size() + rhs.digits_.size());
-
-		for (size_t i = 0; i < lhs.digits_.size(); i++)
+		BasicBigInt ret{storage_type(lhs_size + rhs_size, get_allocator()), static_cast<bool>(negative_ ^ rhs.negative_)};
+		if (!std::is_constant_evaluated() && parallel::worthwhile(lhs_size, rhs_size))
 		{
-			for (size_t j = 0; j < rhs.digits_.size(); j++)
+			if (&rhs == this)
+			{
+				storage_type scratch(parallel::sqr_scratch_size(lhs_size), get_allocator());
+				parallel::sqr(ret.digits_, digits_, scratch);
+			} else
 			{
-				uint64_t res =
-						static_cast<uint64_t>(ret.digits_[i + j]) +
-						static_cast<uint64_t>(lhs.digits_[i]) * static_cast<uint64_t>(rhs.digits_[j]);
-				ret.digits_[i + j + 1] += res / base;
-				ret.digits_[i + j] = static_cast<uint32_t>(res % base);
+				storage_type scratch(parallel::mul_scratch_size(lhs_size, rhs_size), get_allocator());
+				parallel::mul(ret.digits_, digits_, rhs.digits_, scratch);
 			}
+		} else if (&rhs == this)
+		{
+			storage_type scratch(limbs::sqr_scratch_size(lhs_size), get_allocator());
+			limbs::sqr(ret.digits_, digits_, scratch);
+		} else
+		{
+			storage_type scratch(limbs::mul_scratch_size(lhs_size, rhs_size), get_allocator());
+			limbs::mul(ret.digits_, digits_, rhs.digits_, scratch);
 		}
-
-		if (ret.digits_.back() == 0)
-			ret.digits_.pop_back();
+		ret.remove_leading_zeros();
 
 		return ret;
 	}
 
-	[[nodiscard]] constexpr static BigInt karatsuba_multiplication_assume_positive(BigIntView lhs, BigIntView rhs, size_t result_size)
+	/**
+	 * @brief Multiplies with the Toom variant that evaluates at max_points points, using a single scratch allocation.
+	 */
+	[[nodiscard]] constexpr BasicBigInt toom_multiplication(const BasicBigInt &rhs, size_t max_points) const
 	{
-		if (lhs.digits_.size() < long_multiplication_digit_threshold || rhs.digits_.size() < long_multiplication_digit_threshold)
+		const size_t lhs_size = digits_.size();
+		const size_t rhs_size = rhs.digits_.size();
+		if (!limbs::toom_applicable(lhs_size, rhs_size, max_points))
+			return multiply(rhs);
+
+		BasicBigInt ret{storage_type(lhs_size + rhs_size, get_allocator()), static_cast<bool>(negative_ ^ rhs.negative_)};
+		if (&rhs == this)
 		{
-			return long_multiplication_assume_positive(lhs, rhs, result_size);
+			storage_type scratch(limbs::sqr_toom_scratch_size(lhs_size, max_points), get_allocator());
+			limbs::sqr_toom(ret.digits_, digits_, max_points, scratch);
+		} else
+		{
+			storage_type scratch(limbs::toom_scratch_size(lhs_size, rhs_size, max_points), get_allocator());
+			limbs::mul_toom(ret.digits_, digits_, rhs.digits_, max_points, scratch);
 		}
+		ret.remove_leading_zeros();
 
-		const uint64_t n = lhs.digits_.size() > rhs.digits_.size() ? lhs.digits_.size() : rhs.digits_.size();
-		const uint64_t half = n / 2;
-		BigInt x_1 = get_copy_right_shifted_by(lhs, half);
-		BigInt x_0 = get_copy_of_lower_for_karatsuba(
-				lhs,
-				half,
-				static_cast<int64_t>(lhs.digits_.size()) - static_cast<int64_t>(x_1.digits_.size()));
-		BigInt y_1 = get_copy_right_shifted_by(rhs, half);
-
-		BigInt y_0 = get_copy_of_lower_for_karatsuba(
-				rhs,
-				half,
-				static_cast<int64_t>(rhs.digits_.size()) - static_cast<int64_t>(y_1.digits_.size()));
-
-		BigInt z_0 = karatsuba_multiplication_assume_positive(x_0, y_0,
-															  x_0.digits_.size() + y_0.digits_.size());
-		BigInt z_2 = karatsuba_multiplication_assume_positive(x_1, y_1,
-															  x_1.digits_.size() + y_1.digits_.size() + 2 * half + 1);// half^2
-		// x_0 and x_1 won't be used after this point, so we'll reuse them as the sum of the two
-		x_1 += x_0;
-		// Same with y
-		y_1 += y_0;
+		return ret;
+	}
 
-		BigInt z_1 = karatsuba_multiplication_assume_positive(x_1, y_1,
-															  x_1.digits_.size() + y_1.digits_.size() + half + 1);// (half + 2)^2
-		z_1 -= z_2;
-		z_1 -= z_0;
+	/**
+	 * @brief Multiplies with the Toom variant that splits the operands in lhs_pieces and rhs_pieces pieces, using a single scratch allocation.
+	 */
+	[[nodiscard]] constexpr BasicBigInt toom_pieces_multiplication(const BasicBigInt &rhs, size_t lhs_pieces, size_t rhs_pieces) const
+	{
+		const size_t lhs_size = digits_.size();
+		const size_t rhs_size = rhs.digits_.size();
+		if (!limbs::toom_pieces_applicable(lhs_size, rhs_size, lhs_pieces, rhs_pieces))
+			return multiply(rhs);
 
-		z_2.left_shift(2 * half);// half^2 + 2 half
-		z_1.left_shift(half);    // (half + 2)^2 + half
+		BasicBigInt ret{storage_type(lhs_size + rhs_size, get_allocator()), static_cast<bool>(negative_ ^ rhs.negative_)};
+		storage_type scratch(limbs::toom_pieces_scratch_size(lhs_size, rhs_size, lhs_pieces, rhs_pieces), get_allocator());
 
-		z_1 += z_0;
-		z_1 += z_2;
+		limbs::mul_toom_pieces(ret.digits_, digits_, rhs.digits_, lhs_pieces, rhs_pieces, scratch);
+		ret.remove_leading_zeros();
 
-		// *this = z_1;
-		// return *this;
-		return z_1;
+		return ret;
 	}
 
-	/// Static methods
-
-	static constexpr BigInt get_copy_of_lower_for_karatsuba(BigIntView rhs, size_t half, int64_t n)
+	/**
+	 * @brief Schoolbook multiplication that writes the product over the digits of this value, reusing their capacity.
+	 *
+	 * The digits of this value are consumed from the most significant down. Row i only writes to positions i and above,
+	 * which at that point hold either the digit being consumed or partial products, so no digit is overwritten before it is read.
+	 *
+	 * @pre rhs is not this value.
+	 */
+	constexpr void multiply_in_place(const BasicBigInt &rhs)
 	{
-		if (half >= rhs.digits_.size())
-			return BigInt(rhs);
+		const size_t lhs_size = digits_.size();
+		const size_t rhs_size = rhs.digits_.size();
+		digits_.resize(lhs_size + rhs_size);
 
-		BigInt ret = BigInt(digit_storage_t(n));
-		for (size_t i = 0; i < n; i++)
+		const std::span<digit_t> digits{digits_};
+		for (size_t i = lhs_size; i-- > 0;)
 		{
-			ret.digits_[i] = rhs.digits_[i];
+			const digit_t digit = digits[i];
+			digits[i] = 0;
+			if (digit == 0)
+				continue;
+
+			// The partial product is below B^(lhs_size + rhs_size), so the carry always stops inside the storage
+			const digit_t high = limbs::addmul_1(digits.subspan(i, rhs_size), rhs.digits_, digit);
+			limbs::add_1(digits.subspan(i + rhs_size), digits.subspan(i + rhs_size), high);
 		}
 
-		return ret;
+		negative_ = negative_ != rhs.negative_;
+		remove_leading_zeros();
 	}
 
-	static constexpr BigInt get_copy_right_shifted_by(BigIntView rhs, uint64_t shift_by)
+	/**
+	 * @brief Adds the product lhs * rhs with the given sign to this value.
+	 *
+	 * Below the Karatsuba threshold this goes one row of the schoolbook product at a time. Longer products are computed by
+	 * the multiplication dispatcher into a single scratch allocation, and added or subtracted afterwards.
+	 *
+	 * When the signs differ the product is subtracted modulo B^n. The running value only decreases, so it wraps at most
+	 * once, and if it did the result is the two's complement of the true magnitude.
+	 */
+	constexpr BasicBigInt &multiply_accumulate(const BasicBigInt &lhs, const BasicBigInt &rhs, bool product_negative)
 	{
-		if (shift_by >= rhs.digits_.size())
+		if (lhs.is_zero() || rhs.is_zero())
+			return *this;
+
+		// The rows would overwrite the operand while it is still being read
+		if (&lhs == this || &rhs == this)
 		{
-			return 0;
+			const auto product = lhs * rhs;
+			return product_negative == (lhs.negative_ != rhs.negative_) ? *this += product : *this -= product;
 		}
 
-		digit_storage_t temp;
-		temp.reserve(rhs.digits_.size());
-		BigInt ret{std::move(temp), false};
-		ret.digits_.resize(rhs.digits_.size() - shift_by);
+		if (is_zero())
+			negative_ = product_negative;
+
+		const bool add = negative_ == product_negative;
+		const size_t lhs_size = lhs.digits_.size();
+		const size_t rhs_size = rhs.digits_.size();
+		const size_t size = std::max(digits_.size(), lhs_size + rhs_size) + 1;
+		digits_.resize(size);
 
-		for (size_t i = 0; i < rhs.digits_.size() - shift_by; i++)
+		const std::span<digit_t> digits{digits_};
+		bool wrapped = false;
+		if (std::min(lhs_size, rhs_size) >= limbs::karatsuba_threshold)
 		{
-			ret.digits_[i] = rhs.digits_[i + shift_by];
+			const bool threaded = !std::is_constant_evaluated() && parallel::worthwhile(lhs_size, rhs_size);
+			const size_t scratch_size = threaded ? parallel::mul_scratch_size(lhs_size, rhs_size) : limbs::mul_scratch_size(lhs_size, rhs_size);
+			storage_type product(lhs_size + rhs_size + scratch_size, get_allocator());
+
+			const auto product_digits = std::span<digit_t>(product).first(lhs_size + rhs_size);
+			const auto scratch = std::span<digit_t>(product).subspan(lhs_size + rhs_size);
+			if (threaded)
+				parallel::mul(product_digits, lhs.digits_, rhs.digits_, scratch);
+			else
+				limbs::mul(product_digits, lhs.digits_, rhs.digits_, scratch);
+
+			// The value has a limb to spare above the product, so adding never carries out of it
+			if (add)
+				limbs::add(digits, digits, product_digits);
+			else
+				wrapped = limbs::sub(digits, digits, product_digits) != 0;
+		} else
+		{
+			for (size_t i = 0; i < lhs_size; i++)
+			{
+				const digit_t digit = lhs.digits_[i];
+				if (digit == 0)
+					continue;
+
+				auto row = digits.subspan(i, rhs_size);
+				auto above = digits.subspan(i + rhs_size);
+				if (add)
+					limbs::add_1(above, above, limbs::addmul_1(row, rhs.digits_, digit));
+				else
+					wrapped |= limbs::sub_1(above, above, limbs::submul_1(row, rhs.digits_, digit)) != 0;
+			}
 		}
 
-		return ret;
+		if (wrapped)
+		{
+			limbs::neg(digits, digits);
+			negative_ = !negative_;
+		}
+
+		remove_leading_zeros();
+		return *this;
+	}
+
+	/// Division methods
+
+	[[nodiscard]] constexpr std::pair<BasicBigInt, BasicBigInt> divide_by_digit(digit_t divisor, bool divisor_negative) const
+	{
+		storage_type digits(digits_.size(), get_allocator());
+		const digit_t remainder = limbs::divrem_1(digits, digits_, divisor);
+
+		auto quotient = BasicBigInt{std::move(digits), negative_ != divisor_negative};
+		quotient.remove_leading_zeros();
+		quotient.negative_ = quotient.negative_ && !quotient.is_zero();
+		auto ret_remainder = BasicBigInt{remainder, get_allocator()};
+		ret_remainder.negative_ = negative_ && remainder != 0;
+
+		return {std::move(quotient), std::move(ret_remainder)};
+	}
+
+	/// Addition methods
+
+	constexpr BasicBigInt &add_digits(const BasicBigInt &rhs)
+	{
+		// We're going to need at least as much storage for the digits as rhs. rhs might be lhs, so only look at its digits after resizing.
+		if (rhs.digits_.size() > digits_.size())
+			digits_.resize(rhs.digits_.size());
+
+		const digit_t carry = limbs::add(digits_, digits_, rhs.digits_);
+		if (carry)
+			digits_.push_back(carry);
+
+		return *this;
+	}
+
+	constexpr BasicBigInt &subtract_digits(const BasicBigInt &rhs)
+	{
+		// lhs is greater than rhs, so there is no borrow out of lhs
+		limbs::sub(digits_, digits_, rhs.digits_);
+
+		return *this;
+	}
+
+	constexpr BasicBigInt &subtract_lhs_from_rhs_digits(const BasicBigInt &rhs)
+	{
+		// lhs is not greater than rhs, so it has at most as many digits, and the final borrow is always 0
+		digits_.resize(rhs.digits_.size());
+		limbs::sub(digits_, rhs.digits_, digits_);
+
+		return *this;
 	}
 
 	// Provide a friend overload for the testing framework.
-	friend inline void PrintTo(const BigInt &bigint, std::ostream *os)
+	friend inline void PrintTo(const BasicBigInt &bigint, std::ostream *os)
 	{
 		*os << (bigint.negative_ ? "-[" : "[");
 
@@ -889,10 +1978,19 @@ private:
 	}
 };
 
+typedef BasicBigInt<> BigInt;
 typedef BigInt big_int_t;
 
-template<>
-struct is_big_int<BigInt> : std::true_type {
+namespace pmr
+{
+/**
+ * Big integer drawing its memory from a std::pmr::memory_resource.
+ */
+typedef BasicBigInt<std::pmr::polymorphic_allocator<digit_t>> big_int_t;
+}// namespace pmr
+
+template<typename Allocator>
+struct is_big_int<BasicBigInt<Allocator>> : std::true_type {
 };
 
 }// namespace suuri
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <concepts>
+#include <cstdint>
+#include <ranges>
+#include <string_view>
 #include <type_traits>
 
 namespace suuri
@@ -11,4 +15,31 @@ struct is_big_int : std::false_type {
 template<typename T>
 constexpr typename is_big_int<T>::value_type is_big_int_v = is_big_int<T>::value;
 
+/**
+ * Marks the lazy expression types of suuri_expression.hpp, which a big integer can be assigned from.
+ */
+template<typename T>
+struct is_big_int_expression : std::false_type {
+};
+
+template<typename T>
+constexpr bool is_big_int_expression_v = is_big_int_expression<T>::value;
+
+/**
+ * A range of integral values that can be used as the digits of a big integer.
+ * Strings are excluded, since they are parsed rather than taken as digits.
+ */
+template<typename T>
+concept range_of_integral =
+		std::ranges::range<T> &&
+		std::integral<std::ranges::range_value_t<T>> &&
+		std::convertible_to<std::ranges::range_value_t<T>, uint64_t> &&
+		(!std::convertible_to<T, std::string_view>);
+
+/**
+ * A builtin integral type, which big integers take directly in arithmetic and comparisons.
+ */
+template<typename T>
+concept primitive_integral = std::is_fundamental_v<T> && std::integral<T>;
+
 }// namespace suuri
\ No newline at end of file
@@ -1,17 +1,31 @@
 #pragma once
 
+#include "suuri_small_vector.hpp"
+
 #include <compare>
+#include <memory>
 #include <cstdint>
 #include <stdexcept>
-#include <vector>
 
 namespace suuri
 {
 
-typedef uint32_t digit_t;
-typedef std::vector<digit_t> digit_storage_t;
+typedef uint64_t digit_t;
+/**
+ * Digits are kept inline for values of up to two digits, so small integers never touch the heap.
+ */
+template<typename Allocator = std::allocator<digit_t>>
+using basic_digit_storage_t = SmallVector<digit_t, 2, Allocator>;
+typedef basic_digit_storage_t<> digit_storage_t;
+
+/**
+ * Number of bits in a digit. Digits use their full width, so the base of the digits is 2^digit_bits.
+ */
+inline constexpr size_t digit_bits = 64;
 
-inline constexpr digit_t base = 2147483648;
+#ifdef __SIZEOF_INT128__
+__extension__ typedef unsigned __int128 double_digit_t;
+#endif
 
 static constexpr uint32_t convert_char_to_int(char c, uint32_t b = 10)
 {
@@ -32,18 +46,139 @@ static constexpr uint32_t convert_char_to_int(char c, uint32_t b = 10)
 	return retval;
 }
 
-inline constexpr std::strong_ordering digits_compare(const digit_storage_t& lhs, const digit_storage_t& rhs) noexcept
+//// Digit arithmetic
+
+/**
+ * @brief Adds two digits and an incoming carry.
+ *
+ * @param carry The incoming carry (0 or 1). Holds the outgoing carry on return.
+ * @return The low digit of the sum.
+ */
+constexpr digit_t add_with_carry(digit_t lhs, digit_t rhs, digit_t &carry) noexcept
 {
-	if (lhs.size() != rhs.size())
-		return lhs.size() < rhs.size() ? std::strong_ordering::less : std::strong_ordering::greater;
-	
-	// Start from the most significant digit. If any digit is not equal, return the ordering
-	for (size_t i = 0; i < lhs.size(); i++)
-		if (lhs[lhs.size() - 1 - i] != rhs[rhs.size() - 1 - i])
-			return lhs[lhs.size() - 1 - i] < rhs[rhs.size() - 1 - i] ? std::strong_ordering::less : std::strong_ordering::greater;
+	digit_t sum = lhs + rhs;
+	digit_t carry_out = sum < lhs;
+	sum += carry;
+	carry = carry_out | (sum < carry);
+
+	return sum;
+}
+
+/**
+ * @brief Subtracts a digit and an incoming borrow from another digit.
+ *
+ * @param borrow The incoming borrow (0 or 1). Holds the outgoing borrow on return.
+ * @return The low digit of the difference.
+ */
+constexpr digit_t subtract_with_borrow(digit_t lhs, digit_t rhs, digit_t &borrow) noexcept
+{
+	digit_t diff = lhs - rhs;
+	digit_t borrow_out = lhs < rhs;
+	borrow_out |= diff < borrow;
+	diff -= borrow;
+	borrow = borrow_out;
+
+	return diff;
+}
+
+/**
+ * @brief Computes lhs * rhs + addend + carry, which always fits in two digits.
+ *
+ * @param carry The incoming carry digit. Holds the high digit of the result on return.
+ * @return The low digit of the result.
+ */
+constexpr digit_t multiply_add_digits(digit_t lhs, digit_t rhs, digit_t addend, digit_t &carry) noexcept
+{
+#ifdef __SIZEOF_INT128__
+	double_digit_t res = static_cast<double_digit_t>(lhs) * rhs + addend + carry;
+	carry = static_cast<digit_t>(res >> digit_bits);
+
+	return static_cast<digit_t>(res);
+#else
+	// Portable fallback using half digits
+	constexpr digit_t half_mask = 0xFFFFFFFF;
+	digit_t ll = (lhs & half_mask) * (rhs & half_mask);
+	digit_t lh = (lhs & half_mask) * (rhs >> 32);
+	digit_t hl = (lhs >> 32) * (rhs & half_mask);
+	digit_t hh = (lhs >> 32) * (rhs >> 32);
 
-	// If we get here, they must be equal
-	return std::strong_ordering::equal;
+	digit_t middle = (ll >> 32) + (lh & half_mask) + (hl & half_mask);
+	digit_t low = (ll & half_mask) | (middle << 32);
+	digit_t high = hh + (lh >> 32) + (hl >> 32) + (middle >> 32);
+
+	digit_t add_carry = 0;
+	low = add_with_carry(low, addend, add_carry);
+	high += add_carry;
+	add_carry = 0;
+	low = add_with_carry(low, carry, add_carry);
+	carry = high + add_carry;
+
+	return low;
+#endif
 }
 
-}
\ No newline at end of file
+/**
+ * @brief Computes the full product of two digits.
+ *
+ * @param high Holds the high digit of the product on return.
+ * @return The low digit of the product.
+ */
+constexpr digit_t multiply_digits(digit_t lhs, digit_t rhs, digit_t &high) noexcept
+{
+	high = 0;
+	return multiply_add_digits(lhs, rhs, 0, high);
+}
+
+/**
+ * @brief Divides the two digit number (high, low) by a single digit.
+ *
+ * @pre high < divisor, such that the quotient fits in a single digit.
+ * @param remainder Holds the remainder of the division on return.
+ * @return The quotient.
+ */
+constexpr digit_t divide_digits(digit_t high, digit_t low, digit_t divisor, digit_t &remainder) noexcept
+{
+#ifdef __SIZEOF_INT128__
+	double_digit_t dividend = (static_cast<double_digit_t>(high) << digit_bits) | low;
+	remainder = static_cast<digit_t>(dividend % divisor);
+
+	return static_cast<digit_t>(dividend / divisor);
+#else
+	// Portable fallback doing restoring binary long division
+	digit_t quotient = 0;
+	for (size_t i = 0; i < digit_bits; i++)
+	{
+		bool overflow = high >> (digit_bits - 1);
+		high = (high << 1) | (low >> (digit_bits - 1));
+		low <<= 1;
+		quotient <<= 1;
+		if (overflow || high >= divisor)
+		{
+			high -= divisor;
+			quotient |= 1;
+		}
+	}
+	remainder = high;
+
+	return quotient;
+#endif
+}
+
+//// Task runners
+
+/**
+ * @brief Runs task(i) for every i below count, one after the other.
+ *
+ * Kernels whose work splits into independent tasks take a runner, which defaults to this one. parallel::Runner runs the
+ * tasks on several threads instead.
+ */
+struct SerialRunner {
+	template<typename Task>
+	constexpr void operator()(size_t count, Task &&task) const
+	{
+		for (size_t i = 0; i < count; i++)
+			task(i);
+	}
+};
+
+}
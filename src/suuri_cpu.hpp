@@ -0,0 +1,68 @@
+#pragma once
+
+/**
+ * Runtime detection of the instruction set extensions that kernels have hand vectorised versions for.
+ *
+ * The vectorised kernels are compiled with target attributes instead of compiler flags, so a single build runs on
+ * any x86-64 CPU and takes the fast path where the CPU has it. Other compilers and architectures get the portable code.
+ */
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SUURI_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+namespace suuri::cpu
+{
+
+/**
+ * @brief Checks if the CPU supports AVX2 together with FMA.
+ */
+inline bool has_avx2() noexcept
+{
+#ifdef SUURI_X86_DISPATCH
+	static const bool supported = [] {
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+	}();
+
+	return supported;
+#else
+	return false;
+#endif
+}
+
+/**
+ * @brief Checks if the CPU supports the AVX-512 foundation instructions.
+ */
+inline bool has_avx512() noexcept
+{
+#ifdef SUURI_X86_DISPATCH
+	static const bool supported = [] {
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx512f");
+	}();
+
+	return supported;
+#else
+	return false;
+#endif
+}
+
+/**
+ * @brief Checks if the CPU supports the AVX-512 integer fused multiply-add instructions, on 52 bit operands.
+ */
+inline bool has_avx512ifma() noexcept
+{
+#ifdef SUURI_X86_DISPATCH
+	static const bool supported = [] {
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512ifma");
+	}();
+
+	return supported;
+#else
+	return false;
+#endif
+}
+
+}// namespace suuri::cpu
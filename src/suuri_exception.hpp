@@ -1,5 +1,7 @@
 #pragma once
 
+#include <exception>
+
 namespace suuri
 {
 
@@ -15,4 +17,13 @@ public:
 	}
 };
 
+class buffer_too_small : public logic_error
+{
+public:
+	[[nodiscard]] constexpr const char* what() const noexcept override
+	{
+		return "The buffer is too small to hold the exported value";
+	}
+};
+
 }
@@ -0,0 +1,308 @@
+#pragma once
+
+#include "big_int.hpp"
+#include "suuri_concept.hpp"
+
+#include <algorithm>
+#include <concepts>
+#include <type_traits>
+#include <utility>
+
+namespace suuri
+{
+
+/**
+ * Opt-in expression templates over BasicBigInt.
+ *
+ * Wrapping an operand in suuri::lazy makes +, - and * build an expression tree instead of a value. The tree is evaluated
+ * when it is assigned to a big integer (or added to / subtracted from one), which sizes the destination once and
+ * turns products into fused addmul / submul calls, so a * b + c - d * e creates no temporaries at all.
+ * Only the operands of a product that are themselves expressions, like (a + b) * c, are evaluated into a temporary.
+ *
+ * The tree holds references to its operands, so it must be used within the full expression that created it.
+ */
+namespace expression
+{
+
+template<typename BigInt>
+class Ref;
+template<typename Lhs, typename Rhs>
+class Add;
+template<typename Lhs, typename Rhs>
+class Sub;
+template<typename Lhs, typename Rhs>
+class Mul;
+
+//// Traits
+
+template<typename T>
+struct is_basic_big_int : std::false_type {
+};
+template<typename Allocator>
+struct is_basic_big_int<BasicBigInt<Allocator>> : std::true_type {
+};
+
+template<typename T>
+struct is_node : std::false_type {
+};
+template<typename BigInt>
+struct is_node<Ref<BigInt>> : std::true_type {
+};
+template<typename Lhs, typename Rhs>
+struct is_node<Add<Lhs, Rhs>> : std::true_type {
+};
+template<typename Lhs, typename Rhs>
+struct is_node<Sub<Lhs, Rhs>> : std::true_type {
+};
+template<typename Lhs, typename Rhs>
+struct is_node<Mul<Lhs, Rhs>> : std::true_type {
+};
+
+template<typename T>
+concept node = is_node<std::remove_cvref_t<T>>::value;
+
+template<typename T>
+concept operand = node<T> || is_basic_big_int<std::remove_cvref_t<T>>::value;
+
+//// Nodes
+
+/**
+ * Common part of all nodes.
+ * @tparam Derived The node type. Has to provide accumulate, aliases, size_bound and get_allocator.
+ * @tparam BigInt The big integer type the expression evaluates to.
+ */
+template<typename Derived, typename BigInt>
+class Node
+{
+public:
+	typedef BigInt value_type;
+
+	/**
+	 * @brief Evaluates the expression into dest, replacing its value.
+	 */
+	constexpr void assign_to(BigInt &dest) const
+	{
+		// Evaluating in place would read dest after it has been cleared
+		if (derived().aliases(dest))
+		{
+			dest = evaluate(dest.get_allocator());
+			return;
+		}
+
+		dest.clear();
+		dest.reserve(derived().size_bound());
+		derived().accumulate(dest, false);
+	}
+
+	/**
+	 * @brief Adds the value of the expression to dest, or subtracts it if negate is set.
+	 */
+	constexpr void add_to(BigInt &dest, bool negate) const
+	{
+		if (derived().aliases(dest))
+		{
+			const BigInt value = evaluate(dest.get_allocator());
+			negate ? dest -= value : dest += value;
+			return;
+		}
+
+		dest.reserve(std::max(dest.digits().size(), derived().size_bound()) + 1);
+		derived().accumulate(dest, negate);
+	}
+
+	[[nodiscard]] constexpr BigInt evaluate(const typename BigInt::allocator_type &alloc) const
+	{
+		BigInt result{alloc};
+		assign_to(result);
+		return result;
+	}
+
+	constexpr operator BigInt() const
+	{
+		return evaluate(derived().get_allocator());
+	}
+
+private:
+	[[nodiscard]] constexpr const Derived &derived() const noexcept { return static_cast<const Derived &>(*this); }
+};
+
+template<typename BigInt>
+class Ref : public Node<Ref<BigInt>, BigInt>
+{
+public:
+	constexpr explicit Ref(const BigInt &value) noexcept
+		: value_(&value)
+	{}
+
+	constexpr void accumulate(BigInt &dest, bool negate) const
+	{
+		negate ? dest -= *value_ : dest += *value_;
+	}
+
+	/**
+	 * @brief Operands of a product use the referenced value directly.
+	 */
+	[[nodiscard]] constexpr const BigInt &evaluate(const typename BigInt::allocator_type &) const noexcept { return *value_; }
+
+	[[nodiscard]] constexpr bool aliases(const BigInt &dest) const noexcept { return value_ == &dest; }
+	[[nodiscard]] constexpr size_t size_bound() const noexcept { return value_->digits().size(); }
+	[[nodiscard]] constexpr auto get_allocator() const noexcept { return value_->get_allocator(); }
+
+private:
+	const BigInt *value_;
+};
+
+/**
+ * Common part of the nodes with two operands.
+ */
+template<typename Derived, typename Lhs, typename Rhs>
+class Binary : public Node<Derived, typename Lhs::value_type>
+{
+	static_assert(std::same_as<typename Lhs::value_type, typename Rhs::value_type>, "Both operands must be the same big integer type");
+
+public:
+	constexpr Binary(Lhs lhs, Rhs rhs) noexcept
+		: lhs_(std::move(lhs)), rhs_(std::move(rhs))
+	{}
+
+	[[nodiscard]] constexpr bool aliases(const typename Lhs::value_type &dest) const noexcept
+	{
+		return lhs_.aliases(dest) || rhs_.aliases(dest);
+	}
+	[[nodiscard]] constexpr auto get_allocator() const noexcept { return lhs_.get_allocator(); }
+
+protected:
+	Lhs lhs_;
+	Rhs rhs_;
+};
+
+template<typename Lhs, typename Rhs>
+class Add : public Binary<Add<Lhs, Rhs>, Lhs, Rhs>
+{
+public:
+	using Binary<Add, Lhs, Rhs>::Binary;
+
+	constexpr void accumulate(typename Lhs::value_type &dest, bool negate) const
+	{
+		this->lhs_.accumulate(dest, negate);
+		this->rhs_.accumulate(dest, negate);
+	}
+
+	[[nodiscard]] constexpr size_t size_bound() const noexcept
+	{
+		return std::max(this->lhs_.size_bound(), this->rhs_.size_bound()) + 1;
+	}
+};
+
+template<typename Lhs, typename Rhs>
+class Sub : public Binary<Sub<Lhs, Rhs>, Lhs, Rhs>
+{
+public:
+	using Binary<Sub, Lhs, Rhs>::Binary;
+
+	constexpr void accumulate(typename Lhs::value_type &dest, bool negate) const
+	{
+		this->lhs_.accumulate(dest, negate);
+		this->rhs_.accumulate(dest, !negate);
+	}
+
+	[[nodiscard]] constexpr size_t size_bound() const noexcept
+	{
+		return std::max(this->lhs_.size_bound(), this->rhs_.size_bound()) + 1;
+	}
+};
+
+template<typename Lhs, typename Rhs>
+class Mul : public Binary<Mul<Lhs, Rhs>, Lhs, Rhs>
+{
+public:
+	using Binary<Mul, Lhs, Rhs>::Binary;
+
+	constexpr void accumulate(typename Lhs::value_type &dest, bool negate) const
+	{
+		const auto &lhs = this->lhs_.evaluate(dest.get_allocator());
+		const auto &rhs = this->rhs_.evaluate(dest.get_allocator());
+
+		negate ? dest.submul(lhs, rhs) : dest.addmul(lhs, rhs);
+	}
+
+	[[nodiscard]] constexpr size_t size_bound() const noexcept
+	{
+		return this->lhs_.size_bound() + this->rhs_.size_bound();
+	}
+};
+
+//// Operators
+
+template<operand T>
+constexpr auto wrap(const T &value) noexcept
+{
+	if constexpr (node<T>)
+		return value;
+	else
+		return Ref<T>{value};
+}
+
+template<typename T>
+using wrapped_t = decltype(wrap(std::declval<const std::remove_cvref_t<T> &>()));
+
+// The operators take forwarding references so they are preferred over the rvalue overloads of BasicBigInt.
+// A temporary operand lives until the end of the full expression, which is when the tree is evaluated.
+
+template<operand Lhs, operand Rhs>
+	requires(node<Lhs> || node<Rhs>)
+constexpr auto operator+(Lhs &&lhs, Rhs &&rhs)
+{
+	return Add<wrapped_t<Lhs>, wrapped_t<Rhs>>{wrap(lhs), wrap(rhs)};
+}
+template<operand Lhs, operand Rhs>
+	requires(node<Lhs> || node<Rhs>)
+constexpr auto operator-(Lhs &&lhs, Rhs &&rhs)
+{
+	return Sub<wrapped_t<Lhs>, wrapped_t<Rhs>>{wrap(lhs), wrap(rhs)};
+}
+template<operand Lhs, operand Rhs>
+	requires(node<Lhs> || node<Rhs>)
+constexpr auto operator*(Lhs &&lhs, Rhs &&rhs)
+{
+	return Mul<wrapped_t<Lhs>, wrapped_t<Rhs>>{wrap(lhs), wrap(rhs)};
+}
+
+template<node Expression>
+constexpr typename Expression::value_type &operator+=(typename Expression::value_type &dest, const Expression &expression)
+{
+	expression.add_to(dest, false);
+	return dest;
+}
+template<node Expression>
+constexpr typename Expression::value_type &operator-=(typename Expression::value_type &dest, const Expression &expression)
+{
+	expression.add_to(dest, true);
+	return dest;
+}
+
+}// namespace expression
+
+template<typename BigInt>
+struct is_big_int_expression<expression::Ref<BigInt>> : std::true_type {
+};
+template<typename Lhs, typename Rhs>
+struct is_big_int_expression<expression::Add<Lhs, Rhs>> : std::true_type {
+};
+template<typename Lhs, typename Rhs>
+struct is_big_int_expression<expression::Sub<Lhs, Rhs>> : std::true_type {
+};
+template<typename Lhs, typename Rhs>
+struct is_big_int_expression<expression::Mul<Lhs, Rhs>> : std::true_type {
+};
+
+/**
+ * @brief Starts a lazy expression. For example r = lazy(a) * b + c evaluates the whole right hand side straight into r.
+ */
+template<typename Allocator>
+constexpr expression::Ref<BasicBigInt<Allocator>> lazy(const BasicBigInt<Allocator> &value) noexcept
+{
+	return expression::Ref<BasicBigInt<Allocator>>{value};
+}
+
+}// namespace suuri
@@ -0,0 +1,699 @@
+#pragma once
+
+#include "suuri_core.hpp"
+#include "suuri_cpu.hpp"
+
+#include <algorithm>
+#include <assert.h>
+#include <bit>
+#include <cmath>
+#include <new>
+#include <numbers>
+#include <span>
+
+/**
+ * Multiplication by a floating point FFT over the double precision complex numbers.
+ *
+ * The operands are cut into points of a few bits, lhs goes into the real parts and rhs into the imaginary parts of one
+ * complex transform, and the product of their transforms is untangled from it pointwise. A single forward and a single
+ * inverse transform make up the whole product.
+ *
+ * The number of bits per point comes from a proven bound on the rounding error (Percival, "Rapid multiplication modulo
+ * the sum and difference of highly composite numbers", 2003): the split is only used when the error in every
+ * coefficient is below one half, so rounding recovers the exact product. When no split meets the bound, applicable
+ * returns false and the caller has to use an exact method instead.
+ *
+ * The butterflies use AVX2 and FMA when the CPU has them. The transforms are not constexpr, and like the limb kernels
+ * nothing here allocates.
+ */
+namespace suuri::fft
+{
+
+typedef std::span<digit_t> span_t;
+typedef std::span<const digit_t> const_span_t;
+typedef std::span<double> real_span_t;
+typedef std::span<const double> const_real_span_t;
+
+//// Error bound
+
+/**
+ * Unit roundoff of doubles.
+ */
+inline constexpr double epsilon = 0x1p-53;
+/**
+ * Bound on the error of the roots of unity, which are computed with std::sin and std::cos. Assumes those are accurate to
+ * an ulp, as in glibc, and counts the rounding of the angle on top.
+ */
+inline constexpr double root_error = 0x1p-51;
+/**
+ * The most and fewest bits per point that are tried. Fewer bits than this lose to the number theoretic transforms.
+ */
+inline constexpr size_t max_bits = 24;
+inline constexpr size_t min_bits = 8;
+
+/**
+ * @return A bound on the error of the product coefficients, relative to the squared Euclidean norm of the packed points.
+ *
+ * Percival bounds the error of a convolution done with three transforms of 2^log_size points by
+ * |x| |y| ((1 + e)^(3n) (1 + e sqrt(5))^(3n + 1) (1 + b)^(3n) - 1). Our two transforms do less work than his three, and
+ * the extra rounding of untangling the packed transforms is counted as two more levels. The powers are bounded with
+ * (1 + x)^k - 1 <= e^(kx) - 1 <= kx / (1 - kx).
+ */
+constexpr double error_factor(size_t log_size) noexcept
+{
+	const double levels = 3.0 * static_cast<double>(log_size);
+	const double sqrt_5 = 2.2360679775;// Rounded up
+	const double sum = (levels + 2) * epsilon + (levels + 3) * sqrt_5 * epsilon + levels * root_error;
+
+	return sum / (1 - sum);
+}
+
+struct Plan {
+	/// Bits per point, or 0 when no split meets the error bound
+	size_t bits;
+	/// log2 of the number of points of the transform
+	size_t log_size;
+	size_t lhs_points;
+	size_t rhs_points;
+
+	[[nodiscard]] constexpr size_t size() const noexcept { return size_t{1} << log_size; }
+};
+
+/**
+ * @brief Chooses the most bits per point for which the error bound holds for every pair of operands of these sizes.
+ */
+constexpr Plan plan(size_t lhs_size, size_t rhs_size) noexcept
+{
+	for (size_t bits = max_bits; bits >= min_bits; bits--)
+	{
+		const size_t lhs_points = (lhs_size * digit_bits + bits - 1) / bits;
+		const size_t rhs_points = (rhs_size * digit_bits + bits - 1) / bits;
+		const size_t log_size = static_cast<size_t>(std::countr_zero(std::bit_ceil(lhs_points + rhs_points - 1)));
+
+		// The packed points are lhs + i rhs, each part below 2^bits
+		const double largest = static_cast<double>((size_t{1} << bits) - 1);
+		const double norm = static_cast<double>(lhs_points + rhs_points) * largest * largest;
+		if (norm * error_factor(log_size) < 0.5)
+			return {bits, log_size, lhs_points, rhs_points};
+	}
+
+	return {0, 0, 0, 0};
+}
+
+/**
+ * @brief Checks if the error bound can be met for operands of these sizes.
+ */
+constexpr bool applicable(size_t lhs_size, size_t rhs_size) noexcept
+{
+	return plan(lhs_size, rhs_size).bits != 0;
+}
+
+/**
+ * @brief Number of doubles of scratch space needed by mul and sqr.
+ */
+constexpr size_t scratch_size(size_t lhs_size, size_t rhs_size) noexcept
+{
+	// The real and imaginary parts of the points and of the roots
+	return 4 * plan(lhs_size, rhs_size).size();
+}
+
+/**
+ * @brief Reuses limb scratch space for doubles, for callers that only have limb scratch.
+ */
+inline real_span_t as_real(span_t scratch) noexcept
+{
+	static_assert(sizeof(double) == sizeof(digit_t) && alignof(double) <= alignof(digit_t));
+
+	// Start the lifetime of the doubles, which compiles to nothing
+	for (size_t i = 0; i < scratch.size(); i++)
+		::new (static_cast<void *>(scratch.data() + i)) double;
+
+	return {std::launder(reinterpret_cast<double *>(scratch.data())), scratch.size()};
+}
+
+//// Transforms
+// The points are kept as separate arrays of real and imaginary parts, so the butterflies work on whole vectors.
+// The roots of unity of the butterflies of half size h are at positions h to 2h - 1 of the root tables.
+
+/**
+ * @brief Fills the root tables with roots[h + j] = e^(-i pi j / h) for every power of two h below size.
+ */
+inline void fill_roots(real_span_t root_re, real_span_t root_im) noexcept
+{
+	const size_t size = root_re.size();
+	const size_t half = size / 2;
+	const size_t quarter = size / 4;
+	const size_t eighth = size / 8;
+
+	// The largest butterflies use all angles 2 pi j / size below pi. Only the first eighth is computed, the rest
+	// follows from symmetry without adding any error.
+	for (size_t j = 0; j < half; j++)
+	{
+		double cos_value, sin_value;
+		if (j <= eighth)
+		{
+			const double angle = 2 * std::numbers::pi * static_cast<double>(j) / static_cast<double>(size);
+			cos_value = std::cos(angle);
+			sin_value = std::sin(angle);
+		} else if (j <= quarter)
+		{
+			cos_value = -root_im[half + quarter - j];
+			sin_value = root_re[half + quarter - j];
+		} else
+		{
+			cos_value = -root_re[half + 2 * quarter - j];
+			sin_value = -root_im[half + 2 * quarter - j];
+		}
+
+		root_re[half + j] = cos_value;
+		root_im[half + j] = -sin_value;
+	}
+
+	// Smaller butterflies use every other root of the next larger ones
+	for (size_t h = half / 2; h > 0; h /= 2)
+	{
+		for (size_t j = 0; j < h; j++)
+		{
+			root_re[h + j] = root_re[2 * h + 2 * j];
+			root_im[h + j] = root_im[2 * h + 2 * j];
+		}
+	}
+}
+
+/**
+ * @brief One level of decimation in frequency butterflies of half size h, on the points from begin to end.
+ *
+ * Only the first width butterflies of each group are done, so that a level can be cut in pieces across its groups too.
+ */
+inline void forward_level(double *re, double *im, const double *root_re, const double *root_im, size_t begin, size_t end, size_t h,
+                          size_t width) noexcept
+{
+	for (size_t start = begin; start < end; start += 2 * h)
+	{
+		for (size_t j = 0; j < width; j++)
+		{
+			const size_t u = start + j;
+			const size_t v = u + h;
+			const double diff_re = re[u] - re[v];
+			const double diff_im = im[u] - im[v];
+			re[u] += re[v];
+			im[u] += im[v];
+			re[v] = diff_re * root_re[h + j] - diff_im * root_im[h + j];
+			im[v] = diff_re * root_im[h + j] + diff_im * root_re[h + j];
+		}
+	}
+}
+
+/**
+ * @brief One level of decimation in time butterflies of half size h with the conjugate roots, on the points from begin to end.
+ */
+inline void inverse_level(double *re, double *im, const double *root_re, const double *root_im, size_t begin, size_t end, size_t h,
+                          size_t width) noexcept
+{
+	for (size_t start = begin; start < end; start += 2 * h)
+	{
+		for (size_t j = 0; j < width; j++)
+		{
+			const size_t u = start + j;
+			const size_t v = u + h;
+			const double v_re = re[v] * root_re[h + j] + im[v] * root_im[h + j];
+			const double v_im = im[v] * root_re[h + j] - re[v] * root_im[h + j];
+			re[v] = re[u] - v_re;
+			im[v] = im[u] - v_im;
+			re[u] += v_re;
+			im[u] += v_im;
+		}
+	}
+}
+
+#ifdef SUURI_X86_DISPATCH
+/**
+ * @brief forward_level with AVX2 and FMA, four butterflies at a time.
+ * @pre width is a multiple of 4.
+ */
+__attribute__((target("avx2,fma"))) inline void forward_level_avx2(double *re, double *im, const double *root_re, const double *root_im,
+																	 size_t begin, size_t end, size_t h, size_t width) noexcept
+{
+	for (size_t start = begin; start < end; start += 2 * h)
+	{
+		for (size_t j = 0; j < width; j += 4)
+		{
+			const size_t u = start + j;
+			const size_t v = u + h;
+			const __m256d u_re = _mm256_loadu_pd(re + u);
+			const __m256d u_im = _mm256_loadu_pd(im + u);
+			const __m256d v_re = _mm256_loadu_pd(re + v);
+			const __m256d v_im = _mm256_loadu_pd(im + v);
+			const __m256d w_re = _mm256_loadu_pd(root_re + h + j);
+			const __m256d w_im = _mm256_loadu_pd(root_im + h + j);
+
+			const __m256d diff_re = _mm256_sub_pd(u_re, v_re);
+			const __m256d diff_im = _mm256_sub_pd(u_im, v_im);
+			_mm256_storeu_pd(re + u, _mm256_add_pd(u_re, v_re));
+			_mm256_storeu_pd(im + u, _mm256_add_pd(u_im, v_im));
+			_mm256_storeu_pd(re + v, _mm256_fmsub_pd(diff_re, w_re, _mm256_mul_pd(diff_im, w_im)));
+			_mm256_storeu_pd(im + v, _mm256_fmadd_pd(diff_re, w_im, _mm256_mul_pd(diff_im, w_re)));
+		}
+	}
+}
+
+/**
+ * @brief inverse_level with AVX2 and FMA, four butterflies at a time.
+ * @pre width is a multiple of 4.
+ */
+__attribute__((target("avx2,fma"))) inline void inverse_level_avx2(double *re, double *im, const double *root_re, const double *root_im,
+																	 size_t begin, size_t end, size_t h, size_t width) noexcept
+{
+	for (size_t start = begin; start < end; start += 2 * h)
+	{
+		for (size_t j = 0; j < width; j += 4)
+		{
+			const size_t u = start + j;
+			const size_t v = u + h;
+			const __m256d u_re = _mm256_loadu_pd(re + u);
+			const __m256d u_im = _mm256_loadu_pd(im + u);
+			const __m256d v_re = _mm256_loadu_pd(re + v);
+			const __m256d v_im = _mm256_loadu_pd(im + v);
+			const __m256d w_re = _mm256_loadu_pd(root_re + h + j);
+			const __m256d w_im = _mm256_loadu_pd(root_im + h + j);
+
+			const __m256d t_re = _mm256_fmadd_pd(v_re, w_re, _mm256_mul_pd(v_im, w_im));
+			const __m256d t_im = _mm256_fmsub_pd(v_im, w_re, _mm256_mul_pd(v_re, w_im));
+			_mm256_storeu_pd(re + u, _mm256_add_pd(u_re, t_re));
+			_mm256_storeu_pd(im + u, _mm256_add_pd(u_im, t_im));
+			_mm256_storeu_pd(re + v, _mm256_sub_pd(u_re, t_re));
+			_mm256_storeu_pd(im + v, _mm256_sub_pd(u_im, t_im));
+		}
+	}
+}
+#endif
+
+/**
+ * Transforms of more points than this do the levels of smaller butterflies block by block, so they stay in the cache.
+ */
+inline constexpr size_t block_size = 1 << 12;
+
+/**
+ * @brief Runs a level of butterflies with the fastest code the CPU supports. @see forward_level
+ */
+template<bool Forward>
+inline void level(double *re, double *im, const double *root_re, const double *root_im, size_t begin, size_t end, size_t h,
+				  size_t width) noexcept
+{
+#ifdef SUURI_X86_DISPATCH
+	if (width % 4 == 0 && cpu::has_avx2())
+	{
+		Forward ? forward_level_avx2(re, im, root_re, root_im, begin, end, h, width) : inverse_level_avx2(re, im, root_re, root_im, begin, end, h, width);
+		return;
+	}
+#endif
+
+	Forward ? forward_level(re, im, root_re, root_im, begin, end, h, width) : inverse_level(re, im, root_re, root_im, begin, end, h, width);
+}
+
+/**
+ * @brief Runs a level of butterflies larger than a block, as one task per half a block of butterflies.
+ *
+ * @pre 2 * h > block, which makes each group a whole number of tasks.
+ */
+template<bool Forward, typename Runner>
+inline void large_level(real_span_t re, real_span_t im, const_real_span_t root_re, const_real_span_t root_im, size_t h, size_t block,
+						const Runner &runner) noexcept
+{
+	const size_t tasks_per_group = 2 * h / block;
+	const size_t width = block / 2;
+
+	runner(re.size() / block, [&](size_t task) {
+		// Starting the butterflies at the first one of the task is the same as offsetting the points and the roots
+		const size_t start = task / tasks_per_group * 2 * h;
+		const size_t first = task % tasks_per_group * width;
+		level<Forward>(re.data() + first, im.data() + first, root_re.data() + first, root_im.data() + first, start, start + 1, h, width);
+	});
+}
+
+/**
+ * @brief Decimation in frequency transform, leaving the values in bit reversed order.
+ *
+ * Each level of butterflies larger than a block, and then each block, is cut in tasks for the runner.
+ */
+template<typename Runner = SerialRunner>
+inline void forward_transform(real_span_t re, real_span_t im, const_real_span_t root_re, const_real_span_t root_im, const Runner &runner = {}) noexcept
+{
+	const size_t size = re.size();
+	const size_t block = std::min(size, block_size);
+
+	size_t h = size / 2;
+	for (; 2 * h > block; h /= 2)
+		large_level<true>(re, im, root_re, root_im, h, block, runner);
+	runner(size / block, [&](size_t index) {
+		for (size_t small = h; small > 0; small /= 2)
+			level<true>(re.data(), im.data(), root_re.data(), root_im.data(), index * block, (index + 1) * block, small, small);
+	});
+}
+
+/**
+ * @brief Undoes forward_transform up to a factor size, taking values in bit reversed order and leaving them in natural order.
+ */
+template<typename Runner = SerialRunner>
+inline void inverse_transform(real_span_t re, real_span_t im, const_real_span_t root_re, const_real_span_t root_im, const Runner &runner = {}) noexcept
+{
+	const size_t size = re.size();
+	const size_t block = std::min(size, block_size);
+
+	runner(size / block, [&](size_t index) {
+		for (size_t h = 1; 2 * h <= block; h *= 2)
+			level<false>(re.data(), im.data(), root_re.data(), root_im.data(), index * block, (index + 1) * block, h, h);
+	});
+	for (size_t h = block; h < size; h *= 2)
+		large_level<false>(re, im, root_re, root_im, h, block, runner);
+}
+
+//// Multiplication
+
+/**
+ * @brief Cuts the operand into points of the given number of bits, and passes each point to store with its index.
+ */
+template<typename Store>
+inline void split(const_span_t operand, size_t bits, Store &&store) noexcept
+{
+	const digit_t mask = (digit_t{1} << bits) - 1;
+	const size_t count = (operand.size() * digit_bits + bits - 1) / bits;
+
+	for (size_t k = 0; k < count; k++)
+	{
+		const size_t position = k * bits;
+		const size_t limb = position / digit_bits;
+		const size_t offset = position % digit_bits;
+
+		digit_t value = operand[limb] >> offset;
+		if (offset + bits > digit_bits && limb + 1 < operand.size())
+			value |= operand[limb + 1] << (digit_bits - offset);
+
+		store(k, static_cast<double>(value & mask));
+	}
+}
+
+/**
+ * @brief Rounds the first count coefficients to integers and adds them up into result, bits apart.
+ * @param coefficient Returns the coefficient with the given index.
+ */
+template<typename Coefficient>
+inline void recombine(span_t result, size_t count, size_t bits, Coefficient &&coefficient) noexcept
+{
+	const digit_t mask = (digit_t{1} << bits) - 1;
+	const size_t result_bits = result.size() * digit_bits;
+	std::fill(result.begin(), result.end(), 0);
+
+	digit_t carry = 0;
+	for (size_t k = 0; k * bits < result_bits; k++)
+	{
+		if (k < count)
+		{
+			// The error bound keeps the coefficients below 2^50 and their errors below one half, so adding 2^52 rounds
+			// them to the nearest integer, and anything that rounds below zero was a zero
+			const double rounded = (coefficient(k) + 0x1p52) - 0x1p52;
+			carry += rounded > 0 ? static_cast<digit_t>(rounded) : 0;
+		}
+
+		const size_t position = k * bits;
+		const size_t limb = position / digit_bits;
+		const size_t offset = position % digit_bits;
+		const digit_t value = carry & mask;
+		carry >>= bits;
+
+		result[limb] |= value << offset;
+		if (offset + bits > digit_bits && limb + 1 < result.size())
+			result[limb + 1] |= value >> (digit_bits - offset);
+	}
+}
+
+/**
+ * @brief result = lhs * rhs with a floating point FFT.
+ *
+ * @pre applicable(lhs.size(), rhs.size()), result.size() == lhs.size() + rhs.size(), and result does not overlap the operands.
+ * @param scratch Temporary space of at least scratch_size(lhs.size(), rhs.size()) doubles.
+ * @param runner Runs the tasks of the transforms. @see forward_transform
+ */
+template<typename Runner = SerialRunner>
+inline void mul(span_t result, const_span_t lhs, const_span_t rhs, real_span_t scratch, const Runner &runner = {}) noexcept
+{
+	const Plan split_plan = plan(lhs.size(), rhs.size());
+	assert(split_plan.bits != 0 && "The error bound does not hold for operands this long");
+
+	const size_t size = split_plan.size();
+	auto re = scratch.first(size);
+	auto im = scratch.subspan(size, size);
+	auto root_re = scratch.subspan(2 * size, size);
+	auto root_im = scratch.subspan(3 * size, size);
+
+	fill_roots(root_re, root_im);
+	std::fill(re.begin(), re.end(), 0.0);
+	std::fill(im.begin(), im.end(), 0.0);
+	split(lhs, split_plan.bits, [&](size_t k, double value) { re[k] = value; });
+	split(rhs, split_plan.bits, [&](size_t k, double value) { im[k] = value; });
+	forward_transform(re, im, root_re, root_im, runner);
+
+	// The transform of lhs + i rhs holds Z_k = A_k + i B_k, and conj(Z_-k) = A_k - i B_k, so
+	// A_k B_k = (Z_k^2 - conj(Z_-k)^2) / 4i. In bit reversed order, the partner of position p in [2^j, 2^(j + 1)) is 3 2^j - 1 - p.
+	// The scaling by 1 / size for the inverse transform is done here too.
+	const double scale = 1 / (4 * static_cast<double>(size));
+	auto untangle = [&](size_t p, size_t q) {
+		const double p_square_re = re[p] * re[p] - im[p] * im[p];
+		const double q_square_re = re[q] * re[q] - im[q] * im[q];
+		const double twice_products = 2 * (re[p] * im[p] + re[q] * im[q]);
+		const double difference = p_square_re - q_square_re;
+
+		// The product at q is the conjugate of the one at p, since the product is real
+		re[p] = twice_products * scale;
+		im[p] = -difference * scale;
+		re[q] = twice_products * scale;
+		im[q] = difference * scale;
+	};
+
+	untangle(0, 0);
+	untangle(1, 1);
+	for (size_t base = 2; base < size; base *= 2)
+		for (size_t p = base; p < base + base / 2; p++)
+			untangle(p, 3 * base - 1 - p);
+
+	inverse_transform(re, im, root_re, root_im, runner);
+	recombine(result, split_plan.lhs_points + split_plan.rhs_points - 1, split_plan.bits, [&](size_t k) { return re[k]; });
+}
+
+/**
+ * @brief Fills the twiddle tables with w^k = e^(-2 pi i k / size) in bit reversed order, like the transformed values,
+ * for untangling the transforms of real sequences packed in half as many complex points.
+ */
+inline void fill_twiddles(real_span_t twiddle_re, real_span_t twiddle_im, const_real_span_t root_re, const_real_span_t root_im) noexcept
+{
+	const size_t size = twiddle_re.size();
+
+	// Position p is advanced as a bit reversed counter, while k counts up normally
+	for (size_t k = 0, p = 0; k < size; k++)
+	{
+		const bool upper = k >= size / 2;
+		twiddle_re[p] = upper ? -root_re[k] : root_re[size / 2 + k];
+		twiddle_im[p] = upper ? -root_im[k] : root_im[size / 2 + k];
+
+		size_t bit = size / 2;
+		for (; p & bit; bit /= 2)
+			p ^= bit;
+		p |= bit;
+	}
+}
+
+/**
+ * @brief result = lhs * lhs with a floating point FFT.
+ *
+ * A real sequence only needs a complex transform of half its length: pairs of points go into the real and imaginary
+ * parts, and the transform of the whole sequence is untangled from that. The square is packed the same way before
+ * the inverse transform, so both transforms are half as long as for mul.
+ *
+ * @pre applicable(lhs.size(), lhs.size()), result.size() == 2 * lhs.size(), and result does not overlap lhs.
+ * @param scratch Temporary space of at least scratch_size(lhs.size(), lhs.size()) doubles.
+ * @param runner Runs the tasks of the transforms. @see forward_transform
+ */
+template<typename Runner = SerialRunner>
+inline void sqr(span_t result, const_span_t lhs, real_span_t scratch, const Runner &runner = {}) noexcept
+{
+	const Plan split_plan = plan(lhs.size(), lhs.size());
+	assert(split_plan.bits != 0 && "The error bound does not hold for operands this long");
+
+	const size_t size = split_plan.size() / 2;
+	auto re = scratch.first(size);
+	auto im = scratch.subspan(size, size);
+	auto root_re = scratch.subspan(2 * size, size);
+	auto root_im = scratch.subspan(3 * size, size);
+	auto twiddle_re = scratch.subspan(4 * size, size);
+	auto twiddle_im = scratch.subspan(5 * size, size);
+
+	fill_roots(root_re, root_im);
+	std::fill(re.begin(), re.end(), 0.0);
+	std::fill(im.begin(), im.end(), 0.0);
+	split(lhs, split_plan.bits, [&](size_t k, double value) { (k % 2 ? im : re)[k / 2] = value; });
+	forward_transform(re, im, root_re, root_im, runner);
+
+	fill_twiddles(twiddle_re, twiddle_im, root_re, root_im);
+
+	// Z_k = E_k + i O_k holds the transforms of the even and odd points, which come out as (Z_k + conj(Z_-k)) / 2 and
+	// (Z_k - conj(Z_-k)) / 2i. The transform of the square, packed the same way, is E_k^2 + w^k O_k^2 + 2i E_k O_k.
+	// The scaling by 1 / size for the inverse transform is done here too.
+	const double scale = 1 / static_cast<double>(size);
+	auto square = [&](size_t p, double even_re, double even_im, double odd_re, double odd_im) {
+		const double odd_square_re = odd_re * odd_re - odd_im * odd_im;
+		const double odd_square_im = 2 * odd_re * odd_im;
+		const double cross_re = 2 * (even_re * odd_re - even_im * odd_im);
+		const double cross_im = 2 * (even_re * odd_im + even_im * odd_re);
+
+		re[p] = (even_re * even_re - even_im * even_im + twiddle_re[p] * odd_square_re - twiddle_im[p] * odd_square_im - cross_im) * scale;
+		im[p] = (2 * even_re * even_im + twiddle_re[p] * odd_square_im + twiddle_im[p] * odd_square_re + cross_re) * scale;
+	};
+	auto untangle = [&](size_t p, size_t q) {
+		const double even_re = (re[p] + re[q]) / 2;
+		const double even_im = (im[p] - im[q]) / 2;
+		const double odd_re = (im[p] + im[q]) / 2;
+		const double odd_im = (re[q] - re[p]) / 2;
+
+		// The values at q are the conjugates of those at p
+		square(p, even_re, even_im, odd_re, odd_im);
+		if (q != p)
+			square(q, even_re, -even_im, odd_re, -odd_im);
+	};
+
+	untangle(0, 0);
+	untangle(1, 1);
+	for (size_t base = 2; base < size; base *= 2)
+		for (size_t p = base; p < base + base / 2; p++)
+			untangle(p, 3 * base - 1 - p);
+
+	inverse_transform(re, im, root_re, root_im, runner);
+	recombine(result, 2 * split_plan.lhs_points - 1, split_plan.bits, [&](size_t k) { return k % 2 ? im[k / 2] : re[k / 2]; });
+}
+
+//// Prepared operands
+// An operand that is multiplied many times can be transformed once. It is packed as in sqr, so each product takes one
+// forward and one inverse transform of half the length of those of mul.
+
+/**
+ * @brief Number of doubles filled by prepare for operands of these sizes: the transform of the prepared operand, and
+ * the root and twiddle tables.
+ */
+constexpr size_t prepared_size(size_t lhs_size, size_t rhs_size) noexcept
+{
+	return 3 * plan(lhs_size, rhs_size).size();
+}
+
+/**
+ * @brief Number of doubles of scratch space needed by mul_prepared.
+ */
+constexpr size_t prepared_scratch_size(size_t lhs_size, size_t rhs_size) noexcept
+{
+	return plan(lhs_size, rhs_size).size();
+}
+
+/**
+ * @brief Transforms rhs once, for products with any lhs of at most lhs_size limbs by mul_prepared.
+ *
+ * @pre applicable(lhs_size, rhs.size()).
+ * @param prepared Space of prepared_size(lhs_size, rhs.size()) doubles.
+ * @param runner Runs the tasks of the transform. @see forward_transform
+ */
+template<typename Runner = SerialRunner>
+inline void prepare(real_span_t prepared, size_t lhs_size, const_span_t rhs, const Runner &runner = {}) noexcept
+{
+	const Plan split_plan = plan(lhs_size, rhs.size());
+	assert(split_plan.bits != 0 && "The error bound does not hold for operands this long");
+
+	const size_t size = split_plan.size() / 2;
+	auto re = prepared.first(size);
+	auto im = prepared.subspan(size, size);
+	auto root_re = prepared.subspan(2 * size, size);
+	auto root_im = prepared.subspan(3 * size, size);
+	auto twiddle_re = prepared.subspan(4 * size, size);
+	auto twiddle_im = prepared.subspan(5 * size, size);
+
+	fill_roots(root_re, root_im);
+	fill_twiddles(twiddle_re, twiddle_im, root_re, root_im);
+	std::fill(re.begin(), re.end(), 0.0);
+	std::fill(im.begin(), im.end(), 0.0);
+	split(rhs, split_plan.bits, [&](size_t k, double value) { (k % 2 ? im : re)[k / 2] = value; });
+	forward_transform(re, im, root_re, root_im, runner);
+}
+
+/**
+ * @brief result = lhs * rhs with a floating point FFT, where rhs was transformed by prepare.
+ *
+ * Only lhs is transformed. The error bound of the plan for lhs_size counts three transforms, so it holds for the
+ * separate transforms of the operands as well, and for any shorter lhs.
+ *
+ * @pre prepared was filled by prepare(prepared, lhs_size, rhs), lhs.size() <= lhs_size,
+ * result.size() == lhs.size() + rhs_size, and result does not overlap lhs.
+ * @param scratch Temporary space of at least prepared_scratch_size(lhs_size, rhs_size) doubles.
+ * @param runner Runs the tasks of the transforms. @see forward_transform
+ */
+template<typename Runner = SerialRunner>
+inline void mul_prepared(span_t result, const_span_t lhs, const_real_span_t prepared, size_t lhs_size, size_t rhs_size,
+						 real_span_t scratch, const Runner &runner = {}) noexcept
+{
+	assert(lhs.size() <= lhs_size);
+	const Plan split_plan = plan(lhs_size, rhs_size);
+	assert(split_plan.bits != 0 && "The error bound does not hold for operands this long");
+
+	const size_t size = split_plan.size() / 2;
+	auto re = scratch.first(size);
+	auto im = scratch.subspan(size, size);
+	auto rhs_re = prepared.first(size);
+	auto rhs_im = prepared.subspan(size, size);
+	auto root_re = prepared.subspan(2 * size, size);
+	auto root_im = prepared.subspan(3 * size, size);
+	auto twiddle_re = prepared.subspan(4 * size, size);
+	auto twiddle_im = prepared.subspan(5 * size, size);
+
+	std::fill(re.begin(), re.end(), 0.0);
+	std::fill(im.begin(), im.end(), 0.0);
+	split(lhs, split_plan.bits, [&](size_t k, double value) { (k % 2 ? im : re)[k / 2] = value; });
+	forward_transform(re, im, root_re, root_im, runner);
+
+	// Both transforms hold the transforms of the even and odd points as in sqr. The transform of the product, packed the
+	// same way, is E_k F_k + w^k O_k P_k + i (E_k P_k + O_k F_k), where F and P are those of rhs.
+	const double scale = 1 / static_cast<double>(size);
+	auto multiply = [&](size_t p, double even_re, double even_im, double odd_re, double odd_im, double rhs_even_re,
+						double rhs_even_im, double rhs_odd_re, double rhs_odd_im) {
+		const double evens_re = even_re * rhs_even_re - even_im * rhs_even_im;
+		const double evens_im = even_re * rhs_even_im + even_im * rhs_even_re;
+		const double odds_re = odd_re * rhs_odd_re - odd_im * rhs_odd_im;
+		const double odds_im = odd_re * rhs_odd_im + odd_im * rhs_odd_re;
+		const double cross_re = even_re * rhs_odd_re - even_im * rhs_odd_im + odd_re * rhs_even_re - odd_im * rhs_even_im;
+		const double cross_im = even_re * rhs_odd_im + even_im * rhs_odd_re + odd_re * rhs_even_im + odd_im * rhs_even_re;
+
+		re[p] = (evens_re + twiddle_re[p] * odds_re - twiddle_im[p] * odds_im - cross_im) * scale;
+		im[p] = (evens_im + twiddle_re[p] * odds_im + twiddle_im[p] * odds_re + cross_re) * scale;
+	};
+	auto untangle = [&](size_t p, size_t q) {
+		const double even_re = (re[p] + re[q]) / 2;
+		const double even_im = (im[p] - im[q]) / 2;
+		const double odd_re = (im[p] + im[q]) / 2;
+		const double odd_im = (re[q] - re[p]) / 2;
+		const double rhs_even_re = (rhs_re[p] + rhs_re[q]) / 2;
+		const double rhs_even_im = (rhs_im[p] - rhs_im[q]) / 2;
+		const double rhs_odd_re = (rhs_im[p] + rhs_im[q]) / 2;
+		const double rhs_odd_im = (rhs_re[q] - rhs_re[p]) / 2;
+
+		// The values at q are the conjugates of those at p
+		multiply(p, even_re, even_im, odd_re, odd_im, rhs_even_re, rhs_even_im, rhs_odd_re, rhs_odd_im);
+		if (q != p)
+			multiply(q, even_re, -even_im, odd_re, -odd_im, rhs_even_re, -rhs_even_im, rhs_odd_re, -rhs_odd_im);
+	};
+
+	untangle(0, 0);
+	untangle(1, 1);
+	for (size_t base = 2; base < size; base *= 2)
+		for (size_t p = base; p < base + base / 2; p++)
+			untangle(p, 3 * base - 1 - p);
+
+	inverse_transform(re, im, root_re, root_im, runner);
+	const size_t lhs_points = (lhs.size() * digit_bits + split_plan.bits - 1) / split_plan.bits;
+	recombine(result, lhs_points + split_plan.rhs_points - 1, split_plan.bits, [&](size_t k) { return k % 2 ? im[k / 2] : re[k / 2]; });
+}
+
+}// namespace suuri::fft
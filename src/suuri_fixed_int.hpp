@@ -0,0 +1,447 @@
+#pragma once
+
+#include "big_int.hpp"
+#include "suuri_concept.hpp"
+#include "suuri_core.hpp"
+#include "suuri_exception.hpp"
+
+#include <array>
+#include <bit>
+#include <compare>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace suuri
+{
+
+/**
+ * Calls f(std::integral_constant<size_t, I>{}) for every I in [0, N), fully unrolled at compile time.
+ */
+template<size_t N, typename F>
+constexpr void unroll(F &&f)
+{
+	[&]<size_t... I>(std::index_sequence<I...>) {
+		(f(std::integral_constant<size_t, I>{}), ...);
+	}(std::make_index_sequence<N>{});
+}
+
+/**
+ * Fixed width signed integer stored in two's complement, with all digits on the stack.
+ *
+ * Arithmetic wraps around modulo 2^Bits, like the builtin unsigned types. Since the number of digits is known at compile time,
+ * the addition, subtraction, multiplication and comparison loops are fully unrolled, and no operation ever allocates.
+ * @tparam Bits The width of the integer. Must be a multiple of digit_bits.
+ */
+template<size_t Bits>
+	requires(Bits > 0 && Bits % digit_bits == 0)
+class FixedInt
+{
+public:
+	static constexpr size_t digit_count = Bits / digit_bits;
+	typedef std::array<digit_t, digit_count> storage_type;
+
+	//// Constructors
+
+	/**
+	 * Initialises to 0
+	 */
+	constexpr FixedInt() noexcept
+		: digits_{}
+	{}
+	/**
+	 * Initialises with a primitive integer type. Negative values are sign extended.
+	 * @tparam Must be a builtin primitive integral type
+	 */
+	template<typename T>
+		requires std::is_fundamental_v<T> && std::integral<T>
+	constexpr FixedInt(T num) noexcept
+		: digits_{}
+	{
+		static_assert(sizeof(T) <= sizeof(digit_t), "Primitive must fit in a single digit");
+
+		const digit_t extension = num < 0 ? ~static_cast<digit_t>(0) : 0;
+		digits_.fill(extension);
+		digits_[0] = static_cast<digit_t>(num);
+	}
+	/**
+	 * @param digits The digits of the integer in two's complement, least significant first.
+	 */
+	constexpr explicit FixedInt(const storage_type &digits) noexcept
+		: digits_(digits)
+	{}
+	/**
+	 * Converts from a big integer, keeping the value modulo 2^Bits.
+	 */
+	template<typename Allocator>
+	constexpr explicit FixedInt(const BasicBigInt<Allocator> &num) noexcept
+		: digits_{}
+	{
+		const auto num_digits = num.digits();
+		for (size_t i = 0; i < digit_count && i < num_digits.size(); i++)
+			digits_[i] = num_digits[i];
+
+		if (num.sgn() < 0)
+			negate_digits();
+	}
+	/**
+	 * Initialise using a string. See the string constructor of BasicBigInt for the accepted format.
+	 */
+	constexpr explicit FixedInt(const std::string &str)
+		: FixedInt(BigInt(str))
+	{}
+
+	// Copy constructor and move constructor
+
+	constexpr FixedInt(const FixedInt &rhs) = default;
+	constexpr FixedInt(FixedInt &&rhs) = default;
+
+
+	//// Operators
+
+	/// Assignment Operators
+
+	constexpr FixedInt &operator=(const FixedInt &rhs) = default;
+	constexpr FixedInt &operator=(FixedInt &&rhs) = default;
+
+	/// Comparison Operators
+
+	constexpr bool operator==(const FixedInt &rhs) const noexcept
+	{
+		bool equal = true;
+		unroll<digit_count>([&](auto i) {
+			equal &= digits_[i] == rhs.digits_[i];
+		});
+
+		return equal;
+	}
+	constexpr std::strong_ordering operator<=>(const FixedInt &rhs) const noexcept
+	{
+		// The sign decides the ordering if it differs, otherwise the digits compare as unsigned from the most significant one
+		if (is_negative() != rhs.is_negative())
+			return is_negative() ? std::strong_ordering::less : std::strong_ordering::greater;
+
+		auto ordering = std::strong_ordering::equal;
+		unroll<digit_count>([&](auto i) {
+			constexpr size_t digit = digit_count - 1 - decltype(i)::value;
+			if (ordering == std::strong_ordering::equal)
+				ordering = digits_[digit] <=> rhs.digits_[digit];
+		});
+
+		return ordering;
+	}
+
+	/// Arithmetic Operators
+
+	// ---------- Addition
+
+	constexpr FixedInt operator+(const FixedInt &rhs) const noexcept
+	{
+		return FixedInt(*this) += rhs;
+	}
+	constexpr FixedInt &operator+=(const FixedInt &rhs) noexcept
+	{
+		digit_t carry = 0;
+		unroll<digit_count>([&](auto i) {
+			digits_[i] = add_with_carry(digits_[i], rhs.digits_[i], carry);
+		});
+
+		return *this;
+	}
+
+	// ---------- Subtraction
+
+	constexpr FixedInt operator-(const FixedInt &rhs) const noexcept
+	{
+		return FixedInt(*this) -= rhs;
+	}
+	constexpr FixedInt &operator-=(const FixedInt &rhs) noexcept
+	{
+		digit_t borrow = 0;
+		unroll<digit_count>([&](auto i) {
+			digits_[i] = subtract_with_borrow(digits_[i], rhs.digits_[i], borrow);
+		});
+
+		return *this;
+	}
+	constexpr FixedInt operator-() const noexcept
+	{
+		FixedInt ret = *this;
+		ret.negate_digits();
+		return ret;
+	}
+
+	// ---------- Multiplication
+
+	constexpr FixedInt operator*(const FixedInt &rhs) const noexcept
+	{
+		// Only the digits below digit_count are computed, which are the same for signed and unsigned operands
+		FixedInt ret;
+		unroll<digit_count>([&](auto i) {
+			digit_t carry = 0;
+			unroll<digit_count - decltype(i)::value>([&](auto j) {
+				ret.digits_[i + j] = multiply_add_digits(digits_[i], rhs.digits_[j], ret.digits_[i + j], carry);
+			});
+		});
+
+		return ret;
+	}
+	constexpr FixedInt &operator*=(const FixedInt &rhs) noexcept
+	{
+		*this = *this * rhs;
+		return *this;
+	}
+
+	/**
+	 * @brief Squares this value. Each cross product appears twice in a square, so it is computed once and doubled.
+	 */
+	[[nodiscard]] constexpr FixedInt square() const noexcept
+	{
+		// The cross products digits_[i] * digits_[j] with i < j, of which only those below digit_count are needed
+		FixedInt ret;
+		unroll<digit_count>([&](auto i) {
+			constexpr size_t row = decltype(i)::value;
+			constexpr size_t cross_count = 2 * row + 1 < digit_count ? digit_count - 2 * row - 1 : 0;
+
+			digit_t carry = 0;
+			unroll<cross_count>([&](auto j) {
+				ret.digits_[2 * row + 1 + j] = multiply_add_digits(digits_[row], digits_[row + 1 + j], ret.digits_[2 * row + 1 + j], carry);
+			});
+		});
+
+		digit_t shifted_out = 0;
+		unroll<digit_count>([&](auto i) {
+			const digit_t next = ret.digits_[i] >> (digit_bits - 1);
+			ret.digits_[i] = (ret.digits_[i] << 1) | shifted_out;
+			shifted_out = next;
+		});
+
+		// Add the squares of the digits on the diagonal
+		digit_t carry = 0;
+		digit_t high = 0;
+		unroll<digit_count>([&](auto i) {
+			if constexpr (decltype(i)::value % 2 == 0)
+			{
+				const digit_t low = multiply_digits(digits_[i / 2], digits_[i / 2], high);
+				ret.digits_[i] = add_with_carry(ret.digits_[i], low, carry);
+			} else
+			{
+				ret.digits_[i] = add_with_carry(ret.digits_[i], high, carry);
+			}
+		});
+
+		return ret;
+	}
+
+	// ---------- Division
+
+	/**
+	 * Division truncates towards zero, and the remainder has the sign of the dividend, like the builtin types.
+	 */
+	constexpr FixedInt operator/(const FixedInt &rhs) const
+	{
+		return divide(rhs).first;
+	}
+	constexpr FixedInt &operator/=(const FixedInt &rhs)
+	{
+		*this = divide(rhs).first;
+		return *this;
+	}
+	constexpr FixedInt operator%(const FixedInt &rhs) const
+	{
+		return divide(rhs).second;
+	}
+	constexpr FixedInt &operator%=(const FixedInt &rhs)
+	{
+		*this = divide(rhs).second;
+		return *this;
+	}
+
+	//// Misc methods
+
+	[[nodiscard]] constexpr bool is_zero() const noexcept
+	{
+		return *this == FixedInt();
+	}
+
+	[[nodiscard]] constexpr bool is_negative() const noexcept
+	{
+		return digits_[digit_count - 1] >> (digit_bits - 1);
+	}
+
+	//// State accessor methods
+
+	/**
+	 * @return The digits in two's complement, least significant first.
+	 */
+	[[nodiscard]] constexpr const storage_type &digits() const noexcept
+	{
+		return digits_;
+	}
+
+	//// Conversion methods
+
+	template<typename Allocator = std::allocator<digit_t>>
+	[[nodiscard]] constexpr BasicBigInt<Allocator> to_big_int(const Allocator &alloc = Allocator()) const
+	{
+		const FixedInt magnitude = is_negative() ? -*this : *this;
+
+		size_t size = digit_count;
+		while (size > 1 && magnitude.digits_[size - 1] == 0)
+			size--;
+
+		return BasicBigInt<Allocator>(std::span<const digit_t>(magnitude.digits_.data(), size), is_negative(), alloc);
+	}
+
+	[[nodiscard]] constexpr std::string to_string() const
+	{
+		return (is_negative() ? "-" : "") + to_big_int().abs().to_string();
+	}
+
+	//// Math operations
+
+	[[nodiscard]] constexpr int8_t sgn() const noexcept
+	{
+		if (is_negative())
+			return -1;
+
+		return is_zero() ? 0 : 1;
+	}
+
+	/**
+	 * @note Like the builtin types, the absolute value of the minimum value is the minimum value itself.
+	 */
+	[[nodiscard]] constexpr FixedInt abs() const noexcept
+	{
+		return is_negative() ? -*this : *this;
+	}
+
+	[[nodiscard]] constexpr FixedInt pow(uint64_t n) const noexcept
+	{
+#ifndef ZERO_POW_ZERO_IS_ONE
+		assert(!(is_zero() && n == 0) && "0 to the power of 0 is undefined");
+#endif
+		if (n == 0)
+			return 1;
+
+		FixedInt x = *this;
+		FixedInt y = 1;
+		while (n > 1)
+		{
+			if (n % 2)
+			{
+				y = x * y;
+				n--;
+			}
+			x = x.square();
+			n /= 2;
+		}
+		return x * y;
+	}
+
+private:
+	storage_type digits_;
+
+	//// Private methods
+
+	/// Helper methods
+
+	constexpr void negate_digits() noexcept
+	{
+		// Two's complement negation is the bitwise complement plus one
+		digit_t carry = 1;
+		unroll<digit_count>([&](auto i) {
+			digits_[i] = add_with_carry(~digits_[i], 0, carry);
+		});
+	}
+
+	[[nodiscard]] constexpr size_t bit_width() const noexcept
+	{
+		for (size_t i = digit_count; i-- > 0;)
+			if (digits_[i] != 0)
+				return i * digit_bits + std::bit_width(digits_[i]);
+
+		return 0;
+	}
+
+	/// Division methods
+
+	[[nodiscard]] constexpr std::pair<FixedInt, FixedInt> divide(const FixedInt &rhs) const
+	{
+		if (rhs.is_zero())
+			throw divide_by_zero();
+
+		// Divide the magnitudes as unsigned values. The magnitude of the minimum value is still correct when read as unsigned.
+		auto [quotient, remainder] = divide_unsigned(abs(), rhs.abs());
+
+		if (is_negative() != rhs.is_negative())
+			quotient.negate_digits();
+		if (is_negative())
+			remainder.negate_digits();
+
+		return {quotient, remainder};
+	}
+
+	[[nodiscard]] static constexpr std::pair<FixedInt, FixedInt> divide_unsigned(const FixedInt &lhs, const FixedInt &rhs) noexcept
+	{
+		FixedInt quotient;
+		FixedInt remainder;
+
+		if (rhs.bit_width() <= digit_bits)
+		{
+			// Single digit divisor, so divide a digit at a time
+			digit_t rem = 0;
+			for (size_t i = digit_count; i-- > 0;)
+				quotient.digits_[i] = divide_digits(rem, lhs.digits_[i], rhs.digits_[0], rem);
+			remainder.digits_[0] = rem;
+
+			return {quotient, remainder};
+		}
+
+		// Binary long division, starting from the most significant set bit of lhs
+		for (size_t bit = lhs.bit_width(); bit-- > 0;)
+		{
+			// remainder = remainder * 2 + next bit of lhs. remainder < rhs <= 2^(Bits - 1), so this cannot overflow the unsigned value
+			digit_t carry = (lhs.digits_[bit / digit_bits] >> (bit % digit_bits)) & 1;
+			unroll<digit_count>([&](auto i) {
+				const digit_t next_carry = remainder.digits_[i] >> (digit_bits - 1);
+				remainder.digits_[i] = (remainder.digits_[i] << 1) | carry;
+				carry = next_carry;
+			});
+
+			if (!remainder.less_unsigned(rhs))
+			{
+				remainder -= rhs;
+				quotient.digits_[bit / digit_bits] |= static_cast<digit_t>(1) << (bit % digit_bits);
+			}
+		}
+
+		return {quotient, remainder};
+	}
+
+	[[nodiscard]] constexpr bool less_unsigned(const FixedInt &rhs) const noexcept
+	{
+		for (size_t i = digit_count; i-- > 0;)
+			if (digits_[i] != rhs.digits_[i])
+				return digits_[i] < rhs.digits_[i];
+
+		return false;
+	}
+
+	// Provide a friend overload for the testing framework.
+	friend inline void PrintTo(const FixedInt &fixed_int, std::ostream *os)
+	{
+		*os << fixed_int.to_string();
+	}
+};
+
+typedef FixedInt<256> fixed_int256_t;
+typedef FixedInt<384> fixed_int384_t;
+typedef FixedInt<512> fixed_int512_t;
+typedef FixedInt<4096> fixed_int4096_t;
+
+template<size_t Bits>
+struct is_big_int<FixedInt<Bits>> : std::true_type {
+};
+
+}// namespace suuri
@@ -0,0 +1,759 @@
+#pragma once
+
+#include "suuri_core.hpp"
+#include "suuri_cpu.hpp"
+
+#include <algorithm>
+#include <assert.h>
+#include <span>
+#include <type_traits>
+
+/**
+ * Arithmetic on numbers in radix 2^52, for the AVX-512 IFMA instructions.
+ *
+ * vpmadd52luq and vpmadd52huq add the low and the high 52 bits of eight 52 by 52 bit products to 64 bit lanes. Numbers
+ * converted to 52 bit digits leave 12 bits of headroom in every lane, so thousands of products can be summed before any
+ * carry has to move between lanes.
+ *
+ * Every kernel has a portable twin that does the same lane operations one at a time, chosen with Backend::emulated.
+ * It runs on any CPU and in constant evaluation, so the algorithms can be tested without the instructions.
+ */
+namespace suuri::ifma
+{
+
+typedef std::span<digit_t> span_t;
+typedef std::span<const digit_t> const_span_t;
+
+//// Radix 2^52
+
+constexpr unsigned radix_bits = 52;
+constexpr digit_t radix_mask = (digit_t(1) << radix_bits) - 1;
+
+/**
+ * The hardware kernels, or their portable emulation. Builds without the hardware kernels run the emulation for either.
+ */
+enum class Backend {
+	ifma,
+	emulated,
+};
+
+/**
+ * @brief Checks if the IFMA kernels can run, that is outside constant evaluation and on a CPU with AVX-512 IFMA.
+ */
+constexpr bool usable() noexcept
+{
+	return !std::is_constant_evaluated() && cpu::has_avx512ifma();
+}
+
+/**
+ * @return The IFMA backend if it can run, and the emulation otherwise.
+ */
+constexpr Backend best_backend() noexcept
+{
+	return usable() ? Backend::ifma : Backend::emulated;
+}
+
+/**
+ * @return The number of 52 bit digits holding a number of size limbs.
+ */
+constexpr size_t radix52_size(size_t size) noexcept
+{
+	return (size * digit_bits + radix_bits - 1) / radix_bits;
+}
+
+/**
+ * @brief Splits limbs into 52 bit digits.
+ *
+ * @pre digits.size() >= radix52_size(limbs.size()). Digits past the value are set to 0.
+ */
+constexpr void to_radix52(span_t digits, const_span_t limbs) noexcept
+{
+	for (size_t i = 0; i < digits.size(); i++)
+	{
+		const size_t bit = i * radix_bits;
+		const size_t limb = bit / digit_bits;
+		const unsigned offset = bit % digit_bits;
+		if (limb >= limbs.size())
+		{
+			digits[i] = 0;
+			continue;
+		}
+
+		digit_t value = limbs[limb] >> offset;
+		if (offset > digit_bits - radix_bits && limb + 1 < limbs.size())
+			value |= limbs[limb + 1] << (digit_bits - offset);
+		digits[i] = value & radix_mask;
+	}
+}
+
+/**
+ * @brief Packs 52 bit digits into limbs.
+ *
+ * @pre Every digit is below 2^52. Limbs past the value are set to 0, and the value has to fit in limbs.
+ */
+constexpr void from_radix52(span_t limbs, const_span_t digits) noexcept
+{
+	for (size_t i = 0; i < limbs.size(); i++)
+	{
+		const size_t bit = i * digit_bits;
+		size_t digit = bit / radix_bits;
+		const unsigned offset = bit % radix_bits;
+		if (digit >= digits.size())
+		{
+			limbs[i] = 0;
+			continue;
+		}
+
+		digit_t value = digits[digit] >> offset;
+		for (unsigned shift = radix_bits - offset; shift < digit_bits && ++digit < digits.size(); shift += radix_bits)
+			value |= digits[digit] << shift;
+		limbs[i] = value;
+	}
+}
+
+/**
+ * @brief Carries the excess of every digit into the next one, so all are below 2^52.
+ *
+ * @return The carry out of the most significant digit.
+ */
+constexpr digit_t normalise(span_t digits) noexcept
+{
+	digit_t carry = 0;
+	for (auto &digit: digits)
+	{
+		// Digits hold sums far below 2^64 - 2^12, so adding the carry cannot overflow
+		digit += carry;
+		carry = digit >> radix_bits;
+		digit &= radix_mask;
+	}
+
+	return carry;
+}
+
+/// Emulated lane operations
+
+/**
+ * @brief vpmadd52luq on one lane: acc plus the low 52 bits of the product of the low 52 bits of lhs and rhs.
+ */
+constexpr digit_t madd52lo(digit_t acc, digit_t lhs, digit_t rhs) noexcept
+{
+	return acc + ((lhs & radix_mask) * (rhs & radix_mask) & radix_mask);
+}
+
+/**
+ * @brief vpmadd52huq on one lane: acc plus the high 52 bits of the product of the low 52 bits of lhs and rhs.
+ */
+constexpr digit_t madd52hi(digit_t acc, digit_t lhs, digit_t rhs) noexcept
+{
+	digit_t high;
+	const digit_t low = multiply_digits(lhs & radix_mask, rhs & radix_mask, high);
+	return acc + ((high << (digit_bits - radix_bits)) | (low >> radix_bits));
+}
+
+//// Column products
+
+// A product of numbers in radix 2^52 is summed column by column. The low halves of the 52 bit products in column c go
+// to low[c] and the high halves, which belong to column c + 1, to high[c], so a window of columns never needs its
+// neighbours while it is summed.
+
+/**
+ * The number of columns the product kernels sum at a time, two vectors of eight lanes.
+ */
+constexpr size_t window = 16;
+
+/**
+ * The most digits the product kernels take in an operand. Beyond that the columns could overflow their lanes.
+ */
+constexpr size_t max_digits = 2048;
+
+/**
+ * @brief Number of digits of the zero padded copy of an operand that the product kernels load from.
+ */
+constexpr size_t padded_size(size_t size) noexcept
+{
+	return window + size + window;
+}
+
+/**
+ * @brief Copies an operand into the middle of padded, with window zero digits on either side.
+ *
+ * @pre padded.size() == padded_size(digits.size()).
+ */
+constexpr void pad(span_t padded, const_span_t digits) noexcept
+{
+	std::fill_n(padded.begin(), window, 0);
+	std::copy(digits.begin(), digits.end(), padded.begin() + window);
+	std::fill(padded.begin() + static_cast<ptrdiff_t>(window + digits.size()), padded.end(), 0);
+}
+
+/**
+ * @return The number of entries of low and high the product kernels write, for a product of this many columns.
+ */
+constexpr size_t columns_size(size_t columns) noexcept
+{
+	return (columns + window - 1) / window * window;
+}
+
+/**
+ * @brief Sums the columns of lhs * rhs, one lane at a time.
+ *
+ * For every window of columns, each digit of rhs with a product in the window is multiplied with the digits of lhs
+ * that land in it, which sit at a shifted offset in the padded copy of lhs.
+ *
+ * @param lhs The digits of lhs padded as by pad, with lhs_size digits in the middle.
+ * @param low,high columns_size(lhs_size + rhs.size()) entries each.
+ * @pre Both operands have at most max_digits digits.
+ */
+constexpr void mul_columns_emulated(span_t low, span_t high, const_span_t lhs, size_t lhs_size, const_span_t rhs) noexcept
+{
+	for (size_t column = 0; column < lhs_size + rhs.size(); column += window)
+	{
+		digit_t lows[window] = {};
+		digit_t highs[window] = {};
+
+		const size_t end = std::min(rhs.size(), column + window);
+		for (size_t j = column + 1 > lhs_size ? column + 1 - lhs_size : 0; j < end; j++)
+		{
+			const digit_t *lanes = lhs.data() + window + column - j;
+			for (size_t lane = 0; lane < window; lane++)
+			{
+				lows[lane] = madd52lo(lows[lane], lanes[lane], rhs[j]);
+				highs[lane] = madd52hi(highs[lane], lanes[lane], rhs[j]);
+			}
+		}
+
+		std::copy_n(lows, window, low.begin() + static_cast<ptrdiff_t>(column));
+		std::copy_n(highs, window, high.begin() + static_cast<ptrdiff_t>(column));
+	}
+}
+
+/**
+ * @brief Sums the columns of lhs * lhs, one lane at a time.
+ *
+ * Only the products of digits i < j are summed, and the sums are doubled before the squares of the digits are added,
+ * which halves the multiplications.
+ *
+ * @param lhs The digits of lhs padded as by pad, with size digits in the middle.
+ * @param low,high columns_size(2 * size) entries each.
+ * @pre size <= max_digits.
+ */
+constexpr void sqr_columns_emulated(span_t low, span_t high, const_span_t lhs, size_t size) noexcept
+{
+	const auto digits = lhs.subspan(window, size);
+	for (size_t column = 0; column < 2 * size; column += window)
+	{
+		digit_t lows[window] = {};
+		digit_t highs[window] = {};
+
+		// Digit j pairs with the digits i = column + lane - j below it
+		const size_t end = std::min(size, column + window);
+		for (size_t j = column / 2 + 1; j < end; j++)
+		{
+			const digit_t *lanes = lhs.data() + window + column - j;
+			const size_t below = std::min(window, 2 * j - column);
+			for (size_t lane = 0; lane < below; lane++)
+			{
+				lows[lane] = madd52lo(lows[lane], lanes[lane], digits[j]);
+				highs[lane] = madd52hi(highs[lane], lanes[lane], digits[j]);
+			}
+		}
+
+		for (size_t lane = 0; lane < window; lane++)
+		{
+			low[column + lane] = 2 * lows[lane];
+			high[column + lane] = 2 * highs[lane];
+		}
+	}
+
+	for (size_t i = 0; i < size; i++)
+	{
+		low[2 * i] = madd52lo(low[2 * i], digits[i], digits[i]);
+		high[2 * i] = madd52hi(high[2 * i], digits[i], digits[i]);
+	}
+}
+
+#ifdef SUURI_X86_DISPATCH
+/**
+ * @brief mul_columns_emulated with AVX-512 IFMA.
+ */
+__attribute__((target("avx512f,avx512ifma"))) inline void mul_columns_ifma(span_t low, span_t high, const_span_t lhs, size_t lhs_size,
+																		   const_span_t rhs) noexcept
+{
+	for (size_t column = 0; column < lhs_size + rhs.size(); column += window)
+	{
+		__m512i lows[2] = {_mm512_setzero_si512(), _mm512_setzero_si512()};
+		__m512i highs[2] = {_mm512_setzero_si512(), _mm512_setzero_si512()};
+
+		const size_t end = std::min(rhs.size(), column + window);
+		for (size_t j = column + 1 > lhs_size ? column + 1 - lhs_size : 0; j < end; j++)
+		{
+			const __m512i digit = _mm512_set1_epi64(static_cast<int64_t>(rhs[j]));
+			const digit_t *lanes = lhs.data() + window + column - j;
+			for (size_t v = 0; v < 2; v++)
+			{
+				const __m512i x = _mm512_loadu_si512(lanes + 8 * v);
+				lows[v] = _mm512_madd52lo_epu64(lows[v], x, digit);
+				highs[v] = _mm512_madd52hi_epu64(highs[v], x, digit);
+			}
+		}
+
+		for (size_t v = 0; v < 2; v++)
+		{
+			_mm512_storeu_si512(low.data() + column + 8 * v, lows[v]);
+			_mm512_storeu_si512(high.data() + column + 8 * v, highs[v]);
+		}
+	}
+}
+
+/**
+ * @brief sqr_columns_emulated with AVX-512 IFMA, masking off the lanes of the digits that are not below j.
+ */
+__attribute__((target("avx512f,avx512ifma"))) inline void sqr_columns_ifma(span_t low, span_t high, const_span_t lhs, size_t size) noexcept
+{
+	const auto digits = lhs.subspan(window, size);
+	for (size_t column = 0; column < 2 * size; column += window)
+	{
+		__m512i lows[2] = {_mm512_setzero_si512(), _mm512_setzero_si512()};
+		__m512i highs[2] = {_mm512_setzero_si512(), _mm512_setzero_si512()};
+
+		const size_t end = std::min(size, column + window);
+		for (size_t j = column / 2 + 1; j < end; j++)
+		{
+			const __m512i digit = _mm512_set1_epi64(static_cast<int64_t>(digits[j]));
+			const digit_t *lanes = lhs.data() + window + column - j;
+			const size_t below = std::min(window, 2 * j - column);
+			for (size_t v = 0; v < 2 && 8 * v < below; v++)
+			{
+				const auto mask = static_cast<__mmask8>(below >= 8 * v + 8 ? 0xff : (1u << (below - 8 * v)) - 1);
+				const __m512i x = _mm512_loadu_si512(lanes + 8 * v);
+				lows[v] = _mm512_mask_madd52lo_epu64(lows[v], mask, x, digit);
+				highs[v] = _mm512_mask_madd52hi_epu64(highs[v], mask, x, digit);
+			}
+		}
+
+		for (size_t v = 0; v < 2; v++)
+		{
+			_mm512_storeu_si512(low.data() + column + 8 * v, _mm512_add_epi64(lows[v], lows[v]));
+			_mm512_storeu_si512(high.data() + column + 8 * v, _mm512_add_epi64(highs[v], highs[v]));
+		}
+	}
+
+	for (size_t i = 0; i < size; i++)
+	{
+		low[2 * i] = madd52lo(low[2 * i], digits[i], digits[i]);
+		high[2 * i] = madd52hi(high[2 * i], digits[i], digits[i]);
+	}
+}
+#endif
+
+/**
+ * @brief Turns summed columns into the 52 bit digits of the product.
+ *
+ * @param digits The product, columns digits. The columns of low and high are overwritten.
+ */
+constexpr void columns_to_digits(span_t digits, span_t low, const_span_t high) noexcept
+{
+	digits[0] = low[0];
+	for (size_t i = 1; i < digits.size(); i++)
+		digits[i] = low[i] + high[i - 1];
+
+	[[maybe_unused]] const digit_t carry = normalise(digits);
+	assert(carry == 0 && "The product does not fit in its columns");
+}
+
+/// Tile products
+
+/**
+ * The products of limbs convert tiles of at most this many limbs of each operand to radix 2^52 at a time.
+ */
+constexpr size_t tile = 32;
+
+/**
+ * @brief result += lhs * rhs through radix 2^52, for operands of at most tile limbs. Squares when rhs is empty.
+ *
+ * @pre result.size() >= lhs.size() + rhs.size(), and the sum fits in result.
+ */
+constexpr void addmul_tile(span_t result, const_span_t lhs, const_span_t rhs, [[maybe_unused]] Backend backend) noexcept
+{
+	constexpr size_t tile_digits = radix52_size(tile);
+	const bool square = rhs.empty();
+	const size_t lhs_size = radix52_size(lhs.size());
+	const size_t rhs_size = square ? lhs_size : radix52_size(rhs.size());
+	const size_t product_size = lhs.size() + (square ? lhs.size() : rhs.size());
+
+	// The conversions write every digit they read back, so only the columns, which the compiler cannot follow through
+	// the kernels, are initialised
+	digit_t a_digits[tile_digits];
+	digit_t padded[padded_size(tile_digits)];
+	digit_t b[tile_digits];
+	to_radix52(std::span(a_digits, lhs_size), lhs);
+	pad(std::span(padded, padded_size(lhs_size)), std::span(a_digits, lhs_size));
+	if (!square)
+		to_radix52(std::span(b, rhs_size), rhs);
+
+	digit_t low[columns_size(2 * tile_digits)] = {};
+	digit_t high[columns_size(2 * tile_digits)] = {};
+	const auto padded_span = std::span<const digit_t>(padded, padded_size(lhs_size));
+#ifdef SUURI_X86_DISPATCH
+	if (backend == Backend::ifma)
+		square ? sqr_columns_ifma(low, high, padded_span, lhs_size) : mul_columns_ifma(low, high, padded_span, lhs_size, std::span(b, rhs_size));
+	else
+#endif
+		square ? sqr_columns_emulated(low, high, padded_span, lhs_size) : mul_columns_emulated(low, high, padded_span, lhs_size, std::span(b, rhs_size));
+
+	digit_t digits[2 * tile_digits];
+	columns_to_digits(std::span(digits, lhs_size + rhs_size), low, high);
+
+	digit_t product[2 * tile];
+	from_radix52(std::span(product, product_size), std::span(digits, lhs_size + rhs_size));
+
+	digit_t carry = 0;
+	for (size_t i = 0; i < product_size; i++)
+		result[i] = add_with_carry(result[i], product[i], carry);
+	for (size_t i = product_size; carry != 0; i++)
+	{
+		assert(i < result.size() && "The product does not fit in the result");
+		result[i] = add_with_carry(result[i], 0, carry);
+	}
+}
+
+/**
+ * @brief result = lhs * rhs through radix 2^52, adding up the products of tiles of the operands.
+ *
+ * @pre rhs is not empty, result.size() == lhs.size() + rhs.size(), and result does not overlap the operands.
+ */
+constexpr void mul(span_t result, const_span_t lhs, const_span_t rhs, Backend backend = best_backend()) noexcept
+{
+	std::fill(result.begin(), result.end(), 0);
+	for (size_t i = 0; i < lhs.size(); i += tile)
+	{
+		const auto lhs_tile = lhs.subspan(i, std::min(tile, lhs.size() - i));
+		for (size_t j = 0; j < rhs.size(); j += tile)
+			addmul_tile(result.subspan(i + j), lhs_tile, rhs.subspan(j, std::min(tile, rhs.size() - j)), backend);
+	}
+}
+
+/**
+ * @brief result = lhs * lhs through radix 2^52. The tiles on the diagonal are squared, and those off it computed once and doubled.
+ *
+ * @pre lhs is not empty, result.size() == 2 * lhs.size(), and result does not overlap lhs.
+ */
+constexpr void sqr(span_t result, const_span_t lhs, Backend backend = best_backend()) noexcept
+{
+	std::fill(result.begin(), result.end(), 0);
+	for (size_t i = 0; i < lhs.size(); i += tile)
+	{
+		const auto lhs_tile = lhs.subspan(i, std::min(tile, lhs.size() - i));
+		for (size_t j = i + tile; j < lhs.size(); j += tile)
+			addmul_tile(result.subspan(i + j), lhs_tile, lhs.subspan(j, std::min(tile, lhs.size() - j)), backend);
+	}
+
+	// Doubling cannot overflow, since the cross products sum to less than half of the square
+	digit_t carry = 0;
+	for (auto &limb: result)
+	{
+		const digit_t doubled = (limb << 1) | carry;
+		carry = limb >> (digit_bits - 1);
+		limb = doubled;
+	}
+
+	for (size_t i = 0; i < lhs.size(); i += tile)
+		addmul_tile(result.subspan(2 * i), lhs.subspan(i, std::min(tile, lhs.size() - i)), {}, backend);
+}
+
+//// Montgomery multiplication
+
+/**
+ * The largest modulus montgomery_mul takes, in 52 bit digits. This covers 4096 bit RSA moduli, and keeps the whole
+ * accumulator in vector registers.
+ */
+constexpr size_t montgomery_max_digits = 80;
+
+/**
+ * @return The number of 52 bit digits R = 2^(52 size) of Montgomery multiplication spans for a modulus of this many bits.
+ * R is at least twice the modulus, so the unreduced products fit.
+ */
+constexpr size_t montgomery_size(size_t modulus_bits) noexcept
+{
+	return (modulus_bits + 1 + radix_bits - 1) / radix_bits;
+}
+
+/**
+ * @return -modulus^-1 modulo 2^52, for the least significant digit of an odd modulus.
+ */
+constexpr digit_t montgomery_inverse(digit_t modulus) noexcept
+{
+	assert(modulus % 2 == 1 && "Montgomery multiplication needs an odd modulus");
+
+	// Newton's iteration doubles the correct low bits, and every odd number is its own inverse modulo 8
+	digit_t inverse = modulus;
+	for (int i = 0; i < 5; i++)
+		inverse *= 2 - modulus * inverse;
+
+	return (0 - inverse) & radix_mask;
+}
+
+/**
+ * @brief Subtracts modulus from value if value is at least modulus. Both have the same number of 52 bit digits.
+ */
+constexpr void reduce_once(span_t value, const_span_t modulus) noexcept
+{
+	for (size_t i = value.size(); i-- > 0;)
+	{
+		if (value[i] != modulus[i])
+		{
+			if (value[i] < modulus[i])
+				return;
+			break;
+		}
+	}
+
+	digit_t borrow = 0;
+	for (size_t i = 0; i < value.size(); i++)
+	{
+		const digit_t difference = value[i] - modulus[i] - borrow;
+		borrow = difference >> (digit_bits - 1);
+		value[i] = difference & radix_mask;
+	}
+}
+
+/**
+ * @brief result = lhs * rhs / R modulo modulus, one lane at a time.
+ *
+ * The reduction is interleaved with the product. Every step adds lhs times a digit of rhs and the multiple of the
+ * modulus that clears the lowest digit, then drops that digit by moving every lane down by one, and only then adds
+ * the high halves of the products, which now line up with their columns.
+ *
+ * @param lhs,modulus Padded with zeros to a multiple of eight digits.
+ * @param result The unreduced result, below twice the modulus, as many digits as lhs and not normalised.
+ * @param carry The carry out of the dropped digits, which still has to be added to the lowest digit of result.
+ */
+constexpr void montgomery_steps_emulated(span_t result, digit_t &carry, const_span_t lhs, const_span_t rhs, const_span_t modulus,
+										 digit_t inverse) noexcept
+{
+	std::fill(result.begin(), result.end(), 0);
+	carry = 0;
+	for (const digit_t digit: rhs)
+	{
+		for (size_t lane = 0; lane < result.size(); lane++)
+			result[lane] = madd52lo(result[lane], lhs[lane], digit);
+
+		const digit_t lowest = result[0] + carry;
+		const digit_t q = lowest * inverse & radix_mask;
+		carry = (lowest + (q * modulus[0] & radix_mask)) >> radix_bits;
+		for (size_t lane = 1; lane < result.size(); lane++)
+			result[lane] = madd52lo(result[lane], modulus[lane], q);
+
+		std::shift_left(result.begin(), result.end(), 1);
+		result.back() = 0;
+
+		for (size_t lane = 0; lane < result.size(); lane++)
+		{
+			result[lane] = madd52hi(result[lane], lhs[lane], digit);
+			result[lane] = madd52hi(result[lane], modulus[lane], q);
+		}
+	}
+}
+
+#ifdef SUURI_X86_DISPATCH
+/**
+ * @brief montgomery_steps_emulated with AVX-512 IFMA, holding the accumulator in Vectors registers of eight lanes.
+ */
+template<size_t Vectors>
+__attribute__((target("avx512f,avx512ifma"))) inline void montgomery_steps_ifma(span_t result, digit_t &carry, const_span_t lhs, const_span_t rhs,
+																				const_span_t modulus, digit_t inverse) noexcept
+{
+	__m512i a[Vectors];
+	__m512i m[Vectors];
+	__m512i acc[Vectors];
+	for (size_t v = 0; v < Vectors; v++)
+	{
+		a[v] = _mm512_loadu_si512(lhs.data() + 8 * v);
+		m[v] = _mm512_loadu_si512(modulus.data() + 8 * v);
+		acc[v] = _mm512_setzero_si512();
+	}
+
+	const digit_t lowest_modulus = modulus[0];
+	digit_t running = 0;
+	for (const digit_t digit: rhs)
+	{
+		const __m512i b = _mm512_set1_epi64(static_cast<int64_t>(digit));
+		for (size_t v = 0; v < Vectors; v++)
+			acc[v] = _mm512_madd52lo_epu64(acc[v], a[v], b);
+
+		const digit_t lowest = static_cast<digit_t>(_mm_cvtsi128_si64(_mm512_castsi512_si128(acc[0]))) + running;
+		const digit_t q = lowest * inverse & radix_mask;
+		running = (lowest + (q * lowest_modulus & radix_mask)) >> radix_bits;
+
+		// The lowest lane is dropped below, so only its carry is kept
+		const __m512i qs = _mm512_set1_epi64(static_cast<int64_t>(q));
+		for (size_t v = 0; v < Vectors; v++)
+			acc[v] = _mm512_madd52lo_epu64(acc[v], m[v], qs);
+
+		for (size_t v = 0; v + 1 < Vectors; v++)
+			acc[v] = _mm512_alignr_epi64(acc[v + 1], acc[v], 1);
+		acc[Vectors - 1] = _mm512_alignr_epi64(_mm512_setzero_si512(), acc[Vectors - 1], 1);
+
+		for (size_t v = 0; v < Vectors; v++)
+		{
+			acc[v] = _mm512_madd52hi_epu64(acc[v], a[v], b);
+			acc[v] = _mm512_madd52hi_epu64(acc[v], m[v], qs);
+		}
+	}
+
+	for (size_t v = 0; v < Vectors; v++)
+		_mm512_storeu_si512(result.data() + 8 * v, acc[v]);
+	carry = running;
+}
+
+/**
+ * @brief Runs montgomery_steps_ifma with as many registers as the padded size needs.
+ */
+template<size_t Vectors = 1>
+inline void montgomery_steps_ifma_dispatch(span_t result, digit_t &carry, const_span_t lhs, const_span_t rhs, const_span_t modulus,
+										   digit_t inverse) noexcept
+{
+	if constexpr (8 * Vectors < montgomery_max_digits)
+	{
+		if (result.size() > 8 * Vectors)
+		{
+			montgomery_steps_ifma_dispatch<Vectors + 1>(result, carry, lhs, rhs, modulus, inverse);
+			return;
+		}
+	}
+
+	montgomery_steps_ifma<Vectors>(result, carry, lhs, rhs, modulus, inverse);
+}
+#endif
+
+/**
+ * @brief result = lhs * rhs / R modulo modulus, where R = 2^(52 modulus.size()).
+ *
+ * @pre All spans have montgomery_size(bits of the modulus) <= montgomery_max_digits normalised digits, the modulus is
+ * odd, and lhs and rhs are below it. inverse is montgomery_inverse(modulus[0]). result may be the same span as an operand.
+ */
+constexpr void montgomery_mul(span_t result, const_span_t lhs, const_span_t rhs, const_span_t modulus, digit_t inverse,
+							  [[maybe_unused]] Backend backend = best_backend()) noexcept
+{
+	assert(modulus.size() <= montgomery_max_digits && "The modulus is too large for the Montgomery kernels");
+
+	const size_t size = modulus.size();
+	const size_t padded = (size + 7) / 8 * 8;
+
+	digit_t a[montgomery_max_digits] = {};
+	digit_t m[montgomery_max_digits] = {};
+	digit_t b[montgomery_max_digits] = {};
+	std::copy(lhs.begin(), lhs.end(), a);
+	std::copy(modulus.begin(), modulus.end(), m);
+	std::copy(rhs.begin(), rhs.end(), b);
+
+	digit_t accumulator[montgomery_max_digits] = {};
+	digit_t carry = 0;
+	const auto acc = std::span(accumulator, padded);
+#ifdef SUURI_X86_DISPATCH
+	if (backend == Backend::ifma)
+		montgomery_steps_ifma_dispatch(acc, carry, std::span(a, padded), std::span(b, size), std::span(m, padded), inverse);
+	else
+#endif
+		montgomery_steps_emulated(acc, carry, std::span(a, padded), std::span(b, size), std::span(m, padded), inverse);
+
+	accumulator[0] += carry;
+	[[maybe_unused]] const digit_t overflow = normalise(acc);
+	assert(overflow == 0 && "The unreduced product is below twice the modulus, which fits in R");
+
+	std::copy_n(accumulator, size, result.begin());
+	reduce_once(result, modulus);
+}
+
+/**
+ * @brief result = R^2 modulo modulus, which one montgomery_mul turns a number into Montgomery form with.
+ *
+ * Starts from the highest power of two below the modulus and doubles it with a conditional subtraction per bit, so no
+ * division is needed.
+ *
+ * @pre The preconditions of montgomery_mul on the modulus, which is above 1. result.size() == modulus.size().
+ */
+constexpr void montgomery_r_squared(span_t result, const_span_t modulus) noexcept
+{
+	const size_t size = modulus.size();
+	size_t top = size * radix_bits - 1;
+	while ((modulus[top / radix_bits] >> (top % radix_bits) & 1) == 0)
+		top--;
+
+	std::fill(result.begin(), result.end(), 0);
+	result[top / radix_bits] = digit_t(1) << (top % radix_bits);
+	for (size_t bit = top; bit < 2 * size * radix_bits; bit++)
+	{
+		// The doubled value is below twice the modulus, which fits in R
+		digit_t carry = 0;
+		for (auto &digit: result)
+		{
+			digit = 2 * digit + carry;
+			carry = digit >> radix_bits;
+			digit &= radix_mask;
+		}
+		reduce_once(result, modulus);
+	}
+}
+
+/**
+ * The number of exponent bits montgomery_pow takes at a time, which multiplies once per window from a table of 2^bits powers.
+ */
+constexpr unsigned montgomery_window_bits = 4;
+
+/**
+ * @brief result = base^exponent modulo modulus, with fixed window exponentiation on Montgomery multiplication.
+ *
+ * @param base Below the modulus, in normalised 52 bit digits.
+ * @param exponent The limbs of the exponent.
+ * @pre The preconditions of montgomery_mul on the modulus, which is above 1. result, base and modulus have the same size.
+ */
+constexpr void montgomery_pow(span_t result, const_span_t base, const_span_t exponent, const_span_t modulus,
+							  Backend backend = best_backend()) noexcept
+{
+	constexpr size_t powers = size_t(1) << montgomery_window_bits;
+	const size_t size = modulus.size();
+	const digit_t inverse = montgomery_inverse(modulus[0]);
+
+	digit_t one_digits[montgomery_max_digits] = {1};
+	digit_t r_squared[montgomery_max_digits];
+	digit_t table[powers][montgomery_max_digits];
+	const auto one = std::span<const digit_t>(one_digits, size);
+	auto power = [&](size_t i) { return std::span(table[i], size); };
+
+	// Powers 0 to 15 of base in Montgomery form, where R modulo modulus stands for 1
+	montgomery_r_squared(std::span(r_squared, size), modulus);
+	montgomery_mul(power(0), std::span(r_squared, size), one, modulus, inverse, backend);
+	montgomery_mul(power(1), base, std::span(r_squared, size), modulus, inverse, backend);
+	for (size_t i = 2; i < powers; i++)
+		montgomery_mul(power(i), power(i - 1), power(1), modulus, inverse, backend);
+
+	std::copy_n(table[0], size, result.begin());
+	const size_t bits = exponent.size() * digit_bits;
+	bool leading = true;
+	for (size_t window_end = (bits + montgomery_window_bits - 1) / montgomery_window_bits * montgomery_window_bits; window_end > 0;
+		 window_end -= montgomery_window_bits)
+	{
+		size_t index = 0;
+		for (size_t bit = window_end; bit-- > window_end - montgomery_window_bits;)
+			index = 2 * index + (bit < bits ? exponent[bit / digit_bits] >> (bit % digit_bits) & 1 : 0);
+
+		// Squaring the leading 1 changes nothing, so the first window with bits set starts from its power
+		if (leading)
+		{
+			if (index != 0)
+				std::copy_n(table[index], size, result.begin());
+			leading = index == 0;
+			continue;
+		}
+
+		for (unsigned i = 0; i < montgomery_window_bits; i++)
+			montgomery_mul(result, result, result, modulus, inverse, backend);
+		if (index != 0)
+			montgomery_mul(result, result, power(index), modulus, inverse, backend);
+	}
+
+	montgomery_mul(result, result, one, modulus, inverse, backend);
+}
+
+}// namespace suuri::ifma
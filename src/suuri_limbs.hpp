@@ -0,0 +1,2836 @@
+#pragma once
+
+#include "suuri_core.hpp"
+#include "suuri_cpu.hpp"
+#include "suuri_fft.hpp"
+#include "suuri_ntt.hpp"
+#include "suuri_thresholds.hpp"
+
+#include <algorithm>
+#include <assert.h>
+#include <bit>
+#include <compare>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Low level kernels working on spans of limbs (digits), least significant first.
+ *
+ * None of them allocate, track signs or normalise their results, so they can run on any storage the caller owns.
+ * Unless stated otherwise a result may be the same span as an input, but must not partially overlap one.
+ */
+namespace suuri::limbs
+{
+
+typedef std::span<digit_t> span_t;
+typedef std::span<const digit_t> const_span_t;
+
+/**
+ * Below this number of limbs in the shorter operand, mul and mul_karatsuba use mul_basecase.
+ */
+SUURI_THRESHOLD(karatsuba_threshold, SUURI_KARATSUBA_THRESHOLD);
+/**
+ * From this number of limbs in the shorter operand, mul_basecase uses the vectorised kernels if the CPU has AVX2 or AVX-512.
+ */
+SUURI_THRESHOLD(simd_basecase_threshold, SUURI_SIMD_BASECASE_THRESHOLD);
+/**
+ * From this number of limbs in the shorter operand, mul uses Toom-3 instead of Karatsuba.
+ */
+SUURI_THRESHOLD(toom3_threshold, SUURI_TOOM3_THRESHOLD);
+/**
+ * From this number of limbs in the shorter operand, mul uses Toom-4 instead of Toom-3.
+ */
+SUURI_THRESHOLD(toom4_threshold, SUURI_TOOM4_THRESHOLD);
+/**
+ * From this number of limbs in the shorter operand, mul uses Toom-6.5 instead of Toom-4.
+ */
+SUURI_THRESHOLD(toom6h_threshold, SUURI_TOOM6H_THRESHOLD);
+/**
+ * From this number of limbs in the shorter operand, mul uses Toom-8.5 instead of Toom-6.5.
+ */
+SUURI_THRESHOLD(toom8h_threshold, SUURI_TOOM8H_THRESHOLD);
+/**
+ * From this number of limbs in the shorter operand, mul uses the floating point FFT, as long as the CPU has AVX2 and the
+ * error bound holds for the operand sizes. The portable FFT loses to Toom-Cook and the number theoretic transforms.
+ */
+SUURI_THRESHOLD(fft_threshold, SUURI_FFT_THRESHOLD);
+/**
+ * From this number of limbs in the shorter operand, mul uses number theoretic transforms instead of Toom-Cook.
+ */
+SUURI_THRESHOLD(ntt_threshold, SUURI_NTT_THRESHOLD);
+
+// Squaring does less work than multiplication at the bottom of the recursion, so each algorithm takes over from the
+// previous one at a different size than for multiplication.
+
+/**
+ * From this number of limbs, sqr and sqr_karatsuba use Karatsuba instead of sqr_basecase.
+ */
+SUURI_THRESHOLD(sqr_karatsuba_threshold, SUURI_SQR_KARATSUBA_THRESHOLD);
+/**
+ * From this number of limbs, sqr uses Toom-3 instead of Karatsuba.
+ */
+SUURI_THRESHOLD(sqr_toom3_threshold, SUURI_SQR_TOOM3_THRESHOLD);
+/**
+ * From this number of limbs, sqr uses Toom-4 instead of Toom-3.
+ */
+SUURI_THRESHOLD(sqr_toom4_threshold, SUURI_SQR_TOOM4_THRESHOLD);
+/**
+ * From this number of limbs, sqr uses the floating point FFT under the same conditions as mul.
+ */
+SUURI_THRESHOLD(sqr_fft_threshold, SUURI_SQR_FFT_THRESHOLD);
+
+/**
+ * From this number of limbs, mullo splits the product as Mulders' short product instead of using mullo_basecase.
+ */
+SUURI_THRESHOLD(mullo_dc_threshold, SUURI_MULLO_DC_THRESHOLD);
+/**
+ * From this number of limbs, mulhi splits the product as Mulders' short product instead of using mulhi_basecase.
+ */
+SUURI_THRESHOLD(mulhi_dc_threshold, SUURI_MULHI_DC_THRESHOLD);
+/**
+ * From this number of limbs, mullo and mulhi take half of the full product. The transforms cost nearly the same for a
+ * short product as for a full one, so splitting stops paying off.
+ */
+SUURI_THRESHOLD(short_product_full_threshold, SUURI_SHORT_PRODUCT_FULL_THRESHOLD);
+/**
+ * From this number of limbs in the shorter of rhs and the result, mulmid uses the transposed Karatsuba algorithm instead
+ * of mulmid_basecase.
+ */
+SUURI_THRESHOLD(mulmid_karatsuba_threshold, SUURI_MULMID_KARATSUBA_THRESHOLD);
+
+/**
+ * From this number of quotient limbs in a block, divrem divides by divide and conquer instead of divrem_basecase.
+ */
+SUURI_THRESHOLD(div_dc_threshold, SUURI_DIV_DC_THRESHOLD);
+
+//// Comparison
+
+/**
+ * @brief Compares two limb spans by value. The spans may have different sizes.
+ */
+constexpr std::strong_ordering cmp(const_span_t lhs, const_span_t rhs) noexcept
+{
+	// Any limbs above the size of the other span have to be zero for the values to compare by their common limbs
+	for (size_t i = rhs.size(); i < lhs.size(); i++)
+		if (lhs[i] != 0)
+			return std::strong_ordering::greater;
+	for (size_t i = lhs.size(); i < rhs.size(); i++)
+		if (rhs[i] != 0)
+			return std::strong_ordering::less;
+
+	for (size_t i = std::min(lhs.size(), rhs.size()); i-- > 0;)
+		if (lhs[i] != rhs[i])
+			return lhs[i] < rhs[i] ? std::strong_ordering::less : std::strong_ordering::greater;
+
+	return std::strong_ordering::equal;
+}
+
+//// Addition and subtraction
+
+/**
+ * @brief result = lhs + rhs.
+ *
+ * @pre All three spans have the same size.
+ * @return The carry out of the most significant limb.
+ */
+constexpr digit_t add_n(span_t result, const_span_t lhs, const_span_t rhs) noexcept
+{
+	digit_t carry = 0;
+	for (size_t i = 0; i < rhs.size(); i++)
+		result[i] = add_with_carry(lhs[i], rhs[i], carry);
+
+	return carry;
+}
+
+/**
+ * @brief result = lhs + digit.
+ *
+ * @pre result.size() == lhs.size().
+ * @return The carry out of the most significant limb.
+ */
+constexpr digit_t add_1(span_t result, const_span_t lhs, digit_t digit) noexcept
+{
+	digit_t carry = digit;
+	size_t i = 0;
+	for (; carry && i < lhs.size(); i++)
+		result[i] = add_with_carry(lhs[i], 0, carry);
+
+	if (result.data() != lhs.data())
+		std::copy(lhs.begin() + static_cast<ptrdiff_t>(i), lhs.end(), result.begin() + static_cast<ptrdiff_t>(i));
+
+	return carry;
+}
+
+/**
+ * @brief result = lhs + rhs.
+ *
+ * @pre lhs.size() >= rhs.size() and result.size() == lhs.size().
+ * @return The carry out of the most significant limb.
+ */
+constexpr digit_t add(span_t result, const_span_t lhs, const_span_t rhs) noexcept
+{
+	const size_t n = rhs.size();
+	const digit_t carry = add_n(result.first(n), lhs.first(n), rhs);
+
+	return add_1(result.subspan(n), lhs.subspan(n), carry);
+}
+
+/**
+ * @brief result = lhs - rhs.
+ *
+ * @pre All three spans have the same size.
+ * @return The borrow out of the most significant limb.
+ */
+constexpr digit_t sub_n(span_t result, const_span_t lhs, const_span_t rhs) noexcept
+{
+	digit_t borrow = 0;
+	for (size_t i = 0; i < rhs.size(); i++)
+		result[i] = subtract_with_borrow(lhs[i], rhs[i], borrow);
+
+	return borrow;
+}
+
+/**
+ * @brief result = lhs - digit.
+ *
+ * @pre result.size() == lhs.size().
+ * @return The borrow out of the most significant limb.
+ */
+constexpr digit_t sub_1(span_t result, const_span_t lhs, digit_t digit) noexcept
+{
+	digit_t borrow = digit;
+	size_t i = 0;
+	for (; borrow && i < lhs.size(); i++)
+		result[i] = subtract_with_borrow(lhs[i], 0, borrow);
+
+	if (result.data() != lhs.data())
+		std::copy(lhs.begin() + static_cast<ptrdiff_t>(i), lhs.end(), result.begin() + static_cast<ptrdiff_t>(i));
+
+	return borrow;
+}
+
+/**
+ * @brief result = lhs - rhs.
+ *
+ * @pre lhs.size() >= rhs.size() and result.size() == lhs.size().
+ * @return The borrow out of the most significant limb.
+ */
+constexpr digit_t sub(span_t result, const_span_t lhs, const_span_t rhs) noexcept
+{
+	const size_t n = rhs.size();
+	const digit_t borrow = sub_n(result.first(n), lhs.first(n), rhs);
+
+	return sub_1(result.subspan(n), lhs.subspan(n), borrow);
+}
+
+/**
+ * @brief result = |lhs - rhs|.
+ *
+ * @pre lhs.size() >= rhs.size() and result.size() == lhs.size().
+ * @return True if rhs was greater than lhs.
+ */
+constexpr bool sub_abs(span_t result, const_span_t lhs, const_span_t rhs) noexcept
+{
+	if (cmp(lhs, rhs) != std::strong_ordering::less)
+	{
+		sub(result, lhs, rhs);
+		return false;
+	}
+
+	// rhs is the greater value, so the limbs of lhs above the size of rhs are all zero
+	sub_n(result.first(rhs.size()), rhs, lhs.first(rhs.size()));
+	std::fill(result.begin() + static_cast<ptrdiff_t>(rhs.size()), result.end(), 0);
+	return true;
+}
+
+/**
+ * @brief result = -lhs modulo B^n, the two's complement of lhs.
+ *
+ * @pre result.size() == lhs.size().
+ * @return The borrow, which is 1 unless lhs is zero.
+ */
+constexpr digit_t neg(span_t result, const_span_t lhs) noexcept
+{
+	digit_t borrow = 0;
+	for (size_t i = 0; i < lhs.size(); i++)
+		result[i] = subtract_with_borrow(0, lhs[i], borrow);
+
+	return borrow;
+}
+
+//// Shifts
+
+/**
+ * @brief result = lhs << count, within the size of the span.
+ *
+ * @pre 0 < count < digit_bits, and result.size() == lhs.size(). result may start at or above lhs.
+ * @return The bits shifted out of the most significant limb, in the low bits.
+ */
+constexpr digit_t lshift(span_t result, const_span_t lhs, unsigned count) noexcept
+{
+	assert(count > 0 && count < digit_bits && "Shift count has to be within a limb");
+
+	const size_t n = lhs.size();
+	const digit_t out = lhs[n - 1] >> (digit_bits - count);
+	for (size_t i = n - 1; i > 0; i--)
+		result[i] = (lhs[i] << count) | (lhs[i - 1] >> (digit_bits - count));
+	result[0] = lhs[0] << count;
+
+	return out;
+}
+
+/**
+ * @brief result = lhs >> count.
+ *
+ * @pre 0 < count < digit_bits, and result.size() == lhs.size(). result may start at or below lhs.
+ * @return The bits shifted out of the least significant limb, in the high bits.
+ */
+constexpr digit_t rshift(span_t result, const_span_t lhs, unsigned count) noexcept
+{
+	assert(count > 0 && count < digit_bits && "Shift count has to be within a limb");
+
+	const size_t n = lhs.size();
+	const digit_t out = lhs[0] << (digit_bits - count);
+	for (size_t i = 0; i + 1 < n; i++)
+		result[i] = (lhs[i] >> count) | (lhs[i + 1] << (digit_bits - count));
+	result[n - 1] = lhs[n - 1] >> count;
+
+	return out;
+}
+
+//// Multiplication by a single limb
+
+/**
+ * @brief result = lhs * digit.
+ *
+ * @pre result.size() == lhs.size().
+ * @return The most significant limb of the product, which does not fit in result.
+ */
+constexpr digit_t mul_1(span_t result, const_span_t lhs, digit_t digit) noexcept
+{
+	digit_t carry = 0;
+	for (size_t i = 0; i < lhs.size(); i++)
+		result[i] = multiply_add_digits(lhs[i], digit, 0, carry);
+
+	return carry;
+}
+
+/**
+ * @brief result += lhs * digit.
+ *
+ * @pre result.size() == lhs.size().
+ * @return The limb carried out of result.
+ */
+constexpr digit_t addmul_1(span_t result, const_span_t lhs, digit_t digit) noexcept
+{
+	digit_t carry = 0;
+	for (size_t i = 0; i < lhs.size(); i++)
+		result[i] = multiply_add_digits(lhs[i], digit, result[i], carry);
+
+	return carry;
+}
+
+/**
+ * @brief result -= lhs * digit.
+ *
+ * @pre result.size() == lhs.size().
+ * @return The limb borrowed out of result.
+ */
+constexpr digit_t submul_1(span_t result, const_span_t lhs, digit_t digit) noexcept
+{
+	digit_t high = 0;
+	for (size_t i = 0; i < lhs.size(); i++)
+	{
+		// lhs * digit + high is at most B^2 - B, so adding the borrow to the high limb cannot overflow
+		const digit_t low = multiply_add_digits(lhs[i], digit, 0, high);
+		digit_t borrow = 0;
+		result[i] = subtract_with_borrow(result[i], low, borrow);
+		high += borrow;
+	}
+
+	return high;
+}
+
+//// Vectorised schoolbook multiplication
+
+// The vectorised kernels multiply 32 bit halves of limbs into 64 bit lanes, which is what AVX2 and AVX-512 have
+// multipliers for. Each lane sums one column of the product, so no carry moves between lanes until the tile is done.
+
+/**
+ * The vectorised kernels multiply tiles of at most this many limbs of each operand at a time.
+ */
+constexpr size_t simd_tile = 32;
+
+/**
+ * @brief Adds the columns of a tile product to result, carrying into the limbs above the tile as far as needed.
+ *
+ * @param low The sums of the low halves of the 32 bit products in every column, 2 * size columns.
+ * @param high The sums of the high halves of the 32 bit products, which belong one column further up.
+ * @param size The number of limbs of the tile product.
+ */
+inline void add_columns(span_t result, const digit_t *low, const digit_t *high, size_t size) noexcept
+{
+	// The columns hold sums of at most 2 * simd_tile halves, so none of the additions below can overflow
+	digit_t carry = 0;
+	digit_t previous_high = 0;
+	for (size_t i = 0; i < size; i++)
+	{
+		const digit_t lower = carry + low[2 * i] + previous_high + (result[i] & 0xffffffff);
+		const digit_t upper = (lower >> 32) + low[2 * i + 1] + high[2 * i] + (result[i] >> 32);
+		previous_high = high[2 * i + 1];
+		carry = upper >> 32;
+		result[i] = (lower & 0xffffffff) | (upper << 32);
+	}
+
+	carry += previous_high;
+	for (size_t i = size; carry != 0; i++)
+	{
+		assert(i < result.size() && "The product does not fit in the result");
+		result[i] += carry;
+		carry = result[i] < carry;
+	}
+}
+
+#ifdef SUURI_X86_DISPATCH
+/**
+ * @brief result += lhs * rhs with AVX2, for operands of at most simd_tile limbs.
+ *
+ * Works on windows of eight columns. Every 32 bit half of rhs is broadcast and multiplied with the halves of lhs that
+ * land in the window, which are loaded from a zero padded copy of lhs at the right offset. The low halves of the sums
+ * are recovered as the sum of the full products minus the high halves, so the products are never masked.
+ *
+ * @pre result.size() >= lhs.size() + rhs.size(), and the product fits in result.
+ */
+__attribute__((target("avx2"))) inline void addmul_tile_avx2(span_t result, const_span_t lhs, const_span_t rhs) noexcept
+{
+	constexpr size_t window = 8;
+	const size_t a_size = 2 * lhs.size();
+	const size_t b_size = 2 * rhs.size();
+
+	alignas(32) digit_t a[window + 2 * simd_tile + window];
+	uint32_t b[2 * simd_tile];
+	std::fill_n(a, window, 0);
+	std::fill_n(a + window + a_size, window, 0);
+	for (size_t i = 0; i < lhs.size(); i++)
+	{
+		a[window + 2 * i] = lhs[i] & 0xffffffff;
+		a[window + 2 * i + 1] = lhs[i] >> 32;
+	}
+	for (size_t i = 0; i < rhs.size(); i++)
+	{
+		b[2 * i] = static_cast<uint32_t>(rhs[i]);
+		b[2 * i + 1] = static_cast<uint32_t>(rhs[i] >> 32);
+	}
+
+	alignas(32) digit_t low[4 * simd_tile + window];
+	alignas(32) digit_t high[4 * simd_tile + window];
+	for (size_t column = 0; column < a_size + b_size; column += window)
+	{
+		__m256i sums[2] = {_mm256_setzero_si256(), _mm256_setzero_si256()};
+		__m256i highs[2] = {_mm256_setzero_si256(), _mm256_setzero_si256()};
+
+		// Only the halves of rhs with a product in the window
+		const size_t end = std::min(b_size, column + window);
+		for (size_t j = column + 1 > a_size ? column + 1 - a_size : 0; j < end; j++)
+		{
+			const __m256i digit = _mm256_set1_epi32(static_cast<int>(b[j]));
+			const digit_t *lanes = a + window + column - j;
+			for (size_t v = 0; v < 2; v++)
+			{
+				const __m256i product = _mm256_mul_epu32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(lanes + 4 * v)), digit);
+				sums[v] = _mm256_add_epi64(sums[v], product);
+				highs[v] = _mm256_add_epi64(highs[v], _mm256_srli_epi64(product, 32));
+			}
+		}
+
+		for (size_t v = 0; v < 2; v++)
+		{
+			_mm256_store_si256(reinterpret_cast<__m256i *>(low + column + 4 * v), _mm256_sub_epi64(sums[v], _mm256_slli_epi64(highs[v], 32)));
+			_mm256_store_si256(reinterpret_cast<__m256i *>(high + column + 4 * v), highs[v]);
+		}
+	}
+
+	add_columns(result, low, high, lhs.size() + rhs.size());
+}
+
+/**
+ * @brief addmul_tile_avx2 with AVX-512, on windows of sixteen columns.
+ */
+__attribute__((target("avx512f"))) inline void addmul_tile_avx512(span_t result, const_span_t lhs, const_span_t rhs) noexcept
+{
+	constexpr size_t window = 16;
+	const size_t a_size = 2 * lhs.size();
+	const size_t b_size = 2 * rhs.size();
+
+	alignas(64) digit_t a[window + 2 * simd_tile + window];
+	uint32_t b[2 * simd_tile];
+	std::fill_n(a, window, 0);
+	std::fill_n(a + window + a_size, window, 0);
+	for (size_t i = 0; i < lhs.size(); i++)
+	{
+		a[window + 2 * i] = lhs[i] & 0xffffffff;
+		a[window + 2 * i + 1] = lhs[i] >> 32;
+	}
+	for (size_t i = 0; i < rhs.size(); i++)
+	{
+		b[2 * i] = static_cast<uint32_t>(rhs[i]);
+		b[2 * i + 1] = static_cast<uint32_t>(rhs[i] >> 32);
+	}
+
+	alignas(64) digit_t low[4 * simd_tile + window];
+	alignas(64) digit_t high[4 * simd_tile + window];
+	for (size_t column = 0; column < a_size + b_size; column += window)
+	{
+		__m512i sums[2] = {_mm512_setzero_si512(), _mm512_setzero_si512()};
+		__m512i highs[2] = {_mm512_setzero_si512(), _mm512_setzero_si512()};
+
+		const size_t end = std::min(b_size, column + window);
+		for (size_t j = column + 1 > a_size ? column + 1 - a_size : 0; j < end; j++)
+		{
+			const __m512i digit = _mm512_set1_epi32(static_cast<int>(b[j]));
+			const digit_t *lanes = a + window + column - j;
+			for (size_t v = 0; v < 2; v++)
+			{
+				const __m512i product = _mm512_mul_epu32(_mm512_loadu_si512(lanes + 8 * v), digit);
+				sums[v] = _mm512_add_epi64(sums[v], product);
+				highs[v] = _mm512_add_epi64(highs[v], _mm512_srli_epi64(product, 32));
+			}
+		}
+
+		for (size_t v = 0; v < 2; v++)
+		{
+			_mm512_store_si512(low + column + 8 * v, _mm512_sub_epi64(sums[v], _mm512_slli_epi64(highs[v], 32)));
+			_mm512_store_si512(high + column + 8 * v, highs[v]);
+		}
+	}
+
+	add_columns(result, low, high, lhs.size() + rhs.size());
+}
+
+/**
+ * @brief result = lhs * rhs, adding up the products of tiles of the operands with the given tile kernel.
+ *
+ * @pre The preconditions of mul_basecase.
+ */
+template<void (*AddmulTile)(span_t, const_span_t, const_span_t) noexcept>
+inline void mul_basecase_tiled(span_t result, const_span_t lhs, const_span_t rhs) noexcept
+{
+	std::fill(result.begin(), result.end(), 0);
+	for (size_t i = 0; i < lhs.size(); i += simd_tile)
+	{
+		const auto lhs_tile = lhs.subspan(i, std::min(simd_tile, lhs.size() - i));
+		for (size_t j = 0; j < rhs.size(); j += simd_tile)
+			AddmulTile(result.subspan(i + j), lhs_tile, rhs.subspan(j, std::min(simd_tile, rhs.size() - j)));
+	}
+}
+#endif
+
+//// Multiplication
+
+/**
+ * @brief result = lhs * rhs using schoolbook multiplication.
+ *
+ * From simd_basecase_threshold limbs the products are vectorised with AVX-512 or AVX2, whichever the CPU has.
+ *
+ * @pre rhs is not empty, result.size() == lhs.size() + rhs.size(), and result does not overlap the operands.
+ */
+constexpr void mul_basecase(span_t result, const_span_t lhs, const_span_t rhs) noexcept
+{
+#ifdef SUURI_X86_DISPATCH
+	if (!std::is_constant_evaluated() && std::min(lhs.size(), rhs.size()) >= simd_basecase_threshold)
+	{
+		if (cpu::has_avx512())
+		{
+			mul_basecase_tiled<addmul_tile_avx512>(result, lhs, rhs);
+			return;
+		}
+		if (cpu::has_avx2())
+		{
+			mul_basecase_tiled<addmul_tile_avx2>(result, lhs, rhs);
+			return;
+		}
+	}
+#endif
+
+	const size_t n = rhs.size();
+	result[n] = mul_1(result.first(n), rhs, lhs[0]);
+
+	for (size_t i = 1; i < lhs.size(); i++)
+		result[i + n] = addmul_1(result.subspan(i, n), rhs, lhs[i]);
+}
+
+/**
+ * @brief result = lhs * lhs using schoolbook squaring.
+ *
+ * Every cross product lhs[i] * lhs[j] with i < j is computed once and doubled, which saves almost half the multiplications of mul_basecase.
+ *
+ * @pre lhs is not empty, result.size() == 2 * lhs.size(), and result does not overlap lhs.
+ */
+constexpr void sqr_basecase(span_t result, const_span_t lhs) noexcept
+{
+	const size_t n = lhs.size();
+	std::fill(result.begin(), result.end(), 0);
+
+	// Row i adds lhs[i] * lhs[i + 1 ..] at position 2i + 1, and its carry lands on a limb no earlier row has reached
+	for (size_t i = 0; i + 1 < n; i++)
+		result[i + n] = addmul_1(result.subspan(2 * i + 1, n - i - 1), lhs.subspan(i + 1), lhs[i]);
+
+	// Doubling cannot overflow, since the cross products sum to less than half of the square
+	lshift(result, result, 1);
+
+	digit_t carry = 0;
+	for (size_t i = 0; i < n; i++)
+	{
+		digit_t high;
+		const digit_t low = multiply_digits(lhs[i], lhs[i], high);
+		result[2 * i] = add_with_carry(result[2 * i], low, carry);
+		result[2 * i + 1] = add_with_carry(result[2 * i + 1], high, carry);
+	}
+}
+
+/**
+ * @brief Number of scratch limbs needed by mul_karatsuba.
+ *
+ * @param n The size of the longer operand.
+ */
+constexpr size_t karatsuba_scratch_size(size_t n) noexcept
+{
+	if (n < karatsuba_threshold)
+		return 0;
+
+	// The differences and their product take 4 * half limbs while recursing, and z_1 takes 2 * half + 1 limbs afterwards
+	const size_t half = (n + 1) / 2;
+	return std::max(4 * half + karatsuba_scratch_size(half), 6 * half + 1);
+}
+
+/**
+ * @brief result = lhs * rhs using Karatsuba's algorithm.
+ *
+ * @pre Neither operand is empty, result.size() == lhs.size() + rhs.size(), and result does not overlap the operands.
+ * @param scratch Temporary space of at least karatsuba_scratch_size(max(lhs.size(), rhs.size())) limbs.
+ */
+constexpr void mul_karatsuba(span_t result, const_span_t lhs_in, const_span_t rhs_in, span_t scratch) noexcept
+{
+	auto lhs = lhs_in;
+	auto rhs = rhs_in;
+
+	// Arrange it so that lhs is the longer operand
+	if (lhs.size() < rhs.size())
+		std::swap(lhs, rhs);
+
+	if (rhs.size() < karatsuba_threshold)
+	{
+		mul_basecase(result, lhs, rhs);
+		return;
+	}
+
+	const size_t half = (lhs.size() + 1) / 2;
+	const auto x_0 = lhs.first(half);
+	const auto x_1 = lhs.subspan(half);
+
+	if (rhs.size() <= half)
+	{
+		// rhs has no upper half, so multiply it with each half of lhs and add the two products
+		mul_karatsuba(result.first(half + rhs.size()), x_0, rhs, scratch);
+
+		auto upper = scratch.first(x_1.size() + rhs.size());
+		mul_karatsuba(upper, x_1, rhs, scratch.subspan(2 * half));
+
+		auto result_upper = result.subspan(half);
+		std::fill(result_upper.begin() + static_cast<ptrdiff_t>(rhs.size()), result_upper.end(), 0);
+		add(result_upper, result_upper, upper);
+		return;
+	}
+
+	const auto y_0 = rhs.first(half);
+	const auto y_1 = rhs.subspan(half);
+
+	// z_0 and z_2 are written directly into their final place in the result
+	mul_karatsuba(result.first(2 * half), x_0, y_0, scratch);
+	mul_karatsuba(result.subspan(2 * half), x_1, y_1, scratch);
+
+	// (x_0 - x_1)(y_0 - y_1) = z_0 + z_2 - z_1. Using differences rather than sums keeps the operands at half limbs.
+	auto x_diff = scratch.first(half);
+	auto y_diff = scratch.subspan(half, half);
+	const bool diff_negative = sub_abs(x_diff, x_0, x_1) != sub_abs(y_diff, y_0, y_1);
+
+	auto diff_product = scratch.subspan(2 * half, 2 * half);
+	mul_karatsuba(diff_product, x_diff, y_diff, scratch.subspan(4 * half));
+
+	auto z_1 = scratch.subspan(4 * half, 2 * half + 1);
+	z_1[2 * half] = add(z_1.first(2 * half), result.first(2 * half), result.subspan(2 * half));
+	if (diff_negative)
+		add(z_1, z_1, diff_product);
+	else
+		sub(z_1, z_1, diff_product);
+
+	// The top limb of z_1 may not fit in the result, in which case it is zero
+	auto result_middle = result.subspan(half);
+	const size_t z_1_size = std::min(z_1.size(), result_middle.size());
+	assert((z_1_size == z_1.size() || z_1.back() == 0) && "z_1 does not fit in the result");
+
+	add(result_middle, result_middle, z_1.first(z_1_size));
+}
+
+/**
+ * @brief Number of scratch limbs needed by sqr_karatsuba for an operand of n limbs.
+ */
+constexpr size_t sqr_karatsuba_scratch_size(size_t n) noexcept
+{
+	if (n < sqr_karatsuba_threshold)
+		return 0;
+
+	// The difference and its square take 3 * half limbs while recursing, and z_1 takes 2 * half + 1 limbs afterwards
+	const size_t half = (n + 1) / 2;
+	return std::max(3 * half + sqr_karatsuba_scratch_size(half), 5 * half + 1);
+}
+
+/**
+ * @brief result = lhs * lhs using Karatsuba's algorithm, with all three products being squares.
+ *
+ * @pre lhs is not empty, result.size() == 2 * lhs.size(), and result does not overlap lhs.
+ * @param scratch Temporary space of at least sqr_karatsuba_scratch_size(lhs.size()) limbs.
+ */
+constexpr void sqr_karatsuba(span_t result, const_span_t lhs, span_t scratch) noexcept
+{
+	if (lhs.size() < sqr_karatsuba_threshold)
+	{
+		sqr_basecase(result, lhs);
+		return;
+	}
+
+	const size_t half = (lhs.size() + 1) / 2;
+	const auto x_0 = lhs.first(half);
+	const auto x_1 = lhs.subspan(half);
+
+	sqr_karatsuba(result.first(2 * half), x_0, scratch);
+	sqr_karatsuba(result.subspan(2 * half), x_1, scratch);
+
+	// (x_0 - x_1)^2 = z_0 + z_2 - z_1, and is never negative
+	auto x_diff = scratch.first(half);
+	sub_abs(x_diff, x_0, x_1);
+
+	auto diff_square = scratch.subspan(half, 2 * half);
+	sqr_karatsuba(diff_square, x_diff, scratch.subspan(3 * half));
+
+	auto z_1 = scratch.subspan(3 * half, 2 * half + 1);
+	z_1[2 * half] = add(z_1.first(2 * half), result.first(2 * half), result.subspan(2 * half));
+	sub(z_1, z_1, diff_square);
+
+	// The top limb of z_1 may not fit in the result, in which case it is zero
+	auto result_middle = result.subspan(half);
+	const size_t z_1_size = std::min(z_1.size(), result_middle.size());
+	assert((z_1_size == z_1.size() || z_1.back() == 0) && "z_1 does not fit in the result");
+
+	add(result_middle, result_middle, z_1.first(z_1_size));
+}
+
+//// Division
+
+/**
+ * @brief quotient = lhs / divisor.
+ *
+ * @pre divisor is not zero, and quotient.size() == lhs.size(). quotient may be the same span as lhs.
+ * @return The remainder.
+ */
+constexpr digit_t divrem_1(span_t quotient, const_span_t lhs, digit_t divisor) noexcept
+{
+	digit_t remainder = 0;
+	for (size_t i = lhs.size(); i-- > 0;)
+		quotient[i] = divide_digits(remainder, lhs[i], divisor, remainder);
+
+	return remainder;
+}
+
+/**
+ * @brief The remainder of lhs / divisor, without storing the quotient.
+ *
+ * @pre divisor is not zero.
+ */
+constexpr digit_t mod_1(const_span_t lhs, digit_t divisor) noexcept
+{
+	digit_t remainder = 0;
+	for (size_t i = lhs.size(); i-- > 0;)
+		divide_digits(remainder, lhs[i], divisor, remainder);
+
+	return remainder;
+}
+
+/**
+ * @brief Schoolbook division by a divisor of several limbs, which is Knuth's algorithm D.
+ *
+ * Every quotient limb is estimated from the top three limbs of the partial remainder and the top two of the divisor,
+ * which makes it at most one too large except when the top limbs are equal, where it can be two too large. The
+ * estimate is corrected by adding the divisor back.
+ *
+ * @pre divisor.size() >= 2, its most significant bit is set, and quotient.size() == numerator.size() - divisor.size().
+ * quotient does not overlap the other spans.
+ * @param numerator Holds the remainder in its low divisor.size() limbs on return, and zeros above them.
+ * @return The most significant limb of the quotient, which is 0 or 1.
+ */
+constexpr digit_t divrem_basecase(span_t quotient, span_t numerator, const_span_t divisor) noexcept
+{
+	const size_t m = divisor.size();
+	const digit_t d1 = divisor[m - 1];
+	const digit_t d0 = divisor[m - 2];
+	assert(d1 >> (digit_bits - 1) && "The divisor has to be normalised");
+
+	digit_t high = 0;
+	const auto top = numerator.last(m);
+	if (cmp(top, divisor) != std::strong_ordering::less)
+	{
+		sub_n(top, top, divisor);
+		high = 1;
+	}
+
+	for (size_t j = quotient.size(); j-- > 0;)
+	{
+		// The window numerator[j .. j + m] is below divisor * B, so its quotient fits in a limb
+		const digit_t n2 = numerator[j + m];
+		const digit_t n1 = numerator[j + m - 1];
+		const digit_t n0 = numerator[j + m - 2];
+
+		digit_t q = ~digit_t(0);
+		if (n2 != d1)
+		{
+			digit_t r;
+			q = divide_digits(n2, n1, d1, r);
+
+			// Lower the estimate while q * d0 > r * B + n0, as long as r still fits in a limb
+			digit_t product_high;
+			digit_t product_low = multiply_digits(q, d0, product_high);
+			while (product_high > r || (product_high == r && product_low > n0))
+			{
+				q--;
+				r += d1;
+				if (r < d1)
+					break;
+				product_high -= product_low < d0;
+				product_low -= d0;
+			}
+		}
+
+		const auto window = numerator.subspan(j, m);
+		digit_t window_top = n2 - submul_1(window, divisor, q);
+
+		// The remainder is below the divisor, so a top limb that is not zero means q was too large
+		while (window_top != 0)
+		{
+			q--;
+			window_top += add_n(window, window, divisor);
+		}
+
+		numerator[j + m] = 0;
+		quotient[j] = q;
+	}
+
+	return high;
+}
+
+/**
+ * @brief quotient = lhs / divisor, for a divisor known to divide lhs exactly.
+ *
+ * Multiplies by the inverse of the divisor modulo B instead of dividing, which is much faster than divrem_1.
+ *
+ * @pre divisor is odd and divides lhs, and quotient.size() == lhs.size(). quotient may be the same span as lhs.
+ */
+constexpr void divexact_1(span_t quotient, const_span_t lhs, digit_t divisor) noexcept
+{
+	assert((divisor & 1) && "The divisor has to be odd");
+
+	// Newton's iteration doubles the number of correct low bits, and every odd number is its own inverse modulo 8
+	digit_t inverse = divisor;
+	for (int i = 0; i < 5; i++)
+		inverse *= 2 - divisor * inverse;
+
+	digit_t borrow = 0;
+	for (size_t i = 0; i < lhs.size(); i++)
+	{
+		const digit_t limb = lhs[i] - borrow;
+		const digit_t limb_borrow = lhs[i] < borrow;
+
+		quotient[i] = limb * inverse;
+
+		digit_t high;
+		multiply_digits(quotient[i], divisor, high);
+		borrow = high + limb_borrow;
+	}
+}
+
+//// Toom-Cook multiplication
+
+constexpr size_t mul_scratch_size(size_t lhs_size, size_t rhs_size) noexcept;
+constexpr size_t sqr_scratch_size(size_t size) noexcept;
+constexpr void mul(span_t result, const_span_t lhs, const_span_t rhs, span_t scratch) noexcept;
+constexpr void sqr(span_t result, const_span_t lhs, span_t scratch) noexcept;
+
+/**
+ * @brief result[offset ..] += value. Limbs of value that do not fit in result have to be zero.
+ */
+constexpr void add_at(span_t result, size_t offset, const_span_t value) noexcept
+{
+	const size_t size = std::min(value.size(), result.size() - offset);
+	assert(std::all_of(value.begin() + static_cast<ptrdiff_t>(size), value.end(), [](digit_t limb) { return limb == 0; }) &&
+		   "The value does not fit in the result");
+
+	[[maybe_unused]] const digit_t carry = add(result.subspan(offset), result.subspan(offset), value.first(size));
+	assert(carry == 0 && "The value does not fit in the result");
+}
+
+/**
+ * @brief Recovers the coefficients of a Toom-3 product from its values at 0, 1, -1, 2 and infinity, and adds them into place.
+ *
+ * Follows Bodrato's sequence, in which every intermediate value is non negative and the only division is an exact one by 3.
+ *
+ * @param result Holds v0 in its lowest 2k limbs and vinf from limb 4k on, with zeros in between.
+ * @param v1, vm1, v2 The other values, 2k + 2 limbs each. They are overwritten.
+ * @param vm1_negative The sign of vm1, which holds the absolute value.
+ */
+constexpr void toom3_interpolate(span_t result, size_t k, span_t v1, span_t vm1, bool vm1_negative, span_t v2) noexcept
+{
+	const const_span_t v0 = result.first(2 * k);
+	const const_span_t vinf = result.subspan(4 * k);
+
+	// With the product c0 + c1 x + c2 x^2 + c3 x^3 + c4 x^4, v2 = (v2 - vm1) / 3 = c1 + c2 + 3 c3 + 5 c4
+	if (vm1_negative)
+		add_n(v2, v2, vm1);
+	else
+		sub_n(v2, v2, vm1);
+	divexact_1(v2, v2, 3);
+
+	// vm1 = (v1 - vm1) / 2 = c1 + c3
+	if (vm1_negative)
+		add_n(vm1, v1, vm1);
+	else
+		sub_n(vm1, v1, vm1);
+	rshift(vm1, vm1, 1);
+
+	// v1 = v1 - v0 = c1 + c2 + c3 + c4
+	sub(v1, v1, v0);
+
+	// v2 = (v2 - v1) / 2 - 2 vinf = c3
+	sub_n(v2, v2, v1);
+	rshift(v2, v2, 1);
+	sub(v2, v2, vinf);
+	sub(v2, v2, vinf);
+
+	// v1 = v1 - vm1 - vinf = c2
+	sub_n(v1, v1, vm1);
+	sub(v1, v1, vinf);
+
+	// vm1 = vm1 - v2 = c1
+	sub_n(vm1, vm1, v2);
+
+	add_at(result, k, vm1);
+	add_at(result, 2 * k, v1);
+	add_at(result, 3 * k, v2);
+}
+
+/**
+ * @brief value = x0 + 2 x1 + 4 x2.
+ *
+ * @pre value.size() == x0.size() + 1 and x0.size() == x1.size() >= x2.size().
+ */
+constexpr void toom3_evaluate_at_2(span_t value, const_span_t x0, const_span_t x1, const_span_t x2) noexcept
+{
+	std::copy(x2.begin(), x2.end(), value.begin());
+	std::fill(value.begin() + static_cast<ptrdiff_t>(x2.size()), value.end(), 0);
+
+	lshift(value, value, 1);
+	add(value, value, x1);
+	lshift(value, value, 1);
+	add(value, value, x0);
+}
+
+/**
+ * @return The size of the pieces Toom-3 splits an operand of n limbs into.
+ */
+constexpr size_t toom3_piece_size(size_t n) noexcept
+{
+	return (n + 2) / 3;
+}
+
+/**
+ * @brief Checks if Toom-3 can multiply operands of these sizes, which is when both have limbs in all three pieces.
+ */
+constexpr bool toom3_applicable(size_t lhs_size, size_t rhs_size) noexcept
+{
+	const size_t k = toom3_piece_size(std::max(lhs_size, rhs_size));
+	return std::min(lhs_size, rhs_size) > 2 * k;
+}
+
+/**
+ * @brief Number of scratch limbs needed by mul_toom3.
+ */
+constexpr size_t toom3_scratch_size(size_t lhs_size, size_t rhs_size) noexcept
+{
+	const size_t k = toom3_piece_size(std::max(lhs_size, rhs_size));
+
+	// Two evaluated operands of k + 1 limbs and three products of 2k + 2 limbs, followed by the space of the recursive products
+	return 8 * k + 8 + std::max({mul_scratch_size(k + 1, k + 1), mul_scratch_size(k, k), mul_scratch_size(lhs_size - 2 * k, rhs_size - 2 * k)});
+}
+
+/**
+ * @brief Number of scratch limbs needed by sqr_toom3.
+ */
+constexpr size_t sqr_toom3_scratch_size(size_t size) noexcept
+{
+	const size_t k = toom3_piece_size(size);
+	return 8 * k + 8 + std::max({sqr_scratch_size(k + 1), sqr_scratch_size(k), sqr_scratch_size(size - 2 * k)});
+}
+
+/**
+ * @brief result = lhs * rhs using Toom-3, evaluating at 0, 1, -1, 2 and infinity. The five products are done by mul.
+ *
+ * @pre toom3_applicable(lhs.size(), rhs.size()), result.size() == lhs.size() + rhs.size(), and result does not overlap the operands.
+ * @param scratch Temporary space of at least toom3_scratch_size(lhs.size(), rhs.size()) limbs.
+ */
+constexpr void mul_toom3(span_t result, const_span_t lhs, const_span_t rhs, span_t scratch) noexcept
+{
+	assert(toom3_applicable(lhs.size(), rhs.size()) && "Both operands need limbs in all three pieces");
+
+	const size_t k = toom3_piece_size(std::max(lhs.size(), rhs.size()));
+	const auto a_0 = lhs.first(k), a_1 = lhs.subspan(k, k), a_2 = lhs.subspan(2 * k);
+	const auto b_0 = rhs.first(k), b_1 = rhs.subspan(k, k), b_2 = rhs.subspan(2 * k);
+
+	auto a_value = scratch.first(k + 1);
+	auto b_value = scratch.subspan(k + 1, k + 1);
+	auto v_1 = scratch.subspan(2 * k + 2, 2 * k + 2);
+	auto v_m1 = scratch.subspan(4 * k + 4, 2 * k + 2);
+	auto v_2 = scratch.subspan(6 * k + 6, 2 * k + 2);
+	auto rest = scratch.subspan(8 * k + 8);
+
+	// x_0 + x_2, which both the values at 1 and -1 start from
+	a_value[k] = add(a_value.first(k), a_0, a_2);
+	b_value[k] = add(b_value.first(k), b_0, b_2);
+
+	// The values at -1 are put in the space of v_2, which is not needed yet
+	auto a_m1 = v_2.first(k + 1);
+	auto b_m1 = v_2.subspan(k + 1);
+	const bool v_m1_negative = sub_abs(a_m1, a_value, a_1) != sub_abs(b_m1, b_value, b_1);
+	mul(v_m1, a_m1, b_m1, rest);
+
+	add(a_value, a_value, a_1);
+	add(b_value, b_value, b_1);
+	mul(v_1, a_value, b_value, rest);
+
+	toom3_evaluate_at_2(a_value, a_0, a_1, a_2);
+	toom3_evaluate_at_2(b_value, b_0, b_1, b_2);
+	mul(v_2, a_value, b_value, rest);
+
+	// v0 and vinf are written directly into their final place in the result
+	mul(result.first(2 * k), a_0, b_0, rest);
+	std::fill(result.begin() + static_cast<ptrdiff_t>(2 * k), result.begin() + static_cast<ptrdiff_t>(4 * k), 0);
+	mul(result.subspan(4 * k), a_2, b_2, rest);
+
+	toom3_interpolate(result, k, v_1, v_m1, v_m1_negative, v_2);
+}
+
+/**
+ * @brief result = lhs * lhs using Toom-3. The five squares are done by sqr.
+ *
+ * @pre lhs.size() >= 5, result.size() == 2 * lhs.size(), and result does not overlap lhs.
+ * @param scratch Temporary space of at least sqr_toom3_scratch_size(lhs.size()) limbs.
+ */
+constexpr void sqr_toom3(span_t result, const_span_t lhs, span_t scratch) noexcept
+{
+	assert(toom3_applicable(lhs.size(), lhs.size()) && "The operand needs limbs in all three pieces");
+
+	const size_t k = toom3_piece_size(lhs.size());
+	const auto a_0 = lhs.first(k), a_1 = lhs.subspan(k, k), a_2 = lhs.subspan(2 * k);
+
+	auto a_value = scratch.first(k + 1);
+	auto v_1 = scratch.subspan(2 * k + 2, 2 * k + 2);
+	auto v_m1 = scratch.subspan(4 * k + 4, 2 * k + 2);
+	auto v_2 = scratch.subspan(6 * k + 6, 2 * k + 2);
+	auto rest = scratch.subspan(8 * k + 8);
+
+	a_value[k] = add(a_value.first(k), a_0, a_2);
+
+	auto a_m1 = v_2.first(k + 1);
+	sub_abs(a_m1, a_value, a_1);
+	sqr(v_m1, a_m1, rest);
+
+	add(a_value, a_value, a_1);
+	sqr(v_1, a_value, rest);
+
+	toom3_evaluate_at_2(a_value, a_0, a_1, a_2);
+	sqr(v_2, a_value, rest);
+
+	sqr(result.first(2 * k), a_0, rest);
+	std::fill(result.begin() + static_cast<ptrdiff_t>(2 * k), result.begin() + static_cast<ptrdiff_t>(4 * k), 0);
+	sqr(result.subspan(4 * k), a_2, rest);
+
+	toom3_interpolate(result, k, v_1, v_m1, false, v_2);
+}
+
+//// Higher order Toom-Cook multiplication
+// Toom-4, Toom-6.5 and Toom-8.5 share one implementation, which evaluates at 0, infinity and the small integers 1, -1, 2, -2, ...
+// The variants differ in the number of points. With p + q - 1 points the operands can be split in p and q pieces for any p and q,
+// so the half point of Toom-6.5 and Toom-8.5 lets them split operands of somewhat different sizes without wasting a point.
+//
+// The interpolation runs in two's complement on values of a fixed width, in which adding, subtracting and exactly dividing
+// by an odd number work the same for negative values as for positive ones.
+
+/**
+ * Number of evaluation points of Toom-4, which splits both operands in 4 pieces.
+ */
+constexpr size_t toom4_points = 7;
+/**
+ * Number of evaluation points of Toom-6.5, which splits the operands in 6 and 6, or 7 and 6 pieces.
+ */
+constexpr size_t toom6h_points = 12;
+/**
+ * Number of evaluation points of Toom-8.5, which splits the operands in 8 and 8, or 9 and 8 pieces.
+ */
+constexpr size_t toom8h_points = 16;
+
+/**
+ * How a Toom multiplication splits its operands.
+ */
+struct ToomSplit {
+	size_t piece_size;
+	size_t lhs_pieces;
+	size_t rhs_pieces;
+
+	/**
+	 * @return The number of points the product is evaluated at.
+	 */
+	[[nodiscard]] constexpr size_t points() const noexcept { return lhs_pieces + rhs_pieces - 1; }
+	/**
+	 * @return The size of the evaluated products, which holds any intermediate value of the interpolation in two's complement.
+	 */
+	[[nodiscard]] constexpr size_t value_size() const noexcept { return 2 * piece_size + 3; }
+};
+
+/**
+ * @brief Splits operands of these sizes in the smallest pieces that need at most max_points evaluation points.
+ *
+ * @pre lhs_size >= rhs_size.
+ */
+constexpr ToomSplit toom_split(size_t lhs_size, size_t rhs_size, size_t max_points) noexcept
+{
+	size_t piece_size = lhs_size;
+	for (size_t rhs_pieces = 1; rhs_pieces < max_points; rhs_pieces++)
+	{
+		const size_t lhs_pieces = max_points + 1 - rhs_pieces;
+		piece_size = std::min(piece_size, std::max((lhs_size + lhs_pieces - 1) / lhs_pieces, (rhs_size + rhs_pieces - 1) / rhs_pieces));
+	}
+
+	return {piece_size, (lhs_size + piece_size - 1) / piece_size, (rhs_size + piece_size - 1) / piece_size};
+}
+
+/**
+ * @brief Checks if a Toom multiplication with max_points evaluation points can multiply operands of these sizes,
+ * which is when the shorter one is split in at least two pieces.
+ */
+constexpr bool toom_applicable(size_t lhs_size, size_t rhs_size, size_t max_points) noexcept
+{
+	return toom_split(std::max(lhs_size, rhs_size), std::min(lhs_size, rhs_size), max_points).rhs_pieces >= 2;
+}
+
+/**
+ * @brief Splits operands of these sizes in at most lhs_pieces and rhs_pieces pieces of the same size.
+ *
+ * @pre lhs_size >= rhs_size, and lhs_pieces >= rhs_pieces.
+ */
+constexpr ToomSplit toom_split_pieces(size_t lhs_size, size_t rhs_size, size_t lhs_pieces, size_t rhs_pieces) noexcept
+{
+	const size_t piece_size = std::max((lhs_size + lhs_pieces - 1) / lhs_pieces, (rhs_size + rhs_pieces - 1) / rhs_pieces);
+	return {piece_size, (lhs_size + piece_size - 1) / piece_size, (rhs_size + piece_size - 1) / piece_size};
+}
+
+/**
+ * @brief Number of scratch limbs needed by mul_toom with this split.
+ */
+constexpr size_t toom_scratch_size(size_t lhs_size, size_t rhs_size, const ToomSplit &split) noexcept
+{
+	const size_t n = std::max(lhs_size, rhs_size);
+	const size_t m = std::min(lhs_size, rhs_size);
+	const size_t k = split.piece_size;
+
+	// Six evaluated operands of k + 1 limbs and the values at the points other than 0 and infinity, followed by the space of the products
+	return 6 * (k + 1) + (split.points() - 2) * split.value_size() +
+		   std::max({mul_scratch_size(k + 1, k + 1), mul_scratch_size(k, k),
+					 mul_scratch_size(n - (split.lhs_pieces - 1) * k, m - (split.rhs_pieces - 1) * k)});
+}
+
+/**
+ * @brief Number of scratch limbs needed by mul_toom.
+ */
+constexpr size_t toom_scratch_size(size_t lhs_size, size_t rhs_size, size_t max_points) noexcept
+{
+	return toom_scratch_size(lhs_size, rhs_size, toom_split(std::max(lhs_size, rhs_size), std::min(lhs_size, rhs_size), max_points));
+}
+
+/**
+ * @brief Number of scratch limbs needed by sqr_toom.
+ */
+constexpr size_t sqr_toom_scratch_size(size_t size, size_t max_points) noexcept
+{
+	const ToomSplit split = toom_split(size, size, max_points);
+	const size_t k = split.piece_size;
+
+	return 6 * (k + 1) + (split.points() - 2) * split.value_size() +
+		   std::max({sqr_scratch_size(k + 1), sqr_scratch_size(k), sqr_scratch_size(size - (split.lhs_pieces - 1) * k)});
+}
+
+/**
+ * @return The value of the Toom evaluation point with this index, out of 1, -1, 2, -2, ...
+ */
+constexpr int64_t toom_point(size_t index) noexcept
+{
+	const auto magnitude = static_cast<int64_t>(index / 2 + 1);
+	return index % 2 ? -magnitude : magnitude;
+}
+
+/**
+ * @brief value = x0 + x2 * square + x4 * square^2 + ..., for the pieces of operand starting at first and skipping every other one.
+ *
+ * @pre The sum fits in value, which is one limb longer than the pieces.
+ */
+constexpr void toom_evaluate_alternate(span_t value, const_span_t operand, size_t piece_size, size_t first, digit_t square) noexcept
+{
+	const size_t pieces = (operand.size() + piece_size - 1) / piece_size;
+	size_t i = first + (pieces - 1 - first) / 2 * 2;
+
+	const auto top = operand.subspan(i * piece_size, std::min(piece_size, operand.size() - i * piece_size));
+	std::copy(top.begin(), top.end(), value.begin());
+	std::fill(value.begin() + static_cast<ptrdiff_t>(top.size()), value.end(), 0);
+
+	while (i > first)
+	{
+		i -= 2;
+		[[maybe_unused]] const digit_t carry = mul_1(value, value, square);
+		assert(carry == 0 && "The evaluated value does not fit");
+		add(value, value, operand.subspan(i * piece_size, piece_size));
+	}
+}
+
+/**
+ * @brief Evaluates the operand, split in pieces of piece_size limbs, at x and -x.
+ *
+ * The even and odd pieces are summed separately, so the two values take the same work as one.
+ *
+ * @param positive The value at x, piece_size + 1 limbs.
+ * @param negative The absolute value at -x, piece_size + 1 limbs.
+ * @param odd Temporary space of piece_size + 1 limbs.
+ * @return True if the value at -x is negative.
+ */
+constexpr bool toom_evaluate(span_t positive, span_t negative, const_span_t operand, size_t piece_size, digit_t x, span_t odd) noexcept
+{
+	toom_evaluate_alternate(positive, operand, piece_size, 0, x * x);
+	toom_evaluate_alternate(odd, operand, piece_size, 1, x * x);
+	if (x != 1)
+		mul_1(odd, odd, x);
+
+	const bool negative_sign = sub_abs(negative, positive, odd);
+	add_n(positive, positive, odd);
+
+	return negative_sign;
+}
+
+/**
+ * @brief value -= other * factor, in two's complement.
+ *
+ * @pre value.size() >= other.size(), and the factor is not the lowest int64_t.
+ */
+constexpr void toom_submul(span_t value, const_span_t other, int64_t factor) noexcept
+{
+	const size_t n = other.size();
+	if (factor >= 0)
+		sub_1(value.subspan(n), value.subspan(n), submul_1(value.first(n), other, static_cast<digit_t>(factor)));
+	else
+		add_1(value.subspan(n), value.subspan(n), addmul_1(value.first(n), other, static_cast<digit_t>(-factor)));
+}
+
+/**
+ * @brief value /= divisor, in two's complement, for a divisor known to divide value exactly.
+ *
+ * @pre divisor is neither zero nor the lowest int64_t.
+ */
+constexpr void toom_divexact(span_t value, int64_t divisor) noexcept
+{
+	const bool negative_value = value.back() >> (digit_bits - 1);
+	auto magnitude = static_cast<digit_t>(divisor < 0 ? -divisor : divisor);
+
+	// The power of two is shifted out arithmetically, keeping the sign
+	if (const auto shift = static_cast<unsigned>(std::countr_zero(magnitude)); shift > 0)
+	{
+		rshift(value, value, shift);
+		if (negative_value)
+			value.back() |= ~digit_t{0} << (digit_bits - shift);
+		magnitude >>= shift;
+	}
+
+	if (magnitude > 1)
+		divexact_1(value, value, magnitude);
+	if (divisor < 0)
+		neg(value, value);
+}
+
+/**
+ * @brief Recovers the coefficients of a Toom product from its values and adds them into place.
+ *
+ * The values are first reduced to those of (v(x) - c_0 - c_top x^top) / x, a polynomial with two coefficients less,
+ * which is then interpolated with Newton's divided differences and converted to the monomial basis.
+ *
+ * @param result Holds v0 in its lowest 2k limbs and vinf from limb (points - 1) k on, with zeros in between.
+ * @param values The values at the points 1, -1, 2, ..., value_size() limbs each in two's complement. They are overwritten.
+ */
+constexpr void toom_interpolate(span_t result, const ToomSplit &split, span_t values) noexcept
+{
+	const size_t k = split.piece_size;
+	const size_t top = split.points() - 1;
+	const size_t count = split.points() - 2;
+	const size_t width = split.value_size();
+	const const_span_t v0 = result.first(2 * k);
+	const const_span_t vinf = result.subspan(top * k);
+
+	auto value = [&](size_t i) { return values.subspan(i * width, width); };
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const int64_t x = toom_point(i);
+
+		// |x|^top fits in a limb for the up to 16 points that are used
+		digit_t power = 1;
+		for (size_t j = 0; j < top; j++)
+			power *= static_cast<digit_t>(x < 0 ? -x : x);
+
+		sub(value(i), value(i), v0);
+		if (x > 0 || top % 2 == 0)
+			sub_1(value(i).subspan(vinf.size()), value(i).subspan(vinf.size()), submul_1(value(i).first(vinf.size()), vinf, power));
+		else
+			add_1(value(i).subspan(vinf.size()), value(i).subspan(vinf.size()), addmul_1(value(i).first(vinf.size()), vinf, power));
+		toom_divexact(value(i), x);
+	}
+
+	// Divided differences, leaving the coefficients of the Newton form
+	for (size_t j = 1; j < count; j++)
+	{
+		for (size_t i = count - 1; i >= j; i--)
+		{
+			sub_n(value(i), value(i), value(i - 1));
+			toom_divexact(value(i), toom_point(i) - toom_point(i - j));
+		}
+	}
+
+	// Multiplying out the Newton form, from the innermost factor outwards
+	for (size_t i = count - 1; i-- > 0;)
+		for (size_t j = i; j + 1 < count; j++)
+			toom_submul(value(j), value(j + 1), toom_point(i));
+
+	std::fill(result.begin() + static_cast<ptrdiff_t>(2 * k), result.begin() + static_cast<ptrdiff_t>(top * k), 0);
+	for (size_t i = 0; i < count; i++)
+		add_at(result, (i + 1) * k, value(i));
+}
+
+/**
+ * @brief result = lhs * rhs using a Toom multiplication that splits the operands as given.
+ *
+ * @pre split is a split of the longer operand and the shorter one with split.rhs_pieces >= 2 and split.points() <= 16,
+ * result.size() == lhs.size() + rhs.size(), and result does not overlap the operands.
+ * @param scratch Temporary space of at least toom_scratch_size(lhs.size(), rhs.size(), split) limbs.
+ */
+constexpr void mul_toom(span_t result, const_span_t lhs_in, const_span_t rhs_in, const ToomSplit &split, span_t scratch) noexcept
+{
+	assert(split.rhs_pieces >= 2 && "The shorter operand needs at least two pieces");
+	assert(split.points() <= toom8h_points && "The powers of the points have to fit in a limb");
+
+	auto lhs = lhs_in;
+	auto rhs = rhs_in;
+	if (lhs.size() < rhs.size())
+		std::swap(lhs, rhs);
+
+	const size_t k = split.piece_size;
+	const size_t count = split.points() - 2;
+	const size_t width = split.value_size();
+
+	auto a_positive = scratch.first(k + 1);
+	auto a_negative = scratch.subspan(k + 1, k + 1);
+	auto b_positive = scratch.subspan(2 * k + 2, k + 1);
+	auto b_negative = scratch.subspan(3 * k + 3, k + 1);
+	auto odd = scratch.subspan(4 * k + 4, k + 1);
+	auto values = scratch.subspan(6 * k + 6, count * width);
+	auto rest = scratch.subspan(6 * k + 6 + count * width);
+
+	// Stores the product of two evaluated operands as a value of the interpolation
+	auto multiply = [&](size_t i, const_span_t a, const_span_t b, bool negative) {
+		auto value = values.subspan(i * width, width);
+		mul(value.first(2 * k + 2), a, b, rest);
+		std::fill(value.begin() + static_cast<ptrdiff_t>(2 * k + 2), value.end(), 0);
+		if (negative)
+			neg(value, value);
+	};
+
+	for (size_t i = 0; i < count; i += 2)
+	{
+		const auto x = static_cast<digit_t>(toom_point(i));
+		const bool a_sign = toom_evaluate(a_positive, a_negative, lhs, k, x, odd);
+		const bool b_sign = toom_evaluate(b_positive, b_negative, rhs, k, x, odd);
+
+		multiply(i, a_positive, b_positive, false);
+		if (i + 1 < count)
+			multiply(i + 1, a_negative, b_negative, a_sign != b_sign);
+	}
+
+	// v0 and vinf are written directly into their final place in the result
+	mul(result.first(2 * k), lhs.first(k), rhs.first(k), rest);
+	mul(result.subspan(split.points() * k - k), lhs.subspan((split.lhs_pieces - 1) * k), rhs.subspan((split.rhs_pieces - 1) * k), rest);
+
+	toom_interpolate(result, split, values);
+}
+
+/**
+ * @brief result = lhs * rhs using a Toom multiplication with at most max_points evaluation points.
+ *
+ * @pre toom_applicable(lhs.size(), rhs.size(), max_points), max_points <= 16, result.size() == lhs.size() + rhs.size(),
+ * and result does not overlap the operands.
+ * @param scratch Temporary space of at least toom_scratch_size(lhs.size(), rhs.size(), max_points) limbs.
+ */
+constexpr void mul_toom(span_t result, const_span_t lhs, const_span_t rhs, size_t max_points, span_t scratch) noexcept
+{
+	assert(toom_applicable(lhs.size(), rhs.size(), max_points) && "The shorter operand needs at least two pieces");
+
+	mul_toom(result, lhs, rhs, toom_split(std::max(lhs.size(), rhs.size()), std::min(lhs.size(), rhs.size()), max_points), scratch);
+}
+
+/**
+ * @brief result = lhs * lhs using a Toom squaring with at most max_points evaluation points.
+ *
+ * @pre toom_applicable(lhs.size(), lhs.size(), max_points), max_points <= 16, result.size() == 2 * lhs.size(),
+ * and result does not overlap lhs.
+ * @param scratch Temporary space of at least sqr_toom_scratch_size(lhs.size(), max_points) limbs.
+ */
+constexpr void sqr_toom(span_t result, const_span_t lhs, size_t max_points, span_t scratch) noexcept
+{
+	assert(toom_applicable(lhs.size(), lhs.size(), max_points) && "The operand needs at least two pieces");
+	assert(max_points <= toom8h_points && "The powers of the points have to fit in a limb");
+
+	const ToomSplit split = toom_split(lhs.size(), lhs.size(), max_points);
+	const size_t k = split.piece_size;
+	const size_t count = split.points() - 2;
+	const size_t width = split.value_size();
+
+	auto a_positive = scratch.first(k + 1);
+	auto a_negative = scratch.subspan(k + 1, k + 1);
+	auto odd = scratch.subspan(4 * k + 4, k + 1);
+	auto values = scratch.subspan(6 * k + 6, count * width);
+	auto rest = scratch.subspan(6 * k + 6 + count * width);
+
+	// Squares are never negative, so the sign of the value at -x does not matter
+	auto square = [&](size_t i, const_span_t a) {
+		auto value = values.subspan(i * width, width);
+		sqr(value.first(2 * k + 2), a, rest);
+		std::fill(value.begin() + static_cast<ptrdiff_t>(2 * k + 2), value.end(), 0);
+	};
+
+	for (size_t i = 0; i < count; i += 2)
+	{
+		toom_evaluate(a_positive, a_negative, lhs, k, static_cast<digit_t>(toom_point(i)), odd);
+
+		square(i, a_positive);
+		if (i + 1 < count)
+			square(i + 1, a_negative);
+	}
+
+	sqr(result.first(2 * k), lhs.first(k), rest);
+	sqr(result.subspan(split.points() * k - k), lhs.subspan((split.lhs_pieces - 1) * k), rest);
+
+	toom_interpolate(result, split, values);
+}
+
+/**
+ * @brief result = lhs * rhs using Toom-4. @see mul_toom
+ */
+constexpr void mul_toom4(span_t result, const_span_t lhs, const_span_t rhs, span_t scratch) noexcept
+{
+	mul_toom(result, lhs, rhs, toom4_points, scratch);
+}
+/**
+ * @brief result = lhs * lhs using Toom-4. @see sqr_toom
+ */
+constexpr void sqr_toom4(span_t result, const_span_t lhs, span_t scratch) noexcept
+{
+	sqr_toom(result, lhs, toom4_points, scratch);
+}
+/**
+ * @brief result = lhs * rhs using Toom-6.5. @see mul_toom
+ */
+constexpr void mul_toom6h(span_t result, const_span_t lhs, const_span_t rhs, span_t scratch) noexcept
+{
+	mul_toom(result, lhs, rhs, toom6h_points, scratch);
+}
+/**
+ * @brief result = lhs * lhs using Toom-6, the squaring counterpart of Toom-6.5. @see sqr_toom
+ */
+constexpr void sqr_toom6(span_t result, const_span_t lhs, span_t scratch) noexcept
+{
+	sqr_toom(result, lhs, toom6h_points, scratch);
+}
+/**
+ * @brief result = lhs * rhs using Toom-8.5. @see mul_toom
+ */
+constexpr void mul_toom8h(span_t result, const_span_t lhs, const_span_t rhs, span_t scratch) noexcept
+{
+	mul_toom(result, lhs, rhs, toom8h_points, scratch);
+}
+/**
+ * @brief result = lhs * lhs using Toom-8, the squaring counterpart of Toom-8.5. @see sqr_toom
+ */
+constexpr void sqr_toom8(span_t result, const_span_t lhs, span_t scratch) noexcept
+{
+	sqr_toom(result, lhs, toom8h_points, scratch);
+}
+
+//// Unbalanced Toom-Cook multiplication
+// Splitting both operands in the same number of pieces leaves the top pieces of the shorter one empty when the lengths differ
+// a lot, and the recursion then spends whole products on zeros. Toom-32, Toom-42 and Toom-63 split the longer operand in more
+// pieces than the shorter one, so that all pieces have the same size at length ratios of 3:2 and 2:1. Toom-63 cuts smaller
+// pieces than Toom-42 for the same ratio, which pays off for larger operands. They share the evaluation and interpolation of mul_toom.
+
+/**
+ * @brief Checks if a Toom multiplication splitting the operands in at most lhs_pieces and rhs_pieces pieces can multiply
+ * operands of these sizes, which is when the shorter one is split in at least two pieces.
+ */
+constexpr bool toom_pieces_applicable(size_t lhs_size, size_t rhs_size, size_t lhs_pieces, size_t rhs_pieces) noexcept
+{
+	return toom_split_pieces(std::max(lhs_size, rhs_size), std::min(lhs_size, rhs_size), lhs_pieces, rhs_pieces).rhs_pieces >= 2;
+}
+
+/**
+ * @brief Number of scratch limbs needed by mul_toom splitting the operands in at most lhs_pieces and rhs_pieces pieces.
+ */
+constexpr size_t toom_pieces_scratch_size(size_t lhs_size, size_t rhs_size, size_t lhs_pieces, size_t rhs_pieces) noexcept
+{
+	return toom_scratch_size(lhs_size, rhs_size, toom_split_pieces(std::max(lhs_size, rhs_size), std::min(lhs_size, rhs_size), lhs_pieces, rhs_pieces));
+}
+
+/**
+ * @brief result = lhs * rhs using a Toom multiplication that splits the longer operand in at most lhs_pieces pieces
+ * and the shorter in at most rhs_pieces pieces.
+ *
+ * @pre toom_pieces_applicable(lhs.size(), rhs.size(), lhs_pieces, rhs_pieces), lhs_pieces + rhs_pieces <= 17,
+ * result.size() == lhs.size() + rhs.size(), and result does not overlap the operands.
+ * @param scratch Temporary space of at least toom_pieces_scratch_size(lhs.size(), rhs.size(), lhs_pieces, rhs_pieces) limbs.
+ */
+constexpr void mul_toom_pieces(span_t result, const_span_t lhs, const_span_t rhs, size_t lhs_pieces, size_t rhs_pieces, span_t scratch) noexcept
+{
+	assert(toom_pieces_applicable(lhs.size(), rhs.size(), lhs_pieces, rhs_pieces) && "The shorter operand needs at least two pieces");
+
+	mul_toom(result, lhs, rhs, toom_split_pieces(std::max(lhs.size(), rhs.size()), std::min(lhs.size(), rhs.size()), lhs_pieces, rhs_pieces), scratch);
+}
+
+/**
+ * @brief result = lhs * rhs using Toom-32, which splits the longer operand in 3 pieces and the shorter in 2. @see mul_toom_pieces
+ */
+constexpr void mul_toom32(span_t result, const_span_t lhs, const_span_t rhs, span_t scratch) noexcept
+{
+	mul_toom_pieces(result, lhs, rhs, 3, 2, scratch);
+}
+/**
+ * @brief result = lhs * rhs using Toom-42, which splits the longer operand in 4 pieces and the shorter in 2. @see mul_toom_pieces
+ */
+constexpr void mul_toom42(span_t result, const_span_t lhs, const_span_t rhs, span_t scratch) noexcept
+{
+	mul_toom_pieces(result, lhs, rhs, 4, 2, scratch);
+}
+/**
+ * @brief result = lhs * rhs using Toom-63, which splits the longer operand in 6 pieces and the shorter in 3. @see mul_toom_pieces
+ */
+constexpr void mul_toom63(span_t result, const_span_t lhs, const_span_t rhs, span_t scratch) noexcept
+{
+	mul_toom_pieces(result, lhs, rhs, 6, 3, scratch);
+}
+
+//// Schönhage-Strassen multiplication
+// Multiplies modulo B^(K M) + 1 by splitting the operands in K pieces of M limbs, and convolving the pieces negacyclically
+// with a transform over the ring of integers modulo F = 2^(64 L) + 1. In that ring 2 is a root of unity, so the butterflies
+// only shift and add, and the pointwise products are ordinary multiplications of L limbs done by mul, recursing as needed.
+//
+// Residues modulo F are stored in L + 1 limbs and kept at most F - 1 = 2^(64 L), so the top limb is 1 only for that value.
+
+/**
+ * @brief Reduces a residue whose top limb holds a small multiple of 2^(64 L), which is congruent to minus that multiple.
+ */
+constexpr void fermat_normalize(span_t value) noexcept
+{
+	const size_t n = value.size() - 1;
+	const digit_t top = value[n];
+	value[n] = 0;
+
+	// low - top + B^n + 1 is the same value plus F
+	if (sub_1(value.first(n), value.first(n), top))
+		add_1(value, value, 1);
+}
+
+/**
+ * @brief result = -value modulo F.
+ */
+constexpr void fermat_negate(span_t result, const_span_t value) noexcept
+{
+	if (std::all_of(value.begin(), value.end(), [](digit_t limb) { return limb == 0; }))
+	{
+		std::fill(result.begin(), result.end(), 0);
+		return;
+	}
+
+	// F - value = -value + B^n + 1 modulo B^(n + 1)
+	neg(result, value);
+	add_1(result, result, 1);
+	result.back() += 1;
+}
+
+constexpr void fermat_add(span_t result, const_span_t lhs, const_span_t rhs) noexcept
+{
+	add_n(result, lhs, rhs);
+	fermat_normalize(result);
+}
+
+constexpr void fermat_sub(span_t result, const_span_t lhs, const_span_t rhs) noexcept
+{
+	// A borrow leaves lhs - rhs + B^(n + 1), and adding F while dropping B^(n + 1) gives a value in range
+	if (sub_n(result, lhs, rhs))
+	{
+		add_1(result, result, 1);
+		result.back() += 1;
+	}
+}
+
+/**
+ * @brief result = value * 2^exponent modulo F.
+ *
+ * @pre exponent < 2 * 64 L, and result does not overlap value.
+ */
+constexpr void fermat_mul_2exp(span_t result, const_span_t value, size_t exponent) noexcept
+{
+	const size_t n = value.size() - 1;
+	const size_t bits = n * digit_bits;
+
+	// 2^(64 L) = -1, so a shift past it negates
+	const bool negate = exponent >= bits;
+	if (negate)
+		exponent -= bits;
+
+	const size_t q = exponent / digit_bits;
+	const auto s = static_cast<unsigned>(exponent % digit_bits);
+
+	if (value[n])
+	{
+		// value is -1, so the result is -2^exponent
+		std::fill(result.begin(), result.end(), 0);
+		result[q] = digit_t{1} << s;
+		if (!negate)
+			fermat_negate(result, std::span(result));
+		return;
+	}
+
+	// Limb j of value * 2^s, which has n + 1 limbs
+	auto shifted = [&](size_t j) {
+		const digit_t low = j < n ? value[j] << s : 0;
+		const digit_t high = s && j > 0 ? value[j - 1] >> (digit_bits - s) : 0;
+		return low | high;
+	};
+
+	// The limbs that move past 2^(64 L) wrap around with their sign flipped, so the result is low - high with
+	// low = the first n - q limbs moved up by q, and high = the remaining q + 1 limbs
+	for (size_t i = 0; i < q; i++)
+		result[i] = shifted(n - q + i);
+	const digit_t high_top = shifted(n);
+	for (size_t i = q; i < n; i++)
+		result[i] = shifted(i - q);
+	result[n] = 0;
+
+	const digit_t borrow = neg(result.first(q), result.first(q));
+	if (sub_1(result.subspan(q, n - q), result.subspan(q, n - q), high_top + borrow))
+		add_1(result, result, 1);
+
+	if (negate)
+		fermat_negate(result, std::span(result));
+}
+
+/**
+ * @brief result = value * sqrt(2)^exponent modulo F, where sqrt(2) = 2^(3 64 L / 4) - 2^(64 L / 4).
+ *
+ * @pre exponent < 4 * 64 L, and neither result nor temporary overlaps value.
+ */
+constexpr void fermat_mul_sqrt2exp(span_t result, const_span_t value, size_t exponent, span_t temporary) noexcept
+{
+	const size_t bits = (value.size() - 1) * digit_bits;
+
+	if (exponent % 2 == 0)
+	{
+		fermat_mul_2exp(result, value, exponent / 2);
+		return;
+	}
+
+	const size_t power = exponent / 2;
+	fermat_mul_2exp(result, value, (power + 3 * bits / 4) % (2 * bits));
+	fermat_mul_2exp(temporary, value, (power + bits / 4) % (2 * bits));
+	fermat_sub(result, result, temporary);
+}
+
+/**
+ * @brief result = lhs * rhs modulo F.
+ *
+ * @param product Temporary space of 2 L limbs.
+ * @param scratch Temporary space of mul_scratch_size(L, L) limbs, or sqr_scratch_size(L) when squaring.
+ */
+constexpr void fermat_mul(span_t result, const_span_t lhs, const_span_t rhs, span_t product, span_t scratch) noexcept
+{
+	const size_t n = lhs.size() - 1;
+
+	// A top limb means the value is -1
+	if (lhs[n] || rhs[n])
+	{
+		if (lhs[n] && rhs[n])
+		{
+			std::fill(result.begin(), result.end(), 0);
+			result[0] = 1;
+		} else
+		{
+			fermat_negate(result, lhs[n] ? rhs : lhs);
+		}
+		return;
+	}
+
+	if (lhs.data() == rhs.data())
+		sqr(product, lhs.first(n), scratch);
+	else
+		mul(product, lhs.first(n), rhs.first(n), scratch);
+
+	// low + high * 2^(64 L) = low - high
+	result[n] = 0;
+	if (sub_n(result.first(n), product.first(n), product.subspan(n)))
+		add_1(result, result, 1);
+}
+
+/**
+ * How a Schönhage-Strassen multiplication splits its operands.
+ */
+struct SsaSplit {
+	/// log2 of the number of pieces K
+	size_t log_pieces;
+	/// Size M of the pieces in limbs
+	size_t piece_size;
+	/// Size L of the residues modulo F, not counting the top limb
+	size_t residue_size;
+
+	[[nodiscard]] constexpr size_t pieces() const noexcept { return size_t{1} << log_pieces; }
+	/**
+	 * @return The exponent of 2 that is the K-th root of unity, which is also the exponent of sqrt(2) that is the weight
+	 * turning the cyclic convolution into a negacyclic one.
+	 */
+	[[nodiscard]] constexpr size_t root_exponent() const noexcept { return 2 * residue_size * digit_bits / pieces(); }
+};
+
+/**
+ * @brief Chooses the split for operands of these sizes.
+ *
+ * K is chosen so that the residues come out around the square root of the product size. With the sqrt(2) trick,
+ * L only has to be a multiple of K / 128 rather than K / 64.
+ */
+constexpr SsaSplit ssa_split(size_t lhs_size, size_t rhs_size) noexcept
+{
+	const size_t size = lhs_size + rhs_size;
+	const size_t log_pieces = std::max<size_t>(4, (std::bit_width(size) + 3) / 2);
+	const size_t pieces = size_t{1} << log_pieces;
+	const size_t piece_size = (size + pieces - 1) / pieces;
+
+	// The negacyclic coefficients are less than K B^(2M) in absolute value, and need a sign bit on top
+	const size_t granularity = std::max<size_t>(1, pieces / (2 * digit_bits));
+	const size_t residue_size = (2 * piece_size + 1 + granularity - 1) / granularity * granularity;
+
+	return {log_pieces, piece_size, residue_size};
+}
+
+/**
+ * @brief Number of scratch limbs needed by mul_ssa, or by sqr_ssa when square is set.
+ */
+constexpr size_t ssa_scratch_size(size_t lhs_size, size_t rhs_size, bool square = false) noexcept
+{
+	const SsaSplit split = ssa_split(lhs_size, rhs_size);
+	const size_t k = split.pieces();
+	const size_t l = split.residue_size;
+	const size_t m = split.piece_size;
+
+	// The transforms of both operands, two temporary residues, the pointwise product and the sum of the coefficients,
+	// followed by the space of the pointwise products
+	return (square ? 1 : 2) * k * (l + 1) + 2 * (l + 1) + 2 * l + (k + 1) * m + 2 +
+		   (square ? sqr_scratch_size(l) : mul_scratch_size(l, l));
+}
+
+/**
+ * @brief Loads the pieces of operand into the residues, weighted by sqrt(2)^(i root_exponent), and transforms them.
+ *
+ * A decimation in frequency transform, which leaves the values in bit reversed order. The pieces past the end of the
+ * operand are zero, so the first level of butterflies only has to shift the pieces that are there.
+ */
+constexpr void ssa_forward(span_t residues, const_span_t operand, const SsaSplit &split, span_t temporary) noexcept
+{
+	const size_t k = split.pieces();
+	const size_t l = split.residue_size;
+	const size_t m = split.piece_size;
+	const size_t bits = l * digit_bits;
+	const size_t operand_pieces = (operand.size() + m - 1) / m;
+
+	auto residue = [&](size_t i) { return residues.subspan(i * (l + 1), l + 1); };
+	auto first = temporary.first(l + 1);
+	auto second = temporary.subspan(l + 1, l + 1);
+
+	for (size_t i = 0; i < k; i++)
+	{
+		if (i >= operand_pieces)
+		{
+			std::fill(residue(i).begin(), residue(i).end(), 0);
+			continue;
+		}
+
+		const auto piece = operand.subspan(i * m, std::min(m, operand.size() - i * m));
+		std::copy(piece.begin(), piece.end(), first.begin());
+		std::fill(first.begin() + static_cast<ptrdiff_t>(piece.size()), first.end(), 0);
+		fermat_mul_sqrt2exp(residue(i), first, i * split.root_exponent(), second);
+	}
+
+	for (size_t half = k / 2; half > 0; half /= 2)
+	{
+		const size_t stride = k / (2 * half);
+		for (size_t start = 0; start < k; start += 2 * half)
+		{
+			for (size_t j = 0; j < half; j++)
+			{
+				const size_t exponent = j * stride * split.root_exponent() % (2 * bits);
+				auto u = residue(start + j);
+				auto v = residue(start + j + half);
+
+				if (half == k / 2 && j + half >= operand_pieces)
+				{
+					// v is zero, so the sum is u and the difference u
+					if (j < operand_pieces)
+						fermat_mul_2exp(v, u, exponent);
+					continue;
+				}
+
+				fermat_sub(first, u, v);
+				fermat_add(u, u, v);
+				fermat_mul_2exp(v, first, exponent);
+			}
+		}
+	}
+}
+
+/**
+ * @brief Undoes ssa_forward on values in bit reversed order, then adds up the negacyclic coefficients into result.
+ *
+ * @param sum Temporary space of (K + 1) M + 2 limbs.
+ */
+constexpr void ssa_inverse(span_t result, span_t residues, const SsaSplit &split, span_t temporary, span_t sum) noexcept
+{
+	const size_t k = split.pieces();
+	const size_t l = split.residue_size;
+	const size_t m = split.piece_size;
+	const size_t bits = l * digit_bits;
+
+	auto residue = [&](size_t i) { return residues.subspan(i * (l + 1), l + 1); };
+	auto first = temporary.first(l + 1);
+	auto second = temporary.subspan(l + 1, l + 1);
+
+	// Decimation in time with the inverse roots, which takes bit reversed values back to natural order
+	for (size_t half = 1; half < k; half *= 2)
+	{
+		const size_t stride = k / (2 * half);
+		for (size_t start = 0; start < k; start += 2 * half)
+		{
+			for (size_t j = 0; j < half; j++)
+			{
+				const size_t exponent = (2 * bits - j * stride * split.root_exponent() % (2 * bits)) % (2 * bits);
+				auto u = residue(start + j);
+				auto v = residue(start + j + half);
+
+				fermat_mul_2exp(first, v, exponent);
+				fermat_sub(v, u, first);
+				fermat_add(u, u, first);
+			}
+		}
+	}
+
+	// Coefficient i is divided by K and the weight sqrt(2)^(i root_exponent), and added into sum at limb i M.
+	// sum is a two's complement value, since the coefficients of a negacyclic convolution may be negative.
+	std::fill(sum.begin(), sum.end(), 0);
+	for (size_t i = 0; i < k; i++)
+	{
+		const size_t exponent = (4 * bits - i * split.root_exponent() - 2 * split.log_pieces) % (4 * bits);
+		fermat_mul_sqrt2exp(first, residue(i), exponent, second);
+
+		// The coefficients are below K B^(2M) in absolute value, far from F / 2, so the top bit tells the sign
+		auto target = sum.subspan(i * m);
+		if (first[l] || first[l - 1] >> (digit_bits - 1))
+		{
+			fermat_negate(second, first);
+			sub(target, target, second.first(std::min(2 * m + 1, target.size())));
+		} else
+		{
+			add(target, target, first.first(std::min(2 * m + 1, target.size())));
+		}
+	}
+
+	// sum = low + high B^(K M) = low - high modulo B^(K M) + 1, which is the product since that is less than B^(K M)
+	const size_t n = k * m;
+	auto high = second.first(sum.size() - n);
+	std::copy(sum.begin() + static_cast<ptrdiff_t>(n), sum.end(), high.begin());
+	auto low = sum.first(n + 1);
+	low[n] = 0;
+
+	if (high.back() >> (digit_bits - 1))
+	{
+		neg(high, high);
+		add(low, low, high);
+		if (low[n])
+		{
+			low[n]--;
+			sub_1(low, low, 1);
+		}
+	} else if (sub(low, low, high))
+	{
+		add_1(low, low, 1);
+		low[n]++;
+	}
+
+	assert(std::all_of(low.begin() + static_cast<ptrdiff_t>(result.size()), low.end(), [](digit_t limb) { return limb == 0; }) &&
+		   "The product does not fit in the result");
+	std::copy(low.begin(), low.begin() + static_cast<ptrdiff_t>(result.size()), result.begin());
+}
+
+/**
+ * @brief result = lhs * rhs using Schönhage-Strassen multiplication.
+ *
+ * @pre Neither operand is empty, result.size() == lhs.size() + rhs.size(), and result does not overlap the operands.
+ * @param scratch Temporary space of at least ssa_scratch_size(lhs.size(), rhs.size()) limbs.
+ */
+constexpr void mul_ssa(span_t result, const_span_t lhs, const_span_t rhs, span_t scratch) noexcept
+{
+	const SsaSplit split = ssa_split(lhs.size(), rhs.size());
+	const size_t k = split.pieces();
+	const size_t l = split.residue_size;
+
+	auto a = scratch.first(k * (l + 1));
+	auto b = scratch.subspan(k * (l + 1), k * (l + 1));
+	auto temporary = scratch.subspan(2 * k * (l + 1), 2 * (l + 1));
+	auto product = scratch.subspan(2 * k * (l + 1) + 2 * (l + 1), 2 * l);
+	auto sum = scratch.subspan(2 * k * (l + 1) + 2 * (l + 1) + 2 * l, (k + 1) * split.piece_size + 2);
+	auto rest = scratch.subspan(2 * k * (l + 1) + 2 * (l + 1) + 2 * l + sum.size());
+
+	ssa_forward(a, lhs, split, temporary);
+	ssa_forward(b, rhs, split, temporary);
+
+	for (size_t i = 0; i < k; i++)
+	{
+		auto residue = a.subspan(i * (l + 1), l + 1);
+		fermat_mul(temporary.first(l + 1), residue, b.subspan(i * (l + 1), l + 1), product, rest);
+		std::copy(temporary.begin(), temporary.begin() + static_cast<ptrdiff_t>(l + 1), residue.begin());
+	}
+
+	ssa_inverse(result, a, split, temporary, sum);
+}
+
+/**
+ * @brief result = lhs * lhs using Schönhage-Strassen multiplication. Transforms the operand once.
+ *
+ * @pre lhs is not empty, result.size() == 2 * lhs.size(), and result does not overlap lhs.
+ * @param scratch Temporary space of at least ssa_scratch_size(lhs.size(), lhs.size(), true) limbs.
+ */
+constexpr void sqr_ssa(span_t result, const_span_t lhs, span_t scratch) noexcept
+{
+	const SsaSplit split = ssa_split(lhs.size(), lhs.size());
+	const size_t k = split.pieces();
+	const size_t l = split.residue_size;
+
+	auto a = scratch.first(k * (l + 1));
+	auto temporary = scratch.subspan(k * (l + 1), 2 * (l + 1));
+	auto product = scratch.subspan(k * (l + 1) + 2 * (l + 1), 2 * l);
+	auto sum = scratch.subspan(k * (l + 1) + 2 * (l + 1) + 2 * l, (k + 1) * split.piece_size + 2);
+	auto rest = scratch.subspan(k * (l + 1) + 2 * (l + 1) + 2 * l + sum.size());
+
+	ssa_forward(a, lhs, split, temporary);
+
+	for (size_t i = 0; i < k; i++)
+	{
+		auto residue = a.subspan(i * (l + 1), l + 1);
+		fermat_mul(temporary.first(l + 1), residue, residue, product, rest);
+		std::copy(temporary.begin(), temporary.begin() + static_cast<ptrdiff_t>(l + 1), residue.begin());
+	}
+
+	ssa_inverse(result, a, split, temporary, sum);
+}
+
+//// Multiplication dispatch
+// mul and sqr pick the algorithm from the operand sizes, and are what the algorithms above use for their smaller products.
+// With AVX2 the floating point FFT takes the products it can do exactly, the NTT covers every other product up to
+// 2^55 limbs, and Schönhage-Strassen takes over beyond that. Below those, operands of different lengths go to the unbalanced
+// Toom variants, or are cut in chunks of the shorter length when they differ too much for any of them.
+
+/**
+ * @return The number of evaluation points of the Toom variant used from Toom-4 on, for a shorter operand of this size.
+ */
+constexpr size_t toom_points(size_t size) noexcept
+{
+	if (size < toom6h_threshold)
+		return toom4_points;
+	if (size < toom8h_threshold)
+		return toom6h_points;
+
+	return toom8h_points;
+}
+
+/**
+ * @brief Picks the unbalanced Toom variant for operands of these sizes, for the lengths where the balanced variants would
+ * leave pieces of the shorter operand empty.
+ *
+ * Below Toom-4, Toom-32 and Toom-42 take over from Toom-3 for length ratios from 3:2 to 7:4 and from 7:4 to 5:2.
+ * Between Toom-4 and Toom-6.5, Toom-63 takes ratios from 7:4 to 5:2. Longer operands are cut in chunks instead.
+ *
+ * @pre lhs_size >= rhs_size.
+ * @return The number of pieces the longer and the shorter operand are split in, or zeros if no unbalanced variant is used.
+ */
+constexpr std::pair<size_t, size_t> unbalanced_toom_pieces(size_t lhs_size, size_t rhs_size) noexcept
+{
+	const size_t n = lhs_size;
+	const size_t m = rhs_size;
+
+	if (m < toom3_threshold || m >= toom6h_threshold || 2 * n >= 5 * m)
+		return {0, 0};
+	if (m >= toom4_threshold)
+		return 4 * n >= 7 * m ? std::pair<size_t, size_t>{6, 3} : std::pair<size_t, size_t>{0, 0};
+	if (toom3_applicable(n, m))
+		return {0, 0};
+
+	return 4 * n < 7 * m ? std::pair<size_t, size_t>{3, 2} : std::pair<size_t, size_t>{4, 2};
+}
+
+/**
+ * @brief Checks if the floating point FFT can be used for operands of these sizes: at run time, on a CPU with AVX2,
+ * and where the error bound holds.
+ */
+constexpr bool fft_usable(size_t lhs_size, size_t rhs_size) noexcept
+{
+	return !std::is_constant_evaluated() && cpu::has_avx2() && fft::applicable(lhs_size, rhs_size);
+}
+
+/**
+ * @brief Number of scratch limbs needed by mul_chunked.
+ */
+constexpr size_t chunked_scratch_size(size_t lhs_size, size_t rhs_size) noexcept
+{
+	const size_t n = std::max(lhs_size, rhs_size);
+	const size_t m = std::min(lhs_size, rhs_size);
+
+	// Room for one chunk product, and for the products themselves
+	const size_t last = n % m;
+	return 2 * m + std::max(mul_scratch_size(m, m), last ? mul_scratch_size(last, m) : 0);
+}
+
+/**
+ * @brief result = lhs * rhs, multiplying the shorter operand with chunks of the longer one of its own size and adding up the products.
+ *
+ * Each chunk product is balanced, so this is how operands too unbalanced for any Toom variant are multiplied.
+ *
+ * @pre Neither operand is empty, result.size() == lhs.size() + rhs.size(), and result does not overlap the operands.
+ * @param scratch Temporary space of at least chunked_scratch_size(lhs.size(), rhs.size()) limbs.
+ */
+constexpr void mul_chunked(span_t result, const_span_t lhs_in, const_span_t rhs_in, span_t scratch) noexcept
+{
+	auto lhs = lhs_in;
+	auto rhs = rhs_in;
+	if (lhs.size() < rhs.size())
+		std::swap(lhs, rhs);
+
+	const size_t n = lhs.size();
+	const size_t m = rhs.size();
+	auto product = scratch.first(2 * m);
+	auto rest = scratch.subspan(2 * m);
+
+	mul(result.first(2 * m), lhs.first(m), rhs, rest);
+	for (size_t offset = m; offset < n; offset += m)
+	{
+		const auto chunk = lhs.subspan(offset, std::min(m, n - offset));
+		auto chunk_product = product.first(chunk.size() + m);
+		mul(chunk_product, chunk, rhs, rest);
+
+		// The limbs from offset + m on have not been written yet
+		auto target = result.subspan(offset, chunk.size() + m);
+		std::fill(target.begin() + static_cast<ptrdiff_t>(m), target.end(), 0);
+		add_n(target, target, chunk_product);
+	}
+}
+
+/**
+ * @brief Number of scratch limbs needed by mul for operands of these sizes.
+ */
+constexpr size_t mul_scratch_size(size_t lhs_size, size_t rhs_size) noexcept
+{
+	const size_t n = std::max(lhs_size, rhs_size);
+	const size_t m = std::min(lhs_size, rhs_size);
+
+	if (m < karatsuba_threshold)
+		return 0;
+	if (m < toom3_threshold)
+		return karatsuba_scratch_size(n);
+	if (m >= fft_threshold && fft_usable(n, m))
+		return fft::scratch_size(n, m);
+	if (m >= ntt_threshold)
+		return ntt::fits(n, m) ? ntt::mul_scratch_size(n, m) : ssa_scratch_size(n, m);
+	if (m < toom4_threshold && toom3_applicable(n, m))
+		return toom3_scratch_size(n, m);
+	if (const auto [lhs_pieces, rhs_pieces] = unbalanced_toom_pieces(n, m); lhs_pieces != 0)
+		return toom_pieces_scratch_size(n, m, lhs_pieces, rhs_pieces);
+	if (m >= toom4_threshold && toom_applicable(n, m, toom_points(m)))
+		return toom_scratch_size(n, m, toom_points(m));
+
+	return chunked_scratch_size(n, m);
+}
+
+/**
+ * @brief result = lhs * rhs, using the fastest algorithm for the operand sizes.
+ *
+ * @pre Neither operand is empty, result.size() == lhs.size() + rhs.size(), and result does not overlap the operands.
+ * @param scratch Temporary space of at least mul_scratch_size(lhs.size(), rhs.size()) limbs.
+ */
+constexpr void mul(span_t result, const_span_t lhs_in, const_span_t rhs_in, span_t scratch) noexcept
+{
+	auto lhs = lhs_in;
+	auto rhs = rhs_in;
+
+	// Arrange it so that lhs is the longer operand
+	if (lhs.size() < rhs.size())
+		std::swap(lhs, rhs);
+
+	const size_t n = lhs.size();
+	const size_t m = rhs.size();
+
+	if (m < karatsuba_threshold)
+	{
+		mul_basecase(result, lhs, rhs);
+	} else if (m < toom3_threshold)
+	{
+		mul_karatsuba(result, lhs, rhs, scratch);
+	} else if (m >= fft_threshold && fft_usable(n, m))
+	{
+		fft::mul(result, lhs, rhs, fft::as_real(scratch));
+	} else if (m >= ntt_threshold)
+	{
+		if (ntt::fits(n, m))
+			ntt::mul(result, lhs, rhs, scratch);
+		else
+			mul_ssa(result, lhs, rhs, scratch);
+	} else if (m < toom4_threshold && toom3_applicable(n, m))
+	{
+		mul_toom3(result, lhs, rhs, scratch);
+	} else if (const auto [lhs_pieces, rhs_pieces] = unbalanced_toom_pieces(n, m); lhs_pieces != 0)
+	{
+		mul_toom_pieces(result, lhs, rhs, lhs_pieces, rhs_pieces, scratch);
+	} else if (m >= toom4_threshold && toom_applicable(n, m, toom_points(m)))
+	{
+		mul_toom(result, lhs, rhs, toom_points(m), scratch);
+	} else
+	{
+		mul_chunked(result, lhs, rhs, scratch);
+	}
+}
+
+/**
+ * @brief Number of scratch limbs needed by sqr for an operand of this size.
+ */
+constexpr size_t sqr_scratch_size(size_t size) noexcept
+{
+	if (size < sqr_karatsuba_threshold)
+		return 0;
+	if (size < sqr_toom3_threshold)
+		return sqr_karatsuba_scratch_size(size);
+	if (size >= sqr_fft_threshold && fft_usable(size, size))
+		return fft::scratch_size(size, size);
+	if (size < sqr_toom4_threshold)
+		return sqr_toom3_scratch_size(size);
+	if (size >= ntt_threshold)
+		return ntt::fits(size, size) ? ntt::sqr_scratch_size(size) : ssa_scratch_size(size, size, true);
+
+	return sqr_toom_scratch_size(size, toom_points(size));
+}
+
+/**
+ * @brief result = lhs * lhs, using the fastest algorithm for the operand size.
+ *
+ * @pre lhs is not empty, result.size() == 2 * lhs.size(), and result does not overlap lhs.
+ * @param scratch Temporary space of at least sqr_scratch_size(lhs.size()) limbs.
+ */
+constexpr void sqr(span_t result, const_span_t lhs, span_t scratch) noexcept
+{
+	if (lhs.size() < sqr_karatsuba_threshold)
+		sqr_basecase(result, lhs);
+	else if (lhs.size() < sqr_toom3_threshold)
+		sqr_karatsuba(result, lhs, scratch);
+	else if (lhs.size() >= sqr_fft_threshold && fft_usable(lhs.size(), lhs.size()))
+		fft::sqr(result, lhs, fft::as_real(scratch));
+	else if (lhs.size() < sqr_toom4_threshold)
+		sqr_toom3(result, lhs, scratch);
+	else if (lhs.size() < ntt_threshold)
+		sqr_toom(result, lhs, toom_points(lhs.size()), scratch);
+	else if (ntt::fits(lhs.size(), lhs.size()))
+		ntt::sqr(result, lhs, scratch);
+	else
+		sqr_ssa(result, lhs, scratch);
+}
+
+//// Short products
+
+// mullo and mulhi compute one half of a product, as Newton iterations and Barrett reduction need, and mulmid the middle
+// columns of an unbalanced one. The short products follow Mulders: a full product of the low (or high) 70% of both
+// operands covers most of the half, and the two strips it misses are short products of the remaining 30% again.
+
+/**
+ * @brief result = lhs * rhs modulo B^n, where n is result.size(), using schoolbook multiplication.
+ *
+ * @pre result is not empty, both operands have at least result.size() limbs, of which the ones above it are not read, and
+ * result does not overlap them.
+ */
+constexpr void mullo_basecase(span_t result, const_span_t lhs, const_span_t rhs) noexcept
+{
+	const size_t n = result.size();
+
+	// Row i only reaches the limbs below n
+	mul_1(result, rhs.first(n), lhs[0]);
+	for (size_t i = 1; i < n; i++)
+		addmul_1(result.subspan(i), rhs.first(n - i), lhs[i]);
+}
+
+/**
+ * @brief Number of scratch limbs needed by mullo for a result of n limbs.
+ */
+constexpr size_t mullo_scratch_size(size_t n) noexcept
+{
+	if (n < mullo_dc_threshold)
+		return 0;
+	if (n >= short_product_full_threshold)
+		return 2 * n + mul_scratch_size(n, n);
+
+	const size_t high = n * 3 / 10;
+	const size_t low = n - high;
+	return std::max(2 * low + mul_scratch_size(low, low), high + mullo_scratch_size(high));
+}
+
+/**
+ * @brief result = lhs * rhs modulo B^n, where n is result.size().
+ *
+ * @pre The preconditions of mullo_basecase.
+ * @param scratch Temporary space of at least mullo_scratch_size(result.size()) limbs.
+ */
+constexpr void mullo(span_t result, const_span_t lhs, const_span_t rhs, span_t scratch) noexcept
+{
+	const size_t n = result.size();
+
+	if (n < mullo_dc_threshold)
+	{
+		mullo_basecase(result, lhs, rhs);
+		return;
+	}
+
+	if (n >= short_product_full_threshold)
+	{
+		auto product = scratch.first(2 * n);
+		mul(product, lhs.first(n), rhs.first(n), scratch.subspan(2 * n));
+		std::copy_n(product.begin(), n, result.begin());
+		return;
+	}
+
+	// The product of the low limbs covers all of the result but the strips of lhs_high * rhs_low and lhs_low * rhs_high
+	const size_t high = n * 3 / 10;
+	const size_t low = n - high;
+	auto product = scratch.first(2 * low);
+	mul(product, lhs.first(low), rhs.first(low), scratch.subspan(2 * low));
+	std::copy_n(product.begin(), n, result.begin());
+	if (high == 0)
+		return;
+
+	auto strip = scratch.first(high);
+	mullo(strip, lhs.subspan(low), rhs, scratch.subspan(high));
+	add_n(result.subspan(low), result.subspan(low), strip);
+	mullo(strip, lhs, rhs.subspan(low), scratch.subspan(high));
+	add_n(result.subspan(low), result.subspan(low), strip);
+}
+
+/**
+ * @brief Number of scratch limbs needed by mulhi_basecase for operands of n limbs.
+ */
+constexpr size_t mulhi_basecase_scratch_size(size_t n) noexcept
+{
+	return n + 1;
+}
+
+/**
+ * @brief result = an approximation of lhs * rhs / B^n, where n is the size of all three spans, from the partial products
+ * of the columns n - 1 and up.
+ *
+ * The result is at most the exact quotient, and less than n below it.
+ *
+ * @pre The spans are not empty and have the same size, and result does not overlap the operands.
+ * @param scratch Temporary space of at least mulhi_basecase_scratch_size(result.size()) limbs.
+ */
+constexpr void mulhi_basecase(span_t result, const_span_t lhs, const_span_t rhs, span_t scratch) noexcept
+{
+	const size_t n = result.size();
+	auto columns = scratch.first(n + 1);
+
+	// Row i starts at the column n - 1, and its carry lands on a limb no earlier row has reached
+	columns[1] = mul_1(columns.first(1), rhs.last(1), lhs[0]);
+	for (size_t i = 1; i < n; i++)
+		columns[i + 1] = addmul_1(columns.first(i + 1), rhs.last(i + 1), lhs[i]);
+
+	std::copy(columns.begin() + 1, columns.end(), result.begin());
+}
+
+/**
+ * @brief The number of high limbs of each operand mulhi leaves out of its full product, and computes the strips of with
+ * short products. Keeping them below n / 2 - 2 keeps the error bound of mulhi_basecase.
+ */
+constexpr size_t mulhi_strip_size(size_t n) noexcept
+{
+	return n < 4 ? 0 : std::min(n * 3 / 10, (n - 4) / 2);
+}
+
+/**
+ * @brief Number of scratch limbs needed by mulhi for operands of n limbs.
+ */
+constexpr size_t mulhi_scratch_size(size_t n) noexcept
+{
+	if (n < mulhi_dc_threshold)
+		return mulhi_basecase_scratch_size(n);
+	if (n >= short_product_full_threshold)
+		return 2 * n + mul_scratch_size(n, n);
+
+	const size_t low = mulhi_strip_size(n);
+	const size_t high = n - low;
+	return std::max(2 * high + mul_scratch_size(high, high), low + (low ? mulhi_scratch_size(low) : 0));
+}
+
+/**
+ * @brief result = an approximation of lhs * rhs / B^n, where n is the size of all three spans.
+ *
+ * The result is at most the exact quotient, and less than n below it. Above short_product_full_threshold it is exact.
+ *
+ * @pre The spans are not empty and have the same size, and result does not overlap the operands.
+ * @param scratch Temporary space of at least mulhi_scratch_size(result.size()) limbs.
+ */
+constexpr void mulhi(span_t result, const_span_t lhs, const_span_t rhs, span_t scratch) noexcept
+{
+	const size_t n = result.size();
+
+	if (n < mulhi_dc_threshold)
+	{
+		mulhi_basecase(result, lhs, rhs, scratch);
+		return;
+	}
+
+	if (n >= short_product_full_threshold)
+	{
+		auto product = scratch.first(2 * n);
+		mul(product, lhs, rhs, scratch.subspan(2 * n));
+		std::copy(product.begin() + static_cast<ptrdiff_t>(n), product.end(), result.begin());
+		return;
+	}
+
+	// The product of the high limbs, and the top halves of the strips of lhs_low * rhs_high and lhs_high * rhs_low. What
+	// is left out is below B^n, so each part loses less than one, and the strips their own error.
+	const size_t low = mulhi_strip_size(n);
+	const size_t high = n - low;
+	auto product = scratch.first(2 * high);
+	mul(product, lhs.last(high), rhs.last(high), scratch.subspan(2 * high));
+	std::copy(product.end() - static_cast<ptrdiff_t>(n), product.end(), result.begin());
+	if (low == 0)
+		return;
+
+	auto strip = scratch.first(low);
+	mulhi(strip, lhs.first(low), rhs.last(low), scratch.subspan(low));
+	[[maybe_unused]] digit_t carry = add(result, result, strip);
+	mulhi(strip, lhs.last(low), rhs.first(low), scratch.subspan(low));
+	carry += add(result, result, strip);
+	assert(carry == 0 && "The approximation is below the exact quotient");
+}
+
+/**
+ * @brief The middle product: result = the sum of the partial products lhs[i] * rhs[j] with rhs.size() - 1 <= i + j <
+ * lhs.size(), each shifted by i + j - (rhs.size() - 1) limbs, using schoolbook multiplication.
+ *
+ * These are the columns of lhs * rhs where every limb of rhs takes part, without what the lower columns carry into them.
+ *
+ * @pre lhs.size() >= rhs.size() > 0, result.size() == lhs.size() - rhs.size() + 3, and result does not overlap the operands.
+ */
+constexpr void mulmid_basecase(span_t result, const_span_t lhs, const_span_t rhs) noexcept
+{
+	const size_t m = rhs.size();
+	const size_t columns = lhs.size() - m + 1;
+	auto low = result.first(columns);
+
+	// Row j multiplies rhs[j] by the window of lhs that lands on the columns, and the carries add up in the top two limbs
+	result[columns] = mul_1(low, lhs.subspan(m - 1, columns), rhs[0]);
+	result[columns + 1] = 0;
+	for (size_t j = 1; j < m; j++)
+	{
+		const digit_t carry = addmul_1(low, lhs.subspan(m - 1 - j, columns), rhs[j]);
+		result[columns] += carry;
+		result[columns + 1] += result[columns] < carry;
+	}
+}
+
+constexpr size_t mulmid_scratch_size(size_t lhs_size, size_t rhs_size) noexcept;
+constexpr void mulmid(span_t result, const_span_t lhs, const_span_t rhs, span_t scratch) noexcept;
+
+/**
+ * @brief value = the middle product of the limb by limb sum of lhs and rhs, without carries between the limbs, and y.
+ *
+ * The sum is taken with carries, and the carries are then taken out of the middle product again. Within the columns a
+ * carry only moves a partial product to the next limb of lhs, so only the carries across the first and last column count.
+ *
+ * @pre lhs.size() == rhs.size() == 2 * y.size() - 1, and value has y.size() + 2 limbs.
+ * @param sum Space for lhs.size() limbs.
+ * @param scratch Temporary space of at least mulmid_scratch_size(lhs.size(), y.size()) limbs.
+ */
+constexpr void mulmid_of_sum(span_t value, const_span_t lhs, const_span_t rhs, const_span_t y, span_t sum, span_t scratch) noexcept
+{
+	const size_t h = y.size();
+	digit_t low[2] = {};
+	digit_t high[2] = {};
+
+	digit_t carry = 0;
+	for (size_t i = 0; i < sum.size(); i++)
+	{
+		sum[i] = add_with_carry(lhs[i], rhs[i], carry);
+		if (carry == 0)
+			continue;
+
+		// A carry out of limb i moves the partial products with y[2h - 2 - i] above the top column, and brings the one
+		// with y[h - 2 - i] in under the first
+		auto &target = i + 1 >= h ? high : low;
+		const digit_t digit = i + 1 >= h ? y[2 * h - 2 - i] : y[h - 2 - i];
+		target[0] += digit;
+		target[1] += target[0] < digit;
+	}
+
+	// The value fits in h + 2 limbs, so the corrections can wrap around above them
+	mulmid(value, sum, y, scratch);
+	add_n(value.subspan(h), value.subspan(h), std::span(high));
+	sub(value, value, std::span(low));
+}
+
+/**
+ * @brief value = the middle product of x and |y_0 - y_1|, taken limb by limb without borrows between the limbs.
+ *
+ * Like mulmid_of_sum, with the borrows taken out of the middle product of x and the difference.
+ *
+ * @pre x.size() == 2 * y_0.size() - 1, y_0 and y_1 have the same size, and value has y_0.size() + 2 limbs.
+ * @param difference Space for y_0.size() limbs.
+ * @param scratch Temporary space of at least mulmid_scratch_size(x.size(), y_0.size()) limbs.
+ * @return If y_0 < y_1, in which case value is the negated middle product of x and the limbs of y_0 - y_1.
+ */
+constexpr bool mulmid_of_difference(span_t value, const_span_t x, const_span_t y_0, const_span_t y_1, span_t difference,
+									span_t scratch) noexcept
+{
+	const size_t h = y_0.size();
+	const bool negative = cmp(y_0, y_1) < 0;
+	const auto larger = negative ? y_1 : y_0;
+	const auto smaller = negative ? y_0 : y_1;
+	digit_t low[2] = {};
+	digit_t high[2] = {};
+
+	// The difference is not negative, so there is no borrow out of the top limb
+	digit_t borrow = 0;
+	for (size_t j = 0; j < h; j++)
+	{
+		difference[j] = subtract_with_borrow(larger[j], smaller[j], borrow);
+		if (borrow == 0)
+			continue;
+
+		// A borrow out of limb j takes the partial product with x[2h - 2 - j] above the top column, and brings the one
+		// with x[h - 2 - j] in under the first, with the opposite signs of mulmid_of_sum
+		high[0] += x[2 * h - 2 - j];
+		high[1] += high[0] < x[2 * h - 2 - j];
+		if (j + 2 <= h)
+		{
+			low[0] += x[h - 2 - j];
+			low[1] += low[0] < x[h - 2 - j];
+		}
+	}
+
+	mulmid(value, x, difference, scratch);
+	sub_n(value.subspan(h), value.subspan(h), std::span(high));
+	add(value, value, std::span(low));
+
+	return negative;
+}
+
+/**
+ * @brief Number of scratch limbs needed by mulmid_karatsuba for a rhs of m limbs.
+ */
+constexpr size_t mulmid_karatsuba_scratch_size(size_t m) noexcept
+{
+	const size_t h = m / 2;
+	return 6 * h + 5 + mulmid_scratch_size(2 * h - 1, h);
+}
+
+/**
+ * @brief The middle product of lhs and rhs, with the transposed Karatsuba algorithm of Hanrot, Quercia and Zimmermann.
+ *
+ * With rhs split in halves y_0 and y_1, the low and high halves of the columns are the middle products
+ * x_1 y_0 + x_0 y_1 and x_2 y_0 + x_1 y_1 of the overlapping windows x_0, x_1 and x_2 of lhs. Three middle products of
+ * half the size give them: (x_0 + x_1) y_1 + x_1 (y_0 - y_1) and (x_1 + x_2) y_0 - x_1 (y_0 - y_1).
+ *
+ * @pre rhs.size() is even, lhs.size() == 2 * rhs.size() - 1, result.size() == rhs.size() + 2, and result does not
+ * overlap the operands.
+ * @param scratch Temporary space of at least mulmid_karatsuba_scratch_size(rhs.size()) limbs.
+ */
+constexpr void mulmid_karatsuba(span_t result, const_span_t lhs, const_span_t rhs, span_t scratch) noexcept
+{
+	const size_t h = rhs.size() / 2;
+	const auto x_0 = lhs.first(2 * h - 1);
+	const auto x_1 = lhs.subspan(h, 2 * h - 1);
+	const auto x_2 = lhs.subspan(2 * h, 2 * h - 1);
+	const auto y_0 = rhs.first(h);
+	const auto y_1 = rhs.subspan(h);
+
+	auto sum = scratch.first(2 * h - 1);
+	auto difference = scratch.subspan(2 * h - 1, h);
+	auto low = scratch.subspan(3 * h - 1, h + 2);
+	auto high = scratch.subspan(4 * h + 1, h + 2);
+	auto shared = scratch.subspan(5 * h + 3, h + 2);
+	auto rest = scratch.subspan(6 * h + 5);
+
+	mulmid_of_sum(low, x_0, x_1, y_1, sum, rest);
+	mulmid_of_sum(high, x_1, x_2, y_0, sum, rest);
+
+	// Both halves are below B^(h + 2), so they come out right modulo it
+	if (mulmid_of_difference(shared, x_1, y_0, y_1, difference, rest))
+	{
+		sub_n(low, low, shared);
+		add_n(high, high, shared);
+	} else
+	{
+		add_n(low, low, shared);
+		sub_n(high, high, shared);
+	}
+
+	std::copy(low.begin(), low.end(), result.begin());
+	std::fill(result.begin() + static_cast<ptrdiff_t>(h + 2), result.end(), 0);
+	[[maybe_unused]] const digit_t carry = add_n(result.subspan(h), result.subspan(h), high);
+	assert(carry == 0 && "The middle product fits in its limbs");
+}
+
+/**
+ * @brief Number of scratch limbs needed by mulmid for operands of these sizes.
+ */
+constexpr size_t mulmid_scratch_size(size_t lhs_size, size_t rhs_size) noexcept
+{
+	const size_t m = rhs_size;
+	const size_t columns = lhs_size - rhs_size + 1;
+
+	if (std::min(m, columns) < mulmid_karatsuba_threshold)
+		return 0;
+	if (columns == m)
+		return m % 2 == 0 ? mulmid_karatsuba_scratch_size(m) : std::max(mulmid_karatsuba_scratch_size(m - 1), m + 1);
+	if (columns > m)
+	{
+		const size_t last = columns % m;
+		return m + 2 + std::max(mulmid_scratch_size(2 * m - 1, m), last ? mulmid_scratch_size(last + m - 1, m) : 0);
+	}
+
+	const size_t last = m % columns;
+	return columns + 2 + std::max(mulmid_scratch_size(2 * columns - 1, columns), last ? mulmid_scratch_size(columns + last - 1, last) : 0);
+}
+
+/**
+ * @brief The middle product of lhs and rhs, as defined by mulmid_basecase, using the fastest algorithm for the sizes.
+ *
+ * Square middle products, with as many columns as rhs has limbs, are done by transposed Karatsuba. Wider ones are cut in
+ * blocks of columns, and narrower ones in chunks of rhs, each with the window of lhs landing on the same columns.
+ *
+ * @pre The preconditions of mulmid_basecase.
+ * @param scratch Temporary space of at least mulmid_scratch_size(lhs.size(), rhs.size()) limbs.
+ */
+constexpr void mulmid(span_t result, const_span_t lhs, const_span_t rhs, span_t scratch) noexcept
+{
+	const size_t m = rhs.size();
+	const size_t columns = lhs.size() - m + 1;
+
+	if (std::min(m, columns) < mulmid_karatsuba_threshold)
+	{
+		mulmid_basecase(result, lhs, rhs);
+		return;
+	}
+
+	if (columns == m && m % 2 == 0)
+	{
+		mulmid_karatsuba(result, lhs, rhs, scratch);
+		return;
+	}
+
+	if (columns == m)
+	{
+		// An odd one is an even one on all but the top limb of rhs, which leaves out a column, plus the product of the top
+		// limb with the low limbs of lhs
+		const size_t even = m - 1;
+		mulmid_karatsuba(result.first(even + 2), lhs.subspan(1, 2 * even - 1), rhs.first(even), scratch);
+		result[m + 1] = 0;
+
+		digit_t last_column[3];
+		mulmid_basecase(last_column, lhs.subspan(even + 1, even), rhs.first(even));
+		add(result.subspan(even), result.subspan(even), std::span(last_column));
+
+		auto top = scratch.first(m + 1);
+		top[m] = mul_1(top.first(m), lhs.first(m), rhs[even]);
+		[[maybe_unused]] const digit_t carry = add(result, result, top);
+		assert(carry == 0 && "The middle product fits in its limbs");
+		return;
+	}
+
+	std::fill(result.begin(), result.end(), 0);
+	if (columns > m)
+	{
+		// The blocks overlap in their top two limbs
+		auto block = scratch.first(m + 2);
+		for (size_t offset = 0; offset < columns; offset += m)
+		{
+			const size_t width = std::min(m, columns - offset);
+			mulmid(block.first(width + 2), lhs.subspan(offset, width + m - 1), rhs, scratch.subspan(m + 2));
+			add(result.subspan(offset), result.subspan(offset), block.first(width + 2));
+		}
+		return;
+	}
+
+	auto part = scratch.first(columns + 2);
+	for (size_t start = 0; start < m; start += columns)
+	{
+		const size_t length = std::min(columns, m - start);
+		mulmid(part, lhs.subspan(m - start - length, columns + length - 1), rhs.subspan(start, length), scratch.subspan(columns + 2));
+		add_n(result, result, part);
+	}
+}
+
+//// Divide and conquer division
+
+// The quotient is computed in blocks of at most divisor size limbs, from the top. A block of k limbs divides the top 2k
+// limbs of its window by the top k limbs of the divisor, recursively, and then subtracts the product of that quotient and
+// the rest of the divisor through mul, adding the divisor back while the remainder is negative. A block as long as the
+// divisor is done as two such halves. This is the recursive division of Burnikel and Ziegler, and takes O(M(n) log n)
+// time when multiplying takes M(n).
+
+/**
+ * @brief Number of scratch limbs needed by div_block for a block of block_size quotient limbs and a divisor of divisor_size limbs.
+ */
+constexpr size_t div_block_scratch_size(size_t block_size, size_t divisor_size) noexcept
+{
+	const size_t k = block_size;
+	const size_t m = divisor_size;
+
+	if (k < div_dc_threshold)
+		return 0;
+	if (k == m)
+		return std::max(div_block_scratch_size(k - k / 2, m), div_block_scratch_size(k / 2, m));
+
+	return std::max(div_block_scratch_size(k, k), m + mul_scratch_size(k, m - k));
+}
+
+/**
+ * @brief Divides a window of divisor.size() + quotient.size() limbs by the divisor, by divide and conquer.
+ *
+ * @pre The preconditions of divrem_basecase, with quotient.size() <= divisor.size().
+ * @param window Holds the remainder in its low divisor.size() limbs on return. The limbs above are clobbered.
+ * @param scratch Temporary space of at least div_block_scratch_size(quotient.size(), divisor.size()) limbs.
+ * @return The most significant limb of the quotient, which is 0 or 1.
+ */
+constexpr digit_t div_block(span_t quotient, span_t window, const_span_t divisor, span_t scratch) noexcept
+{
+	const size_t k = quotient.size();
+	const size_t m = divisor.size();
+
+	if (k < div_dc_threshold)
+		return divrem_basecase(quotient, window, divisor);
+
+	if (k == m)
+	{
+		// The high half leaves a remainder below the divisor at the top of the window of the low half
+		const size_t low_size = k / 2;
+		const digit_t high = div_block(quotient.subspan(low_size), window.subspan(low_size), divisor, scratch);
+		[[maybe_unused]] const digit_t low_high = div_block(quotient.first(low_size), window.first(m + low_size), divisor, scratch);
+		assert(low_high == 0 && "The low half of the quotient fits in its limbs");
+
+		return high;
+	}
+
+	// An estimate from the top limbs, which is too large by the product with the rest of the divisor
+	digit_t high = div_block(quotient, window.last(2 * k), divisor.last(k), scratch);
+
+	const size_t rest_size = m - k;
+	const auto product = scratch.first(m);
+	const auto remainder = window.first(m);
+	mul(product, quotient, divisor.first(rest_size), scratch.subspan(m));
+	digit_t borrow = sub_n(remainder, remainder, product);
+	if (high)
+		borrow += sub_n(remainder.subspan(k), remainder.subspan(k), divisor.first(rest_size));
+
+	while (borrow != 0)
+	{
+		high -= sub_1(quotient, quotient, 1);
+		borrow -= add_n(remainder, remainder, divisor);
+	}
+
+	return high;
+}
+
+/**
+ * @brief Number of scratch limbs needed by divrem for operands of these sizes.
+ */
+constexpr size_t divrem_scratch_size(size_t lhs_size, size_t divisor_size) noexcept
+{
+	const size_t n = lhs_size;
+	const size_t m = divisor_size;
+	if (m == 1)
+		return 0;
+
+	const size_t first_block = (n - m) % m + 1;
+
+	return m + n + 1 + std::max(div_block_scratch_size(first_block, m), n - m + 1 > m ? div_block_scratch_size(m, m) : 0);
+}
+
+/**
+ * @brief quotient = lhs / divisor and remainder = lhs % divisor, with divrem_basecase for short quotients or divisors and
+ * divide and conquer otherwise.
+ *
+ * @pre The most significant limb of divisor is not zero, lhs.size() >= divisor.size(), quotient.size() ==
+ * lhs.size() - divisor.size() + 1, and remainder.size() == divisor.size(). The outputs do not overlap the inputs.
+ * @param scratch Temporary space of at least divrem_scratch_size(lhs.size(), divisor.size()) limbs.
+ */
+constexpr void divrem(span_t quotient, span_t remainder, const_span_t lhs, const_span_t divisor, span_t scratch) noexcept
+{
+	const size_t n = lhs.size();
+	const size_t m = divisor.size();
+	assert(divisor.back() != 0 && "The divisor cannot have leading zero limbs");
+
+	if (m == 1)
+	{
+		remainder[0] = divrem_1(quotient, lhs, divisor[0]);
+		return;
+	}
+
+	// Shift both so that the top bit of the divisor is set, which leaves the quotient unchanged
+	const unsigned shift = static_cast<unsigned>(std::countl_zero(divisor.back()));
+	const auto normalised_divisor = scratch.first(m);
+	const auto numerator = scratch.subspan(m, n + 1);
+	const auto rest = scratch.subspan(m + n + 1);
+	if (shift != 0)
+	{
+		lshift(normalised_divisor, divisor, shift);
+		numerator[n] = lshift(numerator.first(n), lhs, shift);
+	} else
+	{
+		std::copy(divisor.begin(), divisor.end(), normalised_divisor.begin());
+		std::copy(lhs.begin(), lhs.end(), numerator.begin());
+		numerator[n] = 0;
+	}
+
+	// The top limbs of the shifted numerator are below the divisor, so every block has a high quotient limb of zero
+	size_t done = quotient.size();
+	size_t block_size = (done - 1) % m + 1;
+	while (done != 0)
+	{
+		const size_t start = done - block_size;
+		[[maybe_unused]] const digit_t high = div_block(quotient.subspan(start, block_size), numerator.subspan(start, m + block_size),
+														normalised_divisor, rest);
+		assert(high == 0 && "The quotient fits in its limbs");
+
+		done = start;
+		block_size = m;
+	}
+
+	if (shift != 0)
+		rshift(remainder, numerator.first(m), shift);
+	else
+		std::copy_n(numerator.begin(), m, remainder.begin());
+}
+
+//// Barrett reduction
+
+// Reducing many numbers by the same modulus, as modular exponentiation does, pays for an approximate inverse of the
+// modulus once. The quotient by the modulus then comes from the high half of a product with the inverse, and the
+// remainder from the low half of the product of the quotient and the modulus, so both are short products.
+
+/**
+ * @brief Number of scratch limbs needed by barrett_inverse for a modulus of this size.
+ */
+constexpr size_t barrett_inverse_scratch_size(size_t modulus_size) noexcept
+{
+	return 3 * modulus_size + divrem_scratch_size(2 * modulus_size, modulus_size);
+}
+
+/**
+ * @brief inverse = (B^2k - 1) / modulus, rounded down, where k is modulus.size().
+ *
+ * @pre The most significant limb of modulus is not zero, and inverse.size() == modulus.size() + 1.
+ * @param scratch Temporary space of at least barrett_inverse_scratch_size(modulus.size()) limbs.
+ */
+constexpr void barrett_inverse(span_t inverse, const_span_t modulus, span_t scratch) noexcept
+{
+	const size_t k = modulus.size();
+	auto numerator = scratch.first(2 * k);
+	std::fill(numerator.begin(), numerator.end(), ~digit_t{0});
+
+	divrem(inverse, scratch.subspan(2 * k, k), numerator, modulus, scratch.subspan(3 * k));
+}
+
+/**
+ * @brief Number of scratch limbs needed by barrett_reduce for a modulus of this size.
+ */
+constexpr size_t barrett_reduce_scratch_size(size_t modulus_size) noexcept
+{
+	const size_t k = modulus_size;
+	return 3 * (k + 2) + std::max(mulhi_scratch_size(k + 2), mullo_scratch_size(k + 1));
+}
+
+/**
+ * @brief result = value % modulus, with the inverse of the modulus from barrett_inverse.
+ *
+ * @pre The most significant limb of modulus is not zero, value.size() == 2 * modulus.size(), result.size() ==
+ * modulus.size(), and result does not overlap the inputs.
+ * @param scratch Temporary space of at least barrett_reduce_scratch_size(modulus.size()) limbs.
+ */
+constexpr void barrett_reduce(span_t result, const_span_t value, const_span_t modulus, const_span_t inverse, span_t scratch) noexcept
+{
+	const size_t k = modulus.size();
+	auto top = scratch.first(k + 2);
+	auto padded_inverse = scratch.subspan(k + 2, k + 2);
+	auto product = scratch.subspan(2 * (k + 2), k + 2);
+	auto rest = scratch.subspan(3 * (k + 2));
+
+	// The quotient is estimated as (value / B^(k - 1)) * inverse / B^(k + 1). Both factors get an extra zero limb at the
+	// bottom, which puts the error of mulhi below the lowest limb of the estimate.
+	top[0] = 0;
+	std::copy(value.begin() + static_cast<ptrdiff_t>(k - 1), value.end(), top.begin() + 1);
+	padded_inverse[0] = 0;
+	std::copy(inverse.begin(), inverse.end(), padded_inverse.begin() + 1);
+	mulhi(product, top, padded_inverse, rest);
+
+	// The estimate is at most four below the quotient, so the remainder is below 5 * modulus < B^(k + 1), and only the
+	// low k + 1 limbs of the product with the modulus are needed
+	const auto quotient = product.subspan(1);
+	auto padded_modulus = top.first(k + 1);
+	std::copy(modulus.begin(), modulus.end(), padded_modulus.begin());
+	padded_modulus[k] = 0;
+	auto remainder = padded_inverse.first(k + 1);
+	mullo(remainder, quotient, padded_modulus, rest);
+	sub_n(remainder, value.first(k + 1), remainder);
+
+	while (cmp(remainder, modulus) >= 0)
+		sub(remainder, remainder, modulus);
+
+	std::copy_n(remainder.begin(), k, result.begin());
+}
+
+}// namespace suuri::limbs
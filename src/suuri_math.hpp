@@ -56,6 +56,22 @@ constexpr T abs(T n) noexcept
   return n; // Effectively a no-op
 }
 
+///// square
+
+template<typename T>
+  requires is_big_int_v<T>
+constexpr T square(const T& x)
+{
+  return x.square();
+};
+
+template<typename T>
+  requires std::is_integral_v<T> && (!is_big_int_v<T>)
+constexpr T square(T x) noexcept
+{
+  return static_cast<T>(x * x);
+}
+
 ///// pow
 
 template<typename T>
@@ -83,7 +99,7 @@ constexpr T pow(T x, uint64_t n) noexcept
       y = x * y;
       n--;
     }
-    x *= x;
+    x = square(x);
     n /= 2;
   }
   return x * y;
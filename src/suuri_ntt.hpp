@@ -0,0 +1,709 @@
+#pragma once
+
+#include "suuri_core.hpp"
+
+#include <algorithm>
+#include <assert.h>
+#include <bit>
+#include <span>
+
+/**
+ * Multiplication by number theoretic transforms, for operands far beyond the range where Toom-Cook pays off.
+ *
+ * The limbs are convolved modulo three primes below 2^62 whose multiplicative groups have large power of two subgroups,
+ * and the exact coefficients of the product are recovered with the Chinese remainder theorem. The primes multiply to
+ * more than 2^183, which holds any coefficient of a convolution of up to 2^55 limbs.
+ *
+ * Large transforms use the four-step layout: the data is seen as a matrix whose columns and rows are transformed
+ * separately, so every inner transform fits in the cache. Columns are gathered in blocks of whole cache lines.
+ *
+ * Like the limb kernels, nothing here allocates.
+ */
+namespace suuri::ntt
+{
+
+typedef std::span<digit_t> span_t;
+typedef std::span<const digit_t> const_span_t;
+
+//// Modular arithmetic
+
+/**
+ * A prime modulus below 2^62, with the constants needed for Montgomery arithmetic with R = 2^64.
+ */
+struct Modulus {
+	digit_t value;
+	/// -value^-1 modulo R
+	digit_t inverse;
+	/// R modulo value, which is 1 in Montgomery form
+	digit_t one;
+	/// R^2 modulo value
+	digit_t r_squared;
+	/// A generator of the multiplicative group
+	digit_t generator;
+
+	constexpr Modulus(digit_t prime, digit_t generator_) noexcept
+		: value(prime), inverse(0), one((0 - prime) % prime), r_squared(one), generator(generator_)
+	{
+		// Newton's iteration doubles the number of correct low bits, and every odd number is its own inverse modulo 8
+		digit_t x = prime;
+		for (int i = 0; i < 5; i++)
+			x *= 2 - prime * x;
+		inverse = 0 - x;
+
+		// Values are below 2^62, so doubling never overflows
+		for (size_t i = 0; i < digit_bits; i++)
+		{
+			r_squared *= 2;
+			if (r_squared >= prime)
+				r_squared -= prime;
+		}
+	}
+};
+
+/**
+ * The three primes 29 * 2^57 + 1, 69 * 2^55 + 1 and 27 * 2^56 + 1.
+ */
+inline constexpr Modulus moduli[] = {Modulus(4179340454199820289, 3), Modulus(2485986994308513793, 5), Modulus(1945555039024054273, 5)};
+
+/**
+ * The largest transform is 2^max_log_size points, limited by the power of two dividing every prime minus one.
+ */
+inline constexpr size_t max_log_size = 55;
+
+constexpr digit_t add_mod(digit_t lhs, digit_t rhs, const Modulus &modulus) noexcept
+{
+	const digit_t sum = lhs + rhs;
+	return sum >= modulus.value ? sum - modulus.value : sum;
+}
+
+constexpr digit_t sub_mod(digit_t lhs, digit_t rhs, const Modulus &modulus) noexcept
+{
+	return lhs >= rhs ? lhs - rhs : lhs + modulus.value - rhs;
+}
+
+/**
+ * @brief lhs * rhs / R modulo the prime, up to one extra multiple of the prime, so the result is below twice the prime.
+ *
+ * @pre lhs * rhs < modulus.value * R, which holds for any lhs when rhs is reduced.
+ */
+constexpr digit_t mul_mod_lazy(digit_t lhs, digit_t rhs, const Modulus &modulus) noexcept
+{
+	digit_t high;
+	const digit_t low = multiply_digits(lhs, rhs, high);
+
+	// Adding m * p clears the low limb, which carries out of it unless it was already zero
+	digit_t reduction_high;
+	multiply_digits(low * modulus.inverse, modulus.value, reduction_high);
+
+	return high + reduction_high + (low != 0);
+}
+
+/**
+ * @brief lhs * rhs / R modulo the prime. With one operand in Montgomery form, this is the ordinary product of the other.
+ *
+ * @pre lhs * rhs < modulus.value * R, which holds for any lhs when rhs is reduced.
+ */
+constexpr digit_t mul_mod(digit_t lhs, digit_t rhs, const Modulus &modulus) noexcept
+{
+	const digit_t result = mul_mod_lazy(lhs, rhs, modulus);
+	return result >= modulus.value ? result - modulus.value : result;
+}
+
+/**
+ * @return value modulo the prime, for any value.
+ */
+constexpr digit_t reduce(digit_t value, const Modulus &modulus) noexcept
+{
+	return mul_mod(value, modulus.one, modulus);
+}
+
+/**
+ * @return value * R modulo the prime, the Montgomery form of value.
+ */
+constexpr digit_t to_montgomery(digit_t value, const Modulus &modulus) noexcept
+{
+	return mul_mod(value, modulus.r_squared, modulus);
+}
+
+/**
+ * @return base^exponent, with both base and result in Montgomery form.
+ */
+constexpr digit_t pow_mod(digit_t base, uint64_t exponent, const Modulus &modulus) noexcept
+{
+	digit_t result = modulus.one;
+	for (; exponent; exponent >>= 1)
+	{
+		if (exponent & 1)
+			result = mul_mod(result, base, modulus);
+		base = mul_mod(base, base, modulus);
+	}
+
+	return result;
+}
+
+/**
+ * @return A primitive root of unity of order size, in Montgomery form.
+ * @pre size is a power of two of at most 2^max_log_size.
+ */
+constexpr digit_t root_of_unity(size_t size, const Modulus &modulus) noexcept
+{
+	return pow_mod(to_montgomery(modulus.generator, modulus), (modulus.value - 1) / size, modulus);
+}
+
+//// Transforms
+
+/**
+ * Transforms of up to this many points are done directly, larger ones use the four-step layout.
+ */
+inline constexpr size_t four_step_threshold = size_t{1} << 12;
+/**
+ * Number of columns the four-step layout gathers at a time. Eight limbs make up a 64 byte cache line.
+ */
+inline constexpr size_t block_columns = 8;
+
+/**
+ * The matrix a transform is laid out as. Element (row, column) is at row * columns + column.
+ */
+struct Layout {
+	size_t rows;
+	size_t columns;
+};
+
+/**
+ * @pre size is a power of two.
+ */
+constexpr Layout layout(size_t size) noexcept
+{
+	if (size <= four_step_threshold)
+		return {1, size};
+
+	const size_t rows = size_t{1} << (std::countr_zero(size) / 2);
+	return {rows, size / rows};
+}
+
+/**
+ * @brief Fills a table with the roots of unity of every power of two order up to roots.size(), in Montgomery form.
+ *
+ * Entry half + j is the j-th power of the root of order 2 * half, which is where the butterflies of that size find their factors.
+ *
+ * @pre roots.size() is a power of two, at least 2.
+ */
+constexpr void fill_roots(span_t roots, const Modulus &modulus) noexcept
+{
+	const size_t half = roots.size() / 2;
+	const digit_t root = root_of_unity(roots.size(), modulus);
+
+	digit_t power = modulus.one;
+	for (size_t j = 0; j < half; j++)
+	{
+		roots[half + j] = power;
+		power = mul_mod(power, root, modulus);
+	}
+
+	// Squaring the root of order 2n gives the root of order n, so the smaller tables are every other entry of the next one
+	for (size_t size = half / 2; size > 0; size /= 2)
+		for (size_t j = 0; j < size; j++)
+			roots[size + j] = roots[2 * size + 2 * j];
+	roots[0] = 0;
+}
+
+/**
+ * @brief Transforms data in place, in natural order, with an iterative radix 2 Cooley-Tukey transform.
+ *
+ * The butterflies keep their values below four times the prime rather than reducing them fully, which fits in a limb
+ * since the primes are below 2^62. Only the final values are reduced.
+ *
+ * @pre data.size() is a power of two, and roots was filled by fill_roots with at least data.size() entries.
+ */
+constexpr void forward_transform_direct(span_t data, const_span_t roots, const Modulus &modulus) noexcept
+{
+	const size_t size = data.size();
+	const digit_t twice_prime = 2 * modulus.value;
+
+	for (size_t i = 1, j = 0; i < size; i++)
+	{
+		size_t bit = size >> 1;
+		for (; j & bit; bit >>= 1)
+			j ^= bit;
+		j ^= bit;
+
+		if (i < j)
+			std::swap(data[i], data[j]);
+	}
+
+	for (size_t half = 1; half < size; half *= 2)
+	{
+		for (size_t start = 0; start < size; start += 2 * half)
+		{
+			for (size_t j = 0; j < half; j++)
+			{
+				digit_t even = data[start + j];
+				if (even >= twice_prime)
+					even -= twice_prime;
+
+				// Both are below twice the prime, so the sum and the difference offset by it stay below four times the prime
+				const digit_t odd = mul_mod_lazy(data[start + j + half], roots[half + j], modulus);
+				data[start + j] = even + odd;
+				data[start + j + half] = even + twice_prime - odd;
+			}
+		}
+	}
+
+	for (auto &value: data)
+	{
+		if (value >= twice_prime)
+			value -= twice_prime;
+		if (value >= modulus.value)
+			value -= modulus.value;
+	}
+}
+
+/**
+ * @brief The inverse of forward_transform_direct, without the division by the size.
+ *
+ * Transforming with the inverse root is the same as transforming with the root and reversing all but the first element.
+ */
+constexpr void inverse_transform_direct(span_t data, const_span_t roots, const Modulus &modulus) noexcept
+{
+	forward_transform_direct(data, roots, modulus);
+	std::reverse(data.begin() + 1, data.end());
+}
+
+/**
+ * @brief Runs operation on every column of the layout, a block of columns at a time.
+ *
+ * The blocks are shared out in contiguous runs over as many lanes as block has room for, and the runner runs the lanes.
+ *
+ * @param operation Called with the column index and the column, gathered in a contiguous span of layout.rows elements.
+ * @param block Temporary space of block_columns * layout.rows limbs per lane. A runner that runs tasks at the same time needs
+ * one lane per task it runs at once, or it can use as many lanes as there are blocks.
+ */
+template<typename Operation, typename Runner = SerialRunner>
+constexpr void for_each_column(span_t data, const Layout &layout, span_t block, Operation &&operation, const Runner &runner = {}) noexcept
+{
+	const size_t width = block_columns * layout.rows;
+	const size_t blocks = layout.columns / block_columns;
+	const size_t lanes = std::min(blocks, block.size() / width);
+	assert(lanes > 0 && "The block has no room for a lane");
+
+	runner(lanes, [&](size_t lane) {
+		auto space = block.subspan(lane * width, width);
+		for (size_t index = lane * blocks / lanes; index < (lane + 1) * blocks / lanes; index++)
+		{
+			const size_t first = index * block_columns;
+			for (size_t row = 0; row < layout.rows; row++)
+				for (size_t c = 0; c < block_columns; c++)
+					space[c * layout.rows + row] = data[row * layout.columns + first + c];
+
+			for (size_t c = 0; c < block_columns; c++)
+				operation(first + c, space.subspan(c * layout.rows, layout.rows));
+
+			for (size_t row = 0; row < layout.rows; row++)
+				for (size_t c = 0; c < block_columns; c++)
+					data[row * layout.columns + first + c] = space[c * layout.rows + row];
+		}
+	});
+}
+
+/**
+ * @brief Multiplies element k of the column by root^(k * column), with root in Montgomery form.
+ */
+constexpr void twiddle(span_t values, size_t column, digit_t root, const Modulus &modulus) noexcept
+{
+	const digit_t step = pow_mod(root, column, modulus);
+	digit_t factor = step;
+	for (size_t k = 1; k < values.size(); k++)
+	{
+		values[k] = mul_mod(values[k], factor, modulus);
+		factor = mul_mod(factor, step, modulus);
+	}
+}
+
+/**
+ * @brief Transforms data in place. The result is in the transposed order of the four-step layout, which only inverse_transform undoes.
+ *
+ * The columns and the rows of the layout are transformed independently of each other, so the runner can run them in parallel.
+ *
+ * @pre data.size() is a power of two, roots was filled by fill_roots with the larger of the layout's rows and columns,
+ * and block has room for block_columns * layout(data.size()).rows limbs per lane of for_each_column.
+ */
+template<typename Runner = SerialRunner>
+constexpr void forward_transform(span_t data, const_span_t roots, span_t block, const Modulus &modulus, const Runner &runner = {}) noexcept
+{
+	const Layout shape = layout(data.size());
+
+	if (shape.rows > 1)
+	{
+		const digit_t root = root_of_unity(data.size(), modulus);
+		for_each_column(data, shape, block, [&](size_t column, span_t values) {
+			forward_transform_direct(values, roots, modulus);
+			twiddle(values, column, root, modulus);
+		}, runner);
+	}
+
+	runner(shape.rows, [&](size_t row) { forward_transform_direct(data.subspan(row * shape.columns, shape.columns), roots, modulus); });
+}
+
+/**
+ * @brief Undoes forward_transform, and multiplies the result by scale, which is in Montgomery form.
+ *
+ * @pre The same as for forward_transform.
+ */
+template<typename Runner = SerialRunner>
+constexpr void inverse_transform(span_t data, const_span_t roots, span_t block, digit_t scale, const Modulus &modulus,
+								 const Runner &runner = {}) noexcept
+{
+	const Layout shape = layout(data.size());
+
+	runner(shape.rows, [&](size_t row) { inverse_transform_direct(data.subspan(row * shape.columns, shape.columns), roots, modulus); });
+
+	if (shape.rows == 1)
+	{
+		for (auto &value: data)
+			value = mul_mod(value, scale, modulus);
+		return;
+	}
+
+	const digit_t inverse_root = pow_mod(root_of_unity(data.size(), modulus), data.size() - 1, modulus);
+	for_each_column(data, shape, block, [&](size_t column, span_t values) {
+		twiddle(values, column, inverse_root, modulus);
+		inverse_transform_direct(values, roots, modulus);
+		for (auto &value: values)
+			value = mul_mod(value, scale, modulus);
+	}, runner);
+}
+
+//// Multiplication
+
+/**
+ * @return The number of points of the transforms used to multiply operands of these sizes.
+ */
+constexpr size_t transform_size(size_t lhs_size, size_t rhs_size) noexcept
+{
+	return std::bit_ceil(lhs_size + rhs_size - 1);
+}
+
+/**
+ * @brief Checks if the product of operands of these sizes is short enough for the transforms.
+ */
+constexpr bool fits(size_t lhs_size, size_t rhs_size) noexcept
+{
+	return lhs_size + rhs_size - 1 <= size_t{1} << max_log_size;
+}
+
+/**
+ * @brief Number of scratch limbs needed by mul.
+ *
+ * @param lanes The number of blocks of columns that can be transformed at the same time, one unless mul is given a parallel runner.
+ */
+constexpr size_t mul_scratch_size(size_t lhs_size, size_t rhs_size, size_t lanes = 1) noexcept
+{
+	const size_t size = transform_size(lhs_size, rhs_size);
+	const Layout shape = layout(size);
+
+	// The convolutions modulo the three primes, the transformed rhs, a root table and the blocks of columns
+	return 4 * size + std::max<size_t>(2, std::max(shape.rows, shape.columns)) + lanes * block_columns * shape.rows;
+}
+
+/**
+ * @brief Number of scratch limbs needed by sqr. @see mul_scratch_size
+ */
+constexpr size_t sqr_scratch_size(size_t size, size_t lanes = 1) noexcept
+{
+	return mul_scratch_size(size, size, lanes) - transform_size(size, size);
+}
+
+/**
+ * @brief values = the transform of limbs modulo the prime, zero padded to the size of values.
+ *
+ * The elementwise passes go a row of the four-step layout at a time, so the runner can spread them like the transforms.
+ *
+ * @param roots The root table, filled by fill_roots. @see forward_transform
+ * @param block Space for the blocks of columns. @see for_each_column
+ */
+template<typename Runner = SerialRunner>
+constexpr void transform_limbs(span_t values, const_span_t limbs, const_span_t roots, span_t block, const Modulus &modulus,
+							   const Runner &runner = {}) noexcept
+{
+	const Layout shape = layout(values.size());
+
+	runner(shape.rows, [&](size_t row) {
+		const size_t begin = row * shape.columns;
+		const size_t end = begin + shape.columns;
+		for (size_t i = begin; i < std::min(end, limbs.size()); i++)
+			values[i] = reduce(limbs[i], modulus);
+		std::fill(values.begin() + static_cast<ptrdiff_t>(std::clamp(limbs.size(), begin, end)), values.begin() + static_cast<ptrdiff_t>(end), 0);
+	});
+	forward_transform(values, roots, block, modulus, runner);
+}
+
+/**
+ * @brief convolution = the cyclic convolution of the two sequences whose transforms are in convolution and transformed.
+ *
+ * @param transformed May be convolution itself, to square.
+ * @param roots The root table, filled by fill_roots. @see forward_transform
+ * @param block Space for the blocks of columns. @see for_each_column
+ */
+template<typename Runner = SerialRunner>
+constexpr void multiply_transforms(span_t convolution, const_span_t transformed, const_span_t roots, span_t block,
+								   const Modulus &modulus, const Runner &runner = {}) noexcept
+{
+	const size_t size = convolution.size();
+	const Layout shape = layout(size);
+
+	runner(shape.rows, [&](size_t row) {
+		const size_t begin = row * shape.columns;
+		for (size_t i = begin; i < begin + shape.columns; i++)
+			convolution[i] = mul_mod(convolution[i], transformed[i], modulus);
+	});
+
+	// The pointwise products carry a factor 1 / R, and the inverse transform a factor size, so scale by R / size.
+	// The inverse of the size is p - (p - 1) / size, since p - 1 is a multiple of it.
+	const digit_t size_inverse = modulus.value - (modulus.value - 1) / size;
+	const digit_t scale = to_montgomery(to_montgomery(size_inverse, modulus), modulus);
+	inverse_transform(convolution, roots, block, scale, modulus, runner);
+}
+
+/**
+ * @brief convolution = the cyclic convolution of lhs and rhs modulo the prime, or of lhs with itself if rhs is empty.
+ *
+ * @param work Temporary space for the transformed rhs, the size of convolution. Not used when squaring.
+ * @param roots Space for the root table.
+ * @param block Space for the blocks of columns. @see for_each_column
+ */
+template<typename Runner = SerialRunner>
+constexpr void convolve(span_t convolution, const_span_t lhs, const_span_t rhs, span_t work, span_t roots, span_t block,
+						const Modulus &modulus, const Runner &runner = {}) noexcept
+{
+	fill_roots(roots, modulus);
+
+	transform_limbs(convolution, lhs, roots, block, modulus, runner);
+	if (!rhs.empty())
+		transform_limbs(work, rhs, roots, block, modulus, runner);
+
+	multiply_transforms(convolution, rhs.empty() ? convolution : work, roots, block, modulus, runner);
+}
+
+/**
+ * recombine cuts the coefficients in at most this many pieces, for the runner to spread.
+ */
+inline constexpr size_t recombine_pieces = 64;
+/**
+ * The pieces of recombine have at least this many coefficients, except when there are fewer in all.
+ */
+inline constexpr size_t recombine_piece_size = size_t{1} << 14;
+
+/**
+ * @brief Recovers the coefficients from begin to end of the product from their residues with Garner's algorithm, and adds them up.
+ *
+ * @param result Receives the sum of the coefficients from limb begin to limb end.
+ * @param tail Receives the two limbs the sum extends past limb end.
+ */
+constexpr void recombine_range(span_t result, const_span_t residues_0, const_span_t residues_1, const_span_t residues_2, size_t begin,
+							   size_t end, digit_t (&tail)[2]) noexcept
+{
+	constexpr const Modulus &m_0 = moduli[0];
+	constexpr const Modulus &m_1 = moduli[1];
+	constexpr const Modulus &m_2 = moduli[2];
+
+	// Inverses by Fermat's little theorem, and the other constants of Garner's algorithm in Montgomery form
+	constexpr digit_t inverse_0_mod_1 = pow_mod(to_montgomery(m_0.value, m_1), m_1.value - 2, m_1);
+	constexpr digit_t p_0_mod_2 = to_montgomery(m_0.value, m_2);
+	constexpr digit_t inverse_01_mod_2 = pow_mod(mul_mod(to_montgomery(m_0.value, m_2), to_montgomery(m_1.value, m_2), m_2), m_2.value - 2, m_2);
+
+	digit_t p_01_high = 0;
+	const digit_t p_01_low = multiply_digits(m_0.value, m_1.value, p_01_high);
+
+	// The coefficients overlap by all but one limb, so they are added into a three limb accumulator that moves up a limb at a time
+	digit_t accumulator[3] = {0, 0, 0};
+	auto accumulate = [&accumulator](digit_t low, digit_t middle, digit_t high) {
+		digit_t carry = 0;
+		accumulator[0] = add_with_carry(accumulator[0], low, carry);
+		accumulator[1] = add_with_carry(accumulator[1], middle, carry);
+		accumulator[2] = add_with_carry(accumulator[2], high, carry);
+		assert(carry == 0 && "The accumulator overflowed");
+	};
+
+	for (size_t i = begin; i < end; i++)
+	{
+		// x = r_0 + p_0 t_1 + p_0 p_1 t_2, with t_1 < p_1 and t_2 < p_2
+		const digit_t r_0 = residues_0[i];
+		const digit_t t_1 = mul_mod(sub_mod(residues_1[i], reduce(r_0, m_1), m_1), inverse_0_mod_1, m_1);
+		const digit_t partial = add_mod(reduce(r_0, m_2), mul_mod(reduce(t_1, m_2), p_0_mod_2, m_2), m_2);
+		const digit_t t_2 = mul_mod(sub_mod(residues_2[i], partial, m_2), inverse_01_mod_2, m_2);
+
+		digit_t high = 0;
+		digit_t low = multiply_add_digits(m_0.value, t_1, r_0, high);
+		accumulate(low, high, 0);
+
+		digit_t carry = 0;
+		low = multiply_add_digits(p_01_low, t_2, 0, carry);
+		const digit_t middle = multiply_add_digits(p_01_high, t_2, 0, carry);
+		accumulate(low, middle, carry);
+
+		result[i] = accumulator[0];
+		accumulator[0] = accumulator[1];
+		accumulator[1] = accumulator[2];
+		accumulator[2] = 0;
+	}
+
+	tail[0] = accumulator[0];
+	tail[1] = accumulator[1];
+}
+
+/**
+ * @brief Recovers the coefficients of the product from their residues with Garner's algorithm, and adds them up into result.
+ *
+ * The coefficients are recombined in pieces that the runner can run in parallel, after which the limbs each piece
+ * extends past its end are added into place.
+ *
+ * @pre result.size() == count + 1, where count is the number of coefficients.
+ */
+template<typename Runner = SerialRunner>
+constexpr void recombine(span_t result, const_span_t residues_0, const_span_t residues_1, const_span_t residues_2,
+						 const Runner &runner = {}) noexcept
+{
+	const size_t count = result.size() - 1;
+	const size_t pieces = std::clamp<size_t>(count / recombine_piece_size, 1, recombine_pieces);
+	auto piece_end = [&](size_t piece) { return (piece + 1) * count / pieces; };
+
+	digit_t tails[recombine_pieces][2] = {};
+	runner(pieces, [&](size_t piece) {
+		recombine_range(result, residues_0, residues_1, residues_2, piece * count / pieces, piece_end(piece), tails[piece]);
+	});
+
+	result[count] = 0;
+	for (size_t piece = 0; piece < pieces; piece++)
+	{
+		const size_t end = piece_end(piece);
+		digit_t carry = 0;
+		for (size_t i = end; i < result.size() && (i < end + 2 || carry); i++)
+			result[i] = add_with_carry(result[i], i < end + 2 ? tails[piece][i - end] : 0, carry);
+		assert(carry == 0 && (end < count || tails[piece][1] == 0) && "The product does not fit in the result");
+	}
+}
+
+/**
+ * @brief result = lhs * rhs using number theoretic transforms modulo three primes.
+ *
+ * @pre Neither operand is empty, lhs.size() + rhs.size() <= 2^max_log_size, result.size() == lhs.size() + rhs.size(),
+ * and result does not overlap the operands.
+ * @param scratch Temporary space of at least mul_scratch_size(lhs.size(), rhs.size(), lanes) limbs, for lanes as many blocks
+ * of columns as the runner transforms at the same time.
+ */
+template<typename Runner = SerialRunner>
+constexpr void mul(span_t result, const_span_t lhs, const_span_t rhs, span_t scratch, const Runner &runner = {}) noexcept
+{
+	assert(!rhs.empty() && "Use sqr to square");
+
+	const size_t size = transform_size(lhs.size(), rhs.size());
+	assert(std::countr_zero(size) <= static_cast<int>(max_log_size) && "The product is too long for the transforms");
+
+	const Layout shape = layout(size);
+	auto work = scratch.subspan(3 * size, size);
+	auto roots = scratch.subspan(4 * size, std::max<size_t>(2, std::max(shape.rows, shape.columns)));
+	auto block = scratch.subspan(4 * size + roots.size());
+
+	for (size_t i = 0; i < 3; i++)
+		convolve(scratch.subspan(i * size, size), lhs, rhs, work, roots, block, moduli[i], runner);
+
+	recombine(result, scratch.first(size), scratch.subspan(size, size), scratch.subspan(2 * size, size), runner);
+}
+
+/**
+ * @brief result = lhs * lhs using number theoretic transforms modulo three primes. Transforms the operand once per prime.
+ *
+ * @pre lhs is not empty, 2 * lhs.size() <= 2^max_log_size, result.size() == 2 * lhs.size(), and result does not overlap lhs.
+ * @param scratch Temporary space of at least sqr_scratch_size(lhs.size(), lanes) limbs. @see mul
+ */
+template<typename Runner = SerialRunner>
+constexpr void sqr(span_t result, const_span_t lhs, span_t scratch, const Runner &runner = {}) noexcept
+{
+	const size_t size = transform_size(lhs.size(), lhs.size());
+	assert(std::countr_zero(size) <= static_cast<int>(max_log_size) && "The product is too long for the transforms");
+
+	const Layout shape = layout(size);
+	auto roots = scratch.subspan(3 * size, std::max<size_t>(2, std::max(shape.rows, shape.columns)));
+	auto block = scratch.subspan(3 * size + roots.size());
+
+	for (size_t i = 0; i < 3; i++)
+		convolve(scratch.subspan(i * size, size), lhs, {}, {}, roots, block, moduli[i], runner);
+
+	recombine(result, scratch.first(size), scratch.subspan(size, size), scratch.subspan(2 * size, size), runner);
+}
+
+//// Prepared operands
+// An operand that is multiplied many times can be transformed once, modulo each prime. Each product then takes three
+// forward and three inverse transforms instead of six and three.
+
+/**
+ * @brief Number of limbs filled by prepare for operands of these sizes: the transforms of rhs modulo the three primes.
+ */
+constexpr size_t prepared_size(size_t lhs_size, size_t rhs_size) noexcept
+{
+	return 3 * transform_size(lhs_size, rhs_size);
+}
+
+/**
+ * @brief Number of scratch limbs needed by prepare and mul_prepared. @see mul_scratch_size
+ */
+constexpr size_t prepared_scratch_size(size_t lhs_size, size_t rhs_size, size_t lanes = 1) noexcept
+{
+	return mul_scratch_size(lhs_size, rhs_size, lanes) - transform_size(lhs_size, rhs_size);
+}
+
+/**
+ * @brief Transforms rhs modulo the three primes once, for products with any lhs of at most lhs_size limbs by mul_prepared.
+ *
+ * @pre rhs is not empty, lhs_size + rhs.size() <= 2^max_log_size, and prepared.size() == prepared_size(lhs_size, rhs.size()).
+ * @param scratch Temporary space of at least prepared_scratch_size(lhs_size, rhs.size(), lanes) limbs. @see mul
+ */
+template<typename Runner = SerialRunner>
+constexpr void prepare(span_t prepared, size_t lhs_size, const_span_t rhs, span_t scratch, const Runner &runner = {}) noexcept
+{
+	const size_t size = transform_size(lhs_size, rhs.size());
+	assert(std::countr_zero(size) <= static_cast<int>(max_log_size) && "The product is too long for the transforms");
+
+	// Only the root table and the blocks of columns are needed here
+	const Layout shape = layout(size);
+	auto roots = scratch.first(std::max<size_t>(2, std::max(shape.rows, shape.columns)));
+	auto block = scratch.subspan(roots.size());
+
+	for (size_t i = 0; i < 3; i++)
+	{
+		fill_roots(roots, moduli[i]);
+		transform_limbs(prepared.subspan(i * size, size), rhs, roots, block, moduli[i], runner);
+	}
+}
+
+/**
+ * @brief result = lhs * rhs using number theoretic transforms modulo three primes, where rhs was transformed by prepare.
+ *
+ * @pre prepared was filled by prepare(prepared, lhs_size, rhs), lhs is not empty, lhs.size() <= lhs_size,
+ * result.size() == lhs.size() + rhs_size, and result does not overlap lhs.
+ * @param scratch Temporary space of at least prepared_scratch_size(lhs_size, rhs_size, lanes) limbs. @see mul
+ */
+template<typename Runner = SerialRunner>
+constexpr void mul_prepared(span_t result, const_span_t lhs, const_span_t prepared, size_t lhs_size, size_t rhs_size,
+							span_t scratch, const Runner &runner = {}) noexcept
+{
+	assert(lhs.size() <= lhs_size);
+
+	// The transforms are as long as those of the longest lhs, which is long enough for any shorter one
+	const size_t size = transform_size(lhs_size, rhs_size);
+	const Layout shape = layout(size);
+	auto roots = scratch.subspan(3 * size, std::max<size_t>(2, std::max(shape.rows, shape.columns)));
+	auto block = scratch.subspan(3 * size + roots.size());
+
+	for (size_t i = 0; i < 3; i++)
+	{
+		auto convolution = scratch.subspan(i * size, size);
+		fill_roots(roots, moduli[i]);
+		transform_limbs(convolution, lhs, roots, block, moduli[i], runner);
+		multiply_transforms(convolution, prepared.subspan(i * size, size), roots, block, moduli[i], runner);
+	}
+
+	recombine(result, scratch.first(size), scratch.subspan(size, size), scratch.subspan(2 * size, size), runner);
+}
+
+}// namespace suuri::ntt
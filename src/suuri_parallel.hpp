@@ -0,0 +1,444 @@
+#pragma once
+
+#include "suuri_core.hpp"
+#include "suuri_fft.hpp"
+#include "suuri_limbs.hpp"
+#include "suuri_ntt.hpp"
+#include "suuri_thresholds.hpp"
+
+#include <algorithm>
+#include <array>
+#include <assert.h>
+#include <atomic>
+#include <span>
+#include <thread>
+#include <vector>
+
+/**
+ * Parallel multiplication.
+ *
+ * Products whose shorter operand has at least threshold limbs are spread over up to thread_count() threads. The products
+ * at the evaluation points of Toom-Cook and the chunks of unbalanced products run as separate tasks, and the FFT and NTT
+ * run the passes of their transforms as tasks. Nested tasks share the same budget of threads, so a product never runs on
+ * more threads than configured, however deep the recursion.
+ *
+ * The thread count is 1 unless set otherwise, which keeps every product on the calling thread.
+ */
+namespace suuri::parallel
+{
+
+typedef std::span<digit_t> span_t;
+typedef std::span<const digit_t> const_span_t;
+
+//// Configuration
+
+/**
+ * Products whose shorter operand has fewer limbs than this stay serial. Starting a thread takes tens of microseconds,
+ * while a product of this size takes about a millisecond even with the FFT.
+ */
+SUURI_THRESHOLD(threshold, SUURI_PARALLEL_THRESHOLD);
+
+/**
+ * @return The number of threads configured for the parallel multiplication, including the calling one.
+ */
+inline std::atomic<size_t> &configured_threads() noexcept
+{
+	static std::atomic<size_t> count{1};
+	return count;
+}
+
+/**
+ * @return The number of helper threads running tasks at the moment, across all parallel products.
+ */
+inline std::atomic<size_t> &busy_helpers() noexcept
+{
+	static std::atomic<size_t> count{0};
+	return count;
+}
+
+/**
+ * @return The number of threads products spread over, including the calling one.
+ */
+inline size_t thread_count() noexcept
+{
+	return configured_threads().load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Sets the number of threads products spread over, including the calling one.
+ *
+ * @param count The number of threads, or 0 for the number of hardware threads. 1 makes every product serial.
+ */
+inline void set_thread_count(size_t count) noexcept
+{
+	if (count == 0)
+		count = std::max<size_t>(1, std::thread::hardware_concurrency());
+
+	configured_threads().store(count, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Checks if a product of operands of these sizes is large enough to spread over threads, and more than one is configured.
+ */
+inline bool worthwhile(size_t lhs_size, size_t rhs_size) noexcept
+{
+	return thread_count() > 1 && std::min(lhs_size, rhs_size) >= threshold;
+}
+
+//// Tasks
+
+/**
+ * @brief Reserves up to wanted helper threads from the budget left by the products already running.
+ *
+ * @return The number of helper threads reserved, which are returned with release_helpers.
+ */
+inline size_t claim_helpers(size_t wanted) noexcept
+{
+	auto &busy = busy_helpers();
+	size_t current = busy.load(std::memory_order_relaxed);
+	size_t granted;
+
+	do
+	{
+		const size_t limit = thread_count() - 1;
+		granted = current < limit ? std::min(wanted, limit - current) : 0;
+		if (granted == 0)
+			return 0;
+	} while (!busy.compare_exchange_weak(current, current + granted, std::memory_order_relaxed));
+
+	return granted;
+}
+
+/**
+ * @brief Returns helper threads reserved by claim_helpers to the budget.
+ */
+inline void release_helpers(size_t count) noexcept
+{
+	busy_helpers().fetch_sub(count, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Runs task(i) for every i below count, on the calling thread and as many helper threads as the budget allows.
+ *
+ * The tasks are handed out one at a time, so tasks of different lengths balance out. Helper threads that cannot be
+ * started leave their tasks to the others.
+ */
+template<typename Task>
+void for_each(size_t count, Task &&task) noexcept
+{
+	const size_t helpers = count > 1 ? claim_helpers(count - 1) : 0;
+	if (helpers == 0)
+	{
+		for (size_t i = 0; i < count; i++)
+			task(i);
+		return;
+	}
+
+	std::atomic<size_t> next{0};
+	auto work = [&] {
+		for (size_t i = next.fetch_add(1, std::memory_order_relaxed); i < count; i = next.fetch_add(1, std::memory_order_relaxed))
+			task(i);
+	};
+
+	std::vector<std::thread> threads;
+	try
+	{
+		threads.reserve(helpers);
+		while (threads.size() < helpers)
+			threads.emplace_back(work);
+	} catch (...)
+	{
+	}
+
+	work();
+	for (auto &thread: threads)
+		thread.join();
+
+	release_helpers(helpers);
+}
+
+/**
+ * @brief The runner the transforms take, running their tasks with for_each. @see SerialRunner
+ */
+struct Runner {
+	template<typename Task>
+	void operator()(size_t count, Task &&task) const noexcept
+	{
+		for_each(count, std::forward<Task>(task));
+	}
+};
+
+//// Multiplication
+
+// Toom-Cook and the chunked products recurse into the dispatchers, which are defined below them
+inline size_t mul_scratch_size(size_t lhs_size, size_t rhs_size) noexcept;
+inline size_t sqr_scratch_size(size_t size) noexcept;
+inline void mul(span_t result, const_span_t lhs, const_span_t rhs, span_t scratch) noexcept;
+inline void sqr(span_t result, const_span_t lhs, span_t scratch) noexcept;
+
+/**
+ * @return The split of the Toom variant limbs::mul uses for operands of these sizes, with no pieces if it cuts them in chunks.
+ *
+ * @pre lhs_size >= rhs_size >= limbs::toom3_threshold.
+ */
+constexpr limbs::ToomSplit toom_split(size_t lhs_size, size_t rhs_size) noexcept
+{
+	const size_t n = lhs_size;
+	const size_t m = rhs_size;
+
+	// Toom-3 takes the same split as the five point variant of the generic Toom
+	if (m < limbs::toom4_threshold && limbs::toom3_applicable(n, m))
+		return limbs::toom_split(n, m, 5);
+	if (const auto [lhs_pieces, rhs_pieces] = limbs::unbalanced_toom_pieces(n, m); lhs_pieces != 0)
+		return limbs::toom_split_pieces(n, m, lhs_pieces, rhs_pieces);
+	if (m >= limbs::toom4_threshold && limbs::toom_applicable(n, m, limbs::toom_points(m)))
+		return limbs::toom_split(n, m, limbs::toom_points(m));
+
+	return {0, 0, 0};
+}
+
+/**
+ * @brief Number of scratch limbs needed by toom.
+ */
+inline size_t toom_scratch_size(size_t lhs_size, size_t rhs_size, const limbs::ToomSplit &split) noexcept
+{
+	const bool square = lhs_size == 0;
+	const size_t n = square ? rhs_size : std::max(lhs_size, rhs_size);
+	const size_t m = square ? rhs_size : std::min(lhs_size, rhs_size);
+	const size_t k = split.piece_size;
+	const size_t count = split.points() - 2;
+	const size_t slots = count + count % 2;
+	const size_t last_lhs = n - (split.lhs_pieces - 1) * k;
+	const size_t last_rhs = m - (split.rhs_pieces - 1) * k;
+
+	// Every product runs as a task of its own, with its own scratch
+	const size_t product_scratch = square ? std::max({sqr_scratch_size(k + 1), sqr_scratch_size(k), sqr_scratch_size(last_lhs)})
+										  : std::max({mul_scratch_size(k + 1, k + 1), mul_scratch_size(k, k), mul_scratch_size(last_lhs, last_rhs)});
+
+	// The evaluated operands at every point, a temporary for the odd pieces, the values, and the scratch of the products
+	return 2 * slots * (k + 1) + (k + 1) + count * split.value_size() + (count + 2) * product_scratch;
+}
+
+/**
+ * @brief result = lhs * rhs with a Toom multiplication that splits the operands as given, or lhs * lhs if rhs is empty.
+ *
+ * Evaluates the operands at all points first, so that the products at the points, at 0 and at infinity can run as tasks.
+ *
+ * @pre The preconditions of limbs::mul_toom.
+ * @param scratch Temporary space of at least toom_scratch_size(lhs.size(), rhs.size(), split) limbs, with 0 for lhs.size() when squaring.
+ */
+inline void toom(span_t result, const_span_t lhs_in, const_span_t rhs_in, const limbs::ToomSplit &split, span_t scratch) noexcept
+{
+	const bool square = rhs_in.empty();
+	auto lhs = lhs_in;
+	auto rhs = square ? lhs_in : rhs_in;
+	if (lhs.size() < rhs.size())
+		std::swap(lhs, rhs);
+
+	const size_t k = split.piece_size;
+	const size_t count = split.points() - 2;
+	const size_t slots = count + count % 2;
+	const size_t width = split.value_size();
+	const size_t product_scratch = (scratch.size() - 2 * slots * (k + 1) - (k + 1) - count * width) / (count + 2);
+
+	auto a_values = scratch.first(slots * (k + 1));
+	auto b_values = scratch.subspan(slots * (k + 1), slots * (k + 1));
+	auto odd = scratch.subspan(2 * slots * (k + 1), k + 1);
+	auto values = scratch.subspan(2 * slots * (k + 1) + k + 1, count * width);
+	auto products = scratch.subspan(2 * slots * (k + 1) + k + 1 + count * width);
+
+	auto a = [&](size_t i) { return a_values.subspan(i * (k + 1), k + 1); };
+	auto b = [&](size_t i) { return b_values.subspan(i * (k + 1), k + 1); };
+
+	std::array<bool, limbs::toom8h_points> negative{};
+	for (size_t i = 0; i < count; i += 2)
+	{
+		const auto x = static_cast<digit_t>(limbs::toom_point(i));
+		negative[i + 1] = limbs::toom_evaluate(a(i), a(i + 1), lhs, k, x, odd);
+		if (!square)
+			negative[i + 1] = negative[i + 1] != limbs::toom_evaluate(b(i), b(i + 1), rhs, k, x, odd);
+	}
+
+	for_each(count + 2, [&](size_t i) {
+		auto task_scratch = products.subspan(i * product_scratch, product_scratch);
+		auto product = [&](span_t target, const_span_t x, const_span_t y) {
+			if (square)
+				sqr(target, x, task_scratch);
+			else
+				mul(target, x, y, task_scratch);
+		};
+
+		if (i == count)
+		{
+			// v0 and vinf are written directly into their final place in the result
+			product(result.first(2 * k), lhs.first(k), rhs.first(k));
+		} else if (i == count + 1)
+		{
+			product(result.subspan(split.points() * k - k), lhs.subspan((split.lhs_pieces - 1) * k), rhs.subspan((split.rhs_pieces - 1) * k));
+		} else
+		{
+			auto value = values.subspan(i * width, width);
+			product(value.first(2 * k + 2), a(i), b(i));
+			std::fill(value.begin() + static_cast<ptrdiff_t>(2 * k + 2), value.end(), 0);
+			if (negative[i] && !square)
+				limbs::neg(value, value);
+		}
+	});
+
+	limbs::toom_interpolate(result, split, values);
+}
+
+/**
+ * @brief Number of scratch limbs needed by chunked.
+ */
+inline size_t chunked_scratch_size(size_t lhs_size, size_t rhs_size) noexcept
+{
+	const size_t n = std::max(lhs_size, rhs_size);
+	const size_t m = std::min(lhs_size, rhs_size);
+	const size_t chunks = (n + m - 1) / m;
+	const size_t last = n - (chunks - 1) * m;
+
+	// The products of the odd chunks, and the scratch of every product
+	return chunks / 2 * 2 * m + chunks * std::max(mul_scratch_size(m, m), mul_scratch_size(last, m));
+}
+
+/**
+ * @brief result = lhs * rhs, multiplying the shorter operand with chunks of the longer one of its own size as separate tasks.
+ *
+ * The products of the even chunks do not overlap, so they go straight into the result, and those of the odd chunks are added afterwards.
+ *
+ * @pre The preconditions of limbs::mul_chunked.
+ * @param scratch Temporary space of at least chunked_scratch_size(lhs.size(), rhs.size()) limbs.
+ */
+inline void chunked(span_t result, const_span_t lhs_in, const_span_t rhs_in, span_t scratch) noexcept
+{
+	auto lhs = lhs_in;
+	auto rhs = rhs_in;
+	if (lhs.size() < rhs.size())
+		std::swap(lhs, rhs);
+
+	const size_t n = lhs.size();
+	const size_t m = rhs.size();
+	const size_t chunks = (n + m - 1) / m;
+	auto odd_products = scratch.first(chunks / 2 * 2 * m);
+	const size_t product_scratch = (scratch.size() - odd_products.size()) / chunks;
+	auto products = scratch.subspan(odd_products.size());
+
+	auto chunk = [&](size_t i) { return lhs.subspan(i * m, std::min(m, n - i * m)); };
+	auto target = [&](size_t i) {
+		return i % 2 ? odd_products.subspan(i / 2 * 2 * m, chunk(i).size() + m) : result.subspan(i * m, chunk(i).size() + m);
+	};
+
+	for_each(chunks, [&](size_t i) { mul(target(i), chunk(i), rhs, products.subspan(i * product_scratch, product_scratch)); });
+
+	// The even products end short of the result when the last chunk is odd
+	const size_t covered = ((chunks - 1) / 2 * 2) * m + chunk((chunks - 1) / 2 * 2).size() + m;
+	std::fill(result.begin() + static_cast<ptrdiff_t>(covered), result.end(), 0);
+	for (size_t i = 1; i < chunks; i += 2)
+	{
+		auto tail = result.subspan(i * m);
+		[[maybe_unused]] const digit_t carry = limbs::add(tail, tail, target(i));
+		assert(carry == 0 && "The product does not fit in the result");
+	}
+}
+
+/**
+ * @brief Number of scratch limbs needed by mul for operands of these sizes.
+ */
+inline size_t mul_scratch_size(size_t lhs_size, size_t rhs_size) noexcept
+{
+	const size_t n = std::max(lhs_size, rhs_size);
+	const size_t m = std::min(lhs_size, rhs_size);
+
+	if (m < threshold || m < limbs::toom3_threshold)
+		return limbs::mul_scratch_size(n, m);
+	if (m >= limbs::fft_threshold && limbs::fft_usable(n, m))
+		return fft::scratch_size(n, m);
+	if (m >= limbs::ntt_threshold)
+		return ntt::fits(n, m) ? ntt::mul_scratch_size(n, m, thread_count()) : limbs::mul_scratch_size(n, m);
+	if (const limbs::ToomSplit split = toom_split(n, m); split.rhs_pieces != 0)
+		return parallel::toom_scratch_size(n, m, split);
+
+	return chunked_scratch_size(n, m);
+}
+
+/**
+ * @brief result = lhs * rhs, with the algorithm limbs::mul picks for the operand sizes, spreading its work over threads.
+ *
+ * Schönhage-Strassen, which takes over past the length of the NTT, stays serial.
+ *
+ * @pre The preconditions of limbs::mul.
+ * @param scratch Temporary space of at least mul_scratch_size(lhs.size(), rhs.size()) limbs.
+ */
+inline void mul(span_t result, const_span_t lhs_in, const_span_t rhs_in, span_t scratch) noexcept
+{
+	auto lhs = lhs_in;
+	auto rhs = rhs_in;
+	if (lhs.size() < rhs.size())
+		std::swap(lhs, rhs);
+
+	const size_t n = lhs.size();
+	const size_t m = rhs.size();
+
+	if (m < threshold || m < limbs::toom3_threshold)
+		limbs::mul(result, lhs, rhs, scratch);
+	else if (m >= limbs::fft_threshold && limbs::fft_usable(n, m))
+		fft::mul(result, lhs, rhs, fft::as_real(scratch), Runner{});
+	else if (m >= limbs::ntt_threshold && ntt::fits(n, m))
+		ntt::mul(result, lhs, rhs, scratch, Runner{});
+	else if (m >= limbs::ntt_threshold)
+		limbs::mul(result, lhs, rhs, scratch);
+	else if (const limbs::ToomSplit split = toom_split(n, m); split.rhs_pieces != 0)
+		toom(result, lhs, rhs, split, scratch);
+	else
+		chunked(result, lhs, rhs, scratch);
+}
+
+/**
+ * @return The split of the Toom variant limbs::sqr uses for an operand of this size.
+ *
+ * @pre limbs::sqr_toom3_threshold <= size < limbs::ntt_threshold.
+ */
+constexpr limbs::ToomSplit sqr_toom_split(size_t size) noexcept
+{
+	return limbs::toom_split(size, size, size < limbs::sqr_toom4_threshold ? 5 : limbs::toom_points(size));
+}
+
+/**
+ * @brief Number of scratch limbs needed by sqr for an operand of this size.
+ */
+inline size_t sqr_scratch_size(size_t size) noexcept
+{
+	if (size < threshold || size < limbs::sqr_toom3_threshold)
+		return limbs::sqr_scratch_size(size);
+	if (size >= limbs::sqr_fft_threshold && limbs::fft_usable(size, size))
+		return fft::scratch_size(size, size);
+	if (size >= limbs::ntt_threshold)
+		return ntt::fits(size, size) ? ntt::sqr_scratch_size(size, thread_count()) : limbs::sqr_scratch_size(size);
+
+	return parallel::toom_scratch_size(0, size, sqr_toom_split(size));
+}
+
+/**
+ * @brief result = lhs * lhs, with the algorithm limbs::sqr picks for the operand size, spreading its work over threads.
+ *
+ * @pre The preconditions of limbs::sqr.
+ * @param scratch Temporary space of at least sqr_scratch_size(lhs.size()) limbs.
+ */
+inline void sqr(span_t result, const_span_t lhs, span_t scratch) noexcept
+{
+	const size_t size = lhs.size();
+
+	if (size < threshold || size < limbs::sqr_toom3_threshold)
+		limbs::sqr(result, lhs, scratch);
+	else if (size >= limbs::sqr_fft_threshold && limbs::fft_usable(size, size))
+		fft::sqr(result, lhs, fft::as_real(scratch), Runner{});
+	else if (size >= limbs::ntt_threshold && ntt::fits(size, size))
+		ntt::sqr(result, lhs, scratch, Runner{});
+	else if (size >= limbs::ntt_threshold)
+		limbs::sqr(result, lhs, scratch);
+	else
+		toom(result, lhs, {}, sqr_toom_split(size), scratch);
+}
+
+}// namespace suuri::parallel
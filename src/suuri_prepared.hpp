@@ -0,0 +1,172 @@
+#pragma once
+
+#include "big_int.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace suuri
+{
+
+/**
+ * One operand of many products, transformed once.
+ *
+ * Products in the range of the FFT and the NTT spend about a third of their time transforming each operand. When the
+ * same value is multiplied again and again, as by a fixed base or a fixed matrix, a PreparedMultiplier keeps its
+ * transform, so each product only transforms the other operand and the result.
+ *
+ * The transform is made for other operands of up to a given size. Longer operands, and products too short for the
+ * transforms, are multiplied as usual.
+ */
+template<typename Allocator = std::allocator<digit_t>>
+class PreparedMultiplier
+{
+public:
+	typedef BasicBigInt<Allocator> big_int_type;
+	typedef typename big_int_type::storage_type storage_type;
+
+	/**
+	 * @param operand The value to multiply by.
+	 * @param max_size The most limbs of the other operands the transform is made for. 0 makes it for operands as long as this one.
+	 */
+	explicit PreparedMultiplier(big_int_type operand, size_t max_size = 0)
+		: operand_(std::move(operand)),
+		  max_size_(max_size != 0 ? max_size : operand_.digits().size()),
+		  real_transform_(real_allocator(operand_.get_allocator())),
+		  transform_(operand_.get_allocator())
+	{
+		const auto rhs = operand_.digits();
+		const size_t n = std::max(max_size_, rhs.size());
+		const size_t m = std::min(max_size_, rhs.size());
+
+		if (m >= limbs::fft_threshold && limbs::fft_usable(n, m))
+		{
+			method_ = Method::fft;
+			real_transform_.resize(fft::prepared_size(max_size_, rhs.size()));
+			if (parallel::worthwhile(n, m))
+				fft::prepare(real_transform_, max_size_, rhs, parallel::Runner{});
+			else
+				fft::prepare(real_transform_, max_size_, rhs);
+		} else if (m >= limbs::ntt_threshold && ntt::fits(n, m))
+		{
+			method_ = Method::ntt;
+			transform_.resize(ntt::prepared_size(max_size_, rhs.size()));
+			if (parallel::worthwhile(n, m))
+			{
+				storage_type scratch(ntt::prepared_scratch_size(max_size_, rhs.size(), parallel::thread_count()), operand_.get_allocator());
+				ntt::prepare(transform_, max_size_, rhs, scratch, parallel::Runner{});
+			} else
+			{
+				storage_type scratch(ntt::prepared_scratch_size(max_size_, rhs.size()), operand_.get_allocator());
+				ntt::prepare(transform_, max_size_, rhs, scratch);
+			}
+		}
+	}
+
+	/**
+	 * @return lhs times the prepared operand.
+	 */
+	[[nodiscard]] big_int_type multiply(const big_int_type &lhs) const
+	{
+		if (!uses_transform(lhs.digits().size()))
+			return lhs * operand_;
+
+		if (parallel::worthwhile(lhs.digits().size(), operand_.digits().size()))
+			return transform_multiplication(lhs, parallel::Runner{}, parallel::thread_count());
+
+		return transform_multiplication(lhs, SerialRunner{}, 1);
+	}
+
+	friend big_int_type operator*(const big_int_type &lhs, const PreparedMultiplier &rhs)
+	{
+		return rhs.multiply(lhs);
+	}
+	friend big_int_type operator*(const PreparedMultiplier &lhs, const big_int_type &rhs)
+	{
+		return lhs.multiply(rhs);
+	}
+
+	/**
+	 * @return The value multiplied by.
+	 */
+	[[nodiscard]] const big_int_type &operand() const noexcept
+	{
+		return operand_;
+	}
+
+	/**
+	 * @return The most limbs of the other operands the transform is made for.
+	 */
+	[[nodiscard]] size_t max_size() const noexcept
+	{
+		return max_size_;
+	}
+
+	/**
+	 * @brief Checks if products with operands of this many limbs use the prepared transform.
+	 */
+	[[nodiscard]] bool uses_transform(size_t lhs_size) const noexcept
+	{
+		const size_t m = std::min(lhs_size, operand_.digits().size());
+
+		switch (method_)
+		{
+			case Method::fft:
+				return lhs_size <= max_size_ && m >= limbs::fft_threshold;
+			case Method::ntt:
+				return lhs_size <= max_size_ && m >= limbs::ntt_threshold;
+			default:
+				return false;
+		}
+	}
+
+private:
+	typedef typename std::allocator_traits<Allocator>::template rebind_alloc<double> real_allocator;
+
+	enum class Method {
+		none,
+		fft,
+		ntt,
+	};
+
+	/**
+	 * @brief Multiplies by the prepared transform, using a single scratch allocation.
+	 * @param lanes The number of blocks of columns the runner transforms at the same time. @see ntt::mul_scratch_size
+	 */
+	template<typename Runner>
+	[[nodiscard]] big_int_type transform_multiplication(const big_int_type &lhs, const Runner &runner, size_t lanes) const
+	{
+		const auto lhs_digits = lhs.digits();
+		const auto rhs_digits = operand_.digits();
+
+		storage_type product(lhs_digits.size() + rhs_digits.size(), lhs.get_allocator());
+		if (method_ == Method::fft)
+		{
+			storage_type scratch(fft::prepared_scratch_size(max_size_, rhs_digits.size()), lhs.get_allocator());
+			fft::mul_prepared(product, lhs_digits, real_transform_, max_size_, rhs_digits.size(), fft::as_real(scratch), runner);
+		} else
+		{
+			storage_type scratch(ntt::prepared_scratch_size(max_size_, rhs_digits.size(), lanes), lhs.get_allocator());
+			ntt::mul_prepared(product, lhs_digits, transform_, max_size_, rhs_digits.size(), scratch, runner);
+		}
+
+		// Both operands are at least a transform threshold long, so the product is not zero
+		while (product.back() == 0)
+			product.pop_back();
+
+		return big_int_type(std::move(product), (lhs < 0) != (operand_ < 0));
+	}
+
+	big_int_type operand_;
+	size_t max_size_;
+	Method method_ = Method::none;
+	/// The FFT transform of the operand, with its root and twiddle tables
+	std::vector<double, real_allocator> real_transform_;
+	/// The NTT transforms of the operand modulo the three primes
+	storage_type transform_;
+};
+
+}// namespace suuri
@@ -0,0 +1,307 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace suuri
+{
+
+/**
+ * A vector that keeps up to InlineCapacity elements inside the object itself, and only allocates on the heap once it grows past that.
+ * @tparam T Element type. Must be trivially copyable, since elements are copied and zeroed without running constructors.
+ * @tparam InlineCapacity Number of elements stored without allocating.
+ * @tparam Allocator Allocator used for the heap storage. Follows the standard allocator propagation rules.
+ */
+template<typename T, size_t InlineCapacity, typename Allocator = std::allocator<T>>
+class SmallVector
+{
+	typedef std::allocator_traits<Allocator> allocator_traits;
+
+	static_assert(std::is_trivially_copyable_v<T>, "SmallVector only supports trivially copyable elements");
+	static_assert(InlineCapacity > 0, "SmallVector needs room for at least one inline element");
+
+public:
+	typedef T value_type;
+	typedef Allocator allocator_type;
+	typedef size_t size_type;
+	typedef T &reference;
+	typedef const T &const_reference;
+	typedef T *iterator;
+	typedef const T *const_iterator;
+	typedef std::reverse_iterator<iterator> reverse_iterator;
+	typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+	//// Constructors
+
+	constexpr SmallVector() noexcept(noexcept(Allocator()))
+		: SmallVector(Allocator())
+	{}
+	constexpr explicit SmallVector(const Allocator &alloc) noexcept
+		: data_(inline_), size_(0), capacity_(InlineCapacity), alloc_(alloc)
+	{}
+	/**
+	 * @param count Number of value initialised (zero) elements.
+	 */
+	constexpr explicit SmallVector(size_t count, const Allocator &alloc = Allocator())
+		: SmallVector(alloc)
+	{
+		resize(count);
+	}
+	constexpr SmallVector(std::initializer_list<T> init, const Allocator &alloc = Allocator())
+		: SmallVector(init.begin(), init.end(), alloc)
+	{}
+	template<std::input_iterator It>
+	constexpr SmallVector(It first, It last, const Allocator &alloc = Allocator())
+		: SmallVector(alloc)
+	{
+		if constexpr (std::forward_iterator<It>)
+			reserve(static_cast<size_t>(std::distance(first, last)));
+
+		for (; first != last; ++first)
+			push_back(*first);
+	}
+
+	// Copy constructor and move constructor
+
+	constexpr SmallVector(const SmallVector &rhs)
+		: SmallVector(rhs, allocator_traits::select_on_container_copy_construction(rhs.alloc_))
+	{}
+	constexpr SmallVector(const SmallVector &rhs, const Allocator &alloc)
+		: SmallVector(alloc)
+	{
+		copy_from(rhs);
+	}
+	constexpr SmallVector(SmallVector &&rhs) noexcept
+		: SmallVector(rhs.alloc_)
+	{
+		steal_from(rhs);
+	}
+	constexpr SmallVector(SmallVector &&rhs, const Allocator &alloc)
+		: SmallVector(alloc)
+	{
+		if (alloc_ == rhs.alloc_)
+			steal_from(rhs);
+		else
+			copy_from(rhs);
+	}
+
+	constexpr ~SmallVector()
+	{
+		release();
+	}
+
+	//// Operators
+
+	constexpr SmallVector &operator=(const SmallVector &rhs)
+	{
+		if (this == &rhs)
+			return *this;
+
+		if constexpr (allocator_traits::propagate_on_container_copy_assignment::value)
+		{
+			if (alloc_ != rhs.alloc_)
+				release();
+			alloc_ = rhs.alloc_;
+		}
+
+		copy_from(rhs);
+
+		return *this;
+	}
+	constexpr SmallVector &operator=(SmallVector &&rhs) noexcept(
+			allocator_traits::propagate_on_container_move_assignment::value || allocator_traits::is_always_equal::value)
+	{
+		if (this == &rhs)
+			return *this;
+
+		if constexpr (allocator_traits::propagate_on_container_move_assignment::value)
+		{
+			release();
+			alloc_ = std::move(rhs.alloc_);
+			steal_from(rhs);
+		} else if (alloc_ == rhs.alloc_)
+		{
+			release();
+			steal_from(rhs);
+		} else
+		{
+			// The storage of rhs cannot be freed with our allocator, so the elements have to be copied
+			copy_from(rhs);
+		}
+
+		return *this;
+	}
+	constexpr SmallVector &operator=(std::initializer_list<T> init)
+	{
+		size_ = 0;
+		reserve(init.size());
+		std::copy(init.begin(), init.end(), data_);
+		size_ = init.size();
+
+		return *this;
+	}
+
+	constexpr reference operator[](size_t i) noexcept { return data_[i]; }
+	constexpr const_reference operator[](size_t i) const noexcept { return data_[i]; }
+
+	constexpr bool operator==(const SmallVector &rhs) const noexcept
+	{
+		return std::equal(begin(), end(), rhs.begin(), rhs.end());
+	}
+
+	[[nodiscard]] constexpr allocator_type get_allocator() const noexcept { return alloc_; }
+
+	//// Element access and iterators
+
+	[[nodiscard]] constexpr T *data() noexcept { return data_; }
+	[[nodiscard]] constexpr const T *data() const noexcept { return data_; }
+
+	[[nodiscard]] constexpr reference back() noexcept { return data_[size_ - 1]; }
+	[[nodiscard]] constexpr const_reference back() const noexcept { return data_[size_ - 1]; }
+
+	[[nodiscard]] constexpr iterator begin() noexcept { return data_; }
+	[[nodiscard]] constexpr const_iterator begin() const noexcept { return data_; }
+	[[nodiscard]] constexpr iterator end() noexcept { return data_ + size_; }
+	[[nodiscard]] constexpr const_iterator end() const noexcept { return data_ + size_; }
+
+	[[nodiscard]] constexpr reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+	[[nodiscard]] constexpr const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+	[[nodiscard]] constexpr reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+	[[nodiscard]] constexpr const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+	//// Capacity
+
+	[[nodiscard]] constexpr size_t size() const noexcept { return size_; }
+	[[nodiscard]] constexpr bool empty() const noexcept { return size_ == 0; }
+	[[nodiscard]] constexpr size_t capacity() const noexcept { return capacity_; }
+
+	/**
+	 * @brief Checks if the elements are currently stored inside the object rather than on the heap.
+	 */
+	[[nodiscard]] constexpr bool is_inline() const noexcept { return data_ == inline_; }
+
+	constexpr void reserve(size_t new_capacity)
+	{
+		if (new_capacity <= capacity_)
+			return;
+
+		T *new_data = allocator_traits::allocate(alloc_, new_capacity);
+		std::copy(data_, data_ + size_, new_data);
+
+		release();
+		data_ = new_data;
+		capacity_ = new_capacity;
+	}
+
+	//// Modifiers
+
+	constexpr void clear() noexcept { size_ = 0; }
+
+	constexpr void push_back(const T &value)
+	{
+		if (size_ == capacity_)
+		{
+			// value might live in our own storage, so read it before growing
+			T copy = value;
+			grow(size_ + 1);
+			data_[size_++] = copy;
+			return;
+		}
+
+		data_[size_++] = value;
+	}
+
+	constexpr void pop_back() noexcept { size_--; }
+
+	/**
+	 * @brief Resizes the vector. New elements are value initialised (zero).
+	 */
+	constexpr void resize(size_t new_size)
+	{
+		resize(new_size, T());
+	}
+	constexpr void resize(size_t new_size, T value)
+	{
+		if (new_size > capacity_)
+			grow(new_size);
+		if (new_size > size_)
+			std::fill(data_ + size_, data_ + new_size, value);
+
+		size_ = new_size;
+	}
+
+	constexpr iterator erase(const_iterator first, const_iterator last) noexcept
+	{
+		auto *dest = data_ + (first - data_);
+		std::copy(last, const_iterator(end()), dest);
+		size_ -= static_cast<size_t>(last - first);
+
+		return dest;
+	}
+
+	constexpr void swap(SmallVector &rhs)
+	{
+		SmallVector temp(std::move(rhs));
+		rhs = std::move(*this);
+		*this = std::move(temp);
+	}
+
+private:
+	T *data_;
+	size_t size_;
+	size_t capacity_;
+	T inline_[InlineCapacity]{};
+	[[no_unique_address]] Allocator alloc_;
+
+	/// Helper methods
+
+	constexpr void grow(size_t min_capacity)
+	{
+		reserve(std::max(min_capacity, capacity_ * 2));
+	}
+
+	constexpr void release() noexcept
+	{
+		if (!is_inline())
+			allocator_traits::deallocate(alloc_, data_, capacity_);
+
+		data_ = inline_;
+		capacity_ = InlineCapacity;
+	}
+
+	constexpr void copy_from(const SmallVector &rhs)
+	{
+		size_ = 0;
+		reserve(rhs.size_);
+		std::copy(rhs.begin(), rhs.end(), data_);
+		size_ = rhs.size_;
+	}
+
+	/**
+	 * @brief Takes over the contents of rhs, leaving it empty. Heap storage is taken over directly, inline storage is copied.
+	 * @pre This object owns no heap storage, and its allocator can free the storage of rhs.
+	 */
+	constexpr void steal_from(SmallVector &rhs) noexcept
+	{
+		if (rhs.is_inline())
+		{
+			std::copy(rhs.begin(), rhs.end(), inline_);
+		} else
+		{
+			data_ = rhs.data_;
+			capacity_ = rhs.capacity_;
+			rhs.data_ = rhs.inline_;
+			rhs.capacity_ = InlineCapacity;
+		}
+
+		size_ = rhs.size_;
+		rhs.size_ = 0;
+	}
+};
+
+}// namespace suuri
@@ -0,0 +1,116 @@
+#pragma once
+
+/**
+ * The operand sizes, in limbs, at which the multiplication, squaring, short product, division and conversion algorithms
+ * take over from each other.
+ *
+ * The defaults were measured on x86-64 CPUs with AVX-512. Running suuri_tune measures the crossovers of the machine it
+ * runs on and writes them to suuri_tuned_thresholds.hpp, which replaces the defaults when it is next to this header or on
+ * the include path. A single threshold can also be set by defining its macro before including Suuri.
+ */
+#if __has_include("suuri_tuned_thresholds.hpp")
+#include "suuri_tuned_thresholds.hpp"
+#endif
+
+/// Multiplication
+
+#ifndef SUURI_SIMD_BASECASE_THRESHOLD
+#define SUURI_SIMD_BASECASE_THRESHOLD 16
+#endif
+#ifndef SUURI_KARATSUBA_THRESHOLD
+#define SUURI_KARATSUBA_THRESHOLD 32
+#endif
+#ifndef SUURI_TOOM3_THRESHOLD
+#define SUURI_TOOM3_THRESHOLD 128
+#endif
+#ifndef SUURI_TOOM4_THRESHOLD
+#define SUURI_TOOM4_THRESHOLD 400
+#endif
+#ifndef SUURI_TOOM6H_THRESHOLD
+#define SUURI_TOOM6H_THRESHOLD 1400
+#endif
+#ifndef SUURI_TOOM8H_THRESHOLD
+#define SUURI_TOOM8H_THRESHOLD 4000
+#endif
+#ifndef SUURI_NTT_THRESHOLD
+#define SUURI_NTT_THRESHOLD 15000
+#endif
+#ifndef SUURI_FFT_THRESHOLD
+#define SUURI_FFT_THRESHOLD 1500
+#endif
+#ifndef SUURI_PARALLEL_THRESHOLD
+#define SUURI_PARALLEL_THRESHOLD 4000
+#endif
+
+/// Squaring
+
+#ifndef SUURI_SQR_KARATSUBA_THRESHOLD
+#define SUURI_SQR_KARATSUBA_THRESHOLD 40
+#endif
+#ifndef SUURI_SQR_TOOM3_THRESHOLD
+#define SUURI_SQR_TOOM3_THRESHOLD 224
+#endif
+#ifndef SUURI_SQR_TOOM4_THRESHOLD
+#define SUURI_SQR_TOOM4_THRESHOLD 900
+#endif
+#ifndef SUURI_SQR_FFT_THRESHOLD
+#define SUURI_SQR_FFT_THRESHOLD 1300
+#endif
+
+/// Short and middle products
+
+#ifndef SUURI_MULLO_DC_THRESHOLD
+#define SUURI_MULLO_DC_THRESHOLD 16
+#endif
+#ifndef SUURI_MULHI_DC_THRESHOLD
+#define SUURI_MULHI_DC_THRESHOLD 24
+#endif
+#ifndef SUURI_SHORT_PRODUCT_FULL_THRESHOLD
+#define SUURI_SHORT_PRODUCT_FULL_THRESHOLD 2500
+#endif
+#ifndef SUURI_MULMID_KARATSUBA_THRESHOLD
+#define SUURI_MULMID_KARATSUBA_THRESHOLD 40
+#endif
+
+/// Division and conversion
+
+#ifndef SUURI_DIV_DC_THRESHOLD
+#define SUURI_DIV_DC_THRESHOLD 40
+#endif
+#ifndef SUURI_FROM_STRING_DC_THRESHOLD
+#define SUURI_FROM_STRING_DC_THRESHOLD 600
+#endif
+#ifndef SUURI_TO_STRING_DC_THRESHOLD
+#define SUURI_TO_STRING_DC_THRESHOLD 40
+#endif
+
+/**
+ * suuri_tune defines SUURI_TUNING, which turns the thresholds into variables so it can move one crossover at a time
+ * between measurements. Everywhere else they are compile time constants.
+ */
+#ifdef SUURI_TUNING
+#include <cstddef>
+#include <type_traits>
+
+namespace suuri
+{
+
+/**
+ * @brief A threshold suuri_tune can change at run time. Constant evaluation, which cannot read it, uses the default.
+ */
+template<size_t Default>
+struct TunableThreshold {
+	size_t value = Default;
+
+	constexpr operator size_t() const noexcept
+	{
+		return std::is_constant_evaluated() ? Default : value;
+	}
+};
+
+}// namespace suuri
+
+#define SUURI_THRESHOLD(name, value) inline TunableThreshold<value> name
+#else
+#define SUURI_THRESHOLD(name, value) constexpr size_t name = value
+#endif
@@ -0,0 +1,504 @@
+#include <gtest/gtest.h>
+
+#include <suuri_fft.hpp>
+#include <suuri_ifma.hpp>
+#include <suuri_limbs.hpp>
+#include <suuri_ntt.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace su = suuri;
+namespace limbs = suuri::limbs;
+namespace ifma = suuri::ifma;
+
+namespace
+{
+
+constexpr su::digit_t max_digit = std::numeric_limits<su::digit_t>::max();
+
+std::vector<su::digit_t> random_limbs(size_t n, std::mt19937_64 &gen)
+{
+	std::vector<su::digit_t> ret(n);
+	for (auto &limb: ret)
+		limb = gen();
+	return ret;
+}
+
+}// namespace
+
+TEST(CoreLimbs, Compare)
+{
+	const std::vector<su::digit_t> a = {1, 2};
+	const std::vector<su::digit_t> b = {1, 2, 0, 0};
+	const std::vector<su::digit_t> c = {0, 0, 1};
+
+	EXPECT_EQ(limbs::cmp(a, b), std::strong_ordering::equal);
+	EXPECT_EQ(limbs::cmp(a, c), std::strong_ordering::less);
+	EXPECT_EQ(limbs::cmp(c, b), std::strong_ordering::greater);
+	EXPECT_EQ(limbs::cmp(b, std::vector<su::digit_t>{2, 1}), std::strong_ordering::greater);
+}
+
+TEST(CoreLimbs, AddSubtract)
+{
+	std::vector<su::digit_t> a = {max_digit, max_digit, 5};
+	const std::vector<su::digit_t> one = {1};
+	std::vector<su::digit_t> result(3);
+
+	EXPECT_EQ(limbs::add(result, a, one), 0);
+	EXPECT_EQ(result, (std::vector<su::digit_t>{0, 0, 6}));
+	EXPECT_EQ(limbs::sub(result, result, one), 0);
+	EXPECT_EQ(result, a);
+
+	// The carry and borrow come out of the top limb
+	a = {max_digit, max_digit};
+	result.resize(2);
+	EXPECT_EQ(limbs::add_1(result, a, 1), 1);
+	EXPECT_EQ(result, (std::vector<su::digit_t>{0, 0}));
+	EXPECT_EQ(limbs::sub_1(result, result, 1), 1);
+	EXPECT_EQ(result, a);
+
+	std::mt19937_64 gen(1);
+	for (int i = 0; i < 20; i++)
+	{
+		const auto x = random_limbs(8, gen);
+		const auto y = random_limbs(8, gen);
+		std::vector<su::digit_t> sum(8);
+		std::vector<su::digit_t> back(8);
+
+		const auto carry = limbs::add_n(sum, x, y);
+		EXPECT_EQ(limbs::sub_n(back, sum, y), carry);
+		EXPECT_EQ(back, x);
+
+		// Negating twice gives the value back
+		limbs::neg(back, back);
+		limbs::neg(back, back);
+		EXPECT_EQ(back, x);
+	}
+}
+
+TEST(CoreLimbs, MultiplyBySingleLimb)
+{
+	std::mt19937_64 gen(2);
+	for (int i = 0; i < 20; i++)
+	{
+		const auto x = random_limbs(6, gen);
+		const auto y = random_limbs(6, gen);
+		const su::digit_t digit = gen();
+
+		std::vector<su::digit_t> product(6);
+		const auto high = limbs::mul_1(product, x, digit);
+
+		// addmul_1 followed by submul_1 gives the value back, with the same carry out
+		auto z = y;
+		const auto carry = limbs::addmul_1(z, x, digit);
+		EXPECT_EQ(limbs::submul_1(z, x, digit), carry);
+		EXPECT_EQ(z, y);
+
+		// Dividing the product gives x back, with no remainder
+		product.push_back(high);
+		std::vector<su::digit_t> quotient(7);
+		EXPECT_EQ(limbs::divrem_1(quotient, product, digit), 0);
+		EXPECT_EQ(quotient.back(), 0);
+		EXPECT_EQ(std::vector<su::digit_t>(quotient.begin(), quotient.end() - 1), x);
+	}
+}
+
+TEST(CoreLimbs, MultiplyAndSquare)
+{
+	std::mt19937_64 gen(3);
+	for (size_t n = 1; n < 40; n++)
+	{
+		const auto x = random_limbs(n, gen);
+		const auto y = random_limbs(n / 2 + 1, gen);
+
+		std::vector<su::digit_t> expected(2 * n);
+		std::vector<su::digit_t> result(2 * n);
+		limbs::mul_basecase(expected, x, x);
+		limbs::sqr_basecase(result, x);
+		EXPECT_EQ(result, expected);
+
+		expected.resize(x.size() + y.size());
+		result.resize(x.size() + y.size());
+		std::vector<su::digit_t> scratch(limbs::karatsuba_scratch_size(n));
+		limbs::mul_basecase(expected, x, y);
+		limbs::mul_karatsuba(result, x, y, scratch);
+		EXPECT_EQ(result, expected);
+	}
+
+	// The largest square is one below the top limb overflowing
+	const std::vector<su::digit_t> x(5, max_digit);
+	std::vector<su::digit_t> result(10);
+	limbs::sqr_basecase(result, x);
+	EXPECT_EQ(result[0], 1);
+	EXPECT_EQ(result[9], max_digit);
+}
+
+TEST(CoreLimbs, VectorisedBasecase)
+{
+	std::mt19937_64 gen(4);
+
+	// Sizes around the threshold and the tile size, against rows of addmul_1
+	const size_t sizes[] = {1, 15, 16, 17, 31, 32, 33, 64, 65, 100};
+	for (size_t n: sizes)
+	{
+		for (size_t m: sizes)
+		{
+			for (int fill = 0; fill < 2; fill++)
+			{
+				const auto x = fill ? random_limbs(n, gen) : std::vector<su::digit_t>(n, max_digit);
+				const auto y = fill ? random_limbs(m, gen) : std::vector<su::digit_t>(m, max_digit);
+
+				std::vector<su::digit_t> expected(n + m);
+				for (size_t i = 0; i < n; i++)
+					expected[i + m] = limbs::addmul_1(std::span(expected).subspan(i, m), y, x[i]);
+
+				std::vector<su::digit_t> result(n + m);
+				limbs::mul_basecase(result, x, y);
+				EXPECT_EQ(result, expected) << "Sizes " << n << " and " << m;
+			}
+		}
+	}
+}
+
+TEST(CoreLimbs, Shifts)
+{
+	std::mt19937_64 gen(4);
+	for (unsigned count = 1; count < su::digit_bits; count += 7)
+	{
+		auto x = random_limbs(5, gen);
+		const auto original = x;
+
+		const auto out = limbs::lshift(x, x, count);
+		EXPECT_EQ(out, original.back() >> (su::digit_bits - count));
+
+		// Shifting back restores everything but the bits shifted out of the top
+		limbs::rshift(x, x, count);
+		x.back() |= out << (su::digit_bits - count);
+		EXPECT_EQ(x, original);
+	}
+}
+
+TEST(CoreLimbs, Divrem)
+{
+	std::mt19937_64 gen(8);
+
+	// Sizes on both sides of the divide and conquer threshold, with quotients shorter and longer than the divisor
+	const size_t sizes[] = {1, 2, 3, 17, limbs::div_dc_threshold - 1, limbs::div_dc_threshold, 100, 250};
+	for (size_t n: sizes)
+	{
+		for (size_t m: sizes)
+		{
+			if (m > n)
+				continue;
+
+			for (int fill = 0; fill < 3; fill++)
+			{
+				// All bits set makes the quotient estimates hit their corrections, and short top limbs need the most shifting
+				auto x = fill == 1 ? std::vector<su::digit_t>(n, max_digit) : random_limbs(n, gen);
+				auto y = fill == 1 ? std::vector<su::digit_t>(m, max_digit) : random_limbs(m, gen);
+				if (fill == 2)
+					y.back() >>= gen() % 64;
+				y.back() |= 1;
+
+				std::vector<su::digit_t> quotient(n - m + 1);
+				std::vector<su::digit_t> remainder(m);
+				std::vector<su::digit_t> scratch(limbs::divrem_scratch_size(n, m));
+				limbs::divrem(quotient, remainder, x, y, scratch);
+				EXPECT_EQ(limbs::cmp(remainder, y), std::strong_ordering::less) << "Sizes " << n << " and " << m;
+
+				// quotient * y + remainder gives x back
+				std::vector<su::digit_t> product(quotient.size() + m);
+				limbs::mul_basecase(product, quotient, y);
+				EXPECT_EQ(limbs::add(product, product, remainder), 0u);
+				EXPECT_EQ(std::vector<su::digit_t>(product.begin(), product.begin() + static_cast<ptrdiff_t>(n)), x)
+						<< "Sizes " << n << " and " << m;
+				EXPECT_EQ(product.back(), 0u);
+			}
+		}
+	}
+}
+
+TEST(CoreLimbs, ShortProducts)
+{
+	std::mt19937_64 gen(9);
+
+	// Sizes on both sides of the divide and conquer thresholds, and one where both take half of the full product
+	const size_t sizes[] = {1, 2, 3, 5, limbs::mullo_dc_threshold - 1, limbs::mullo_dc_threshold, limbs::mulhi_dc_threshold + 1, 100, 333,
+							limbs::short_product_full_threshold};
+	for (size_t n: sizes)
+	{
+		for (int fill = 0; fill < 2; fill++)
+		{
+			const auto x = fill == 1 ? std::vector<su::digit_t>(n, max_digit) : random_limbs(n, gen);
+			const auto y = fill == 1 ? std::vector<su::digit_t>(n, max_digit) : random_limbs(n, gen);
+			std::vector<su::digit_t> product(2 * n);
+			std::vector<su::digit_t> scratch(limbs::mul_scratch_size(n, n));
+			limbs::mul(product, x, y, scratch);
+
+			std::vector<su::digit_t> low(n);
+			scratch.assign(limbs::mullo_scratch_size(n), 0);
+			limbs::mullo(low, x, y, scratch);
+			EXPECT_EQ(low, std::vector<su::digit_t>(product.begin(), product.begin() + static_cast<ptrdiff_t>(n))) << "Size " << n;
+
+			// The high half is at most n below the exact one, and never above it
+			std::vector<su::digit_t> high(n);
+			scratch.assign(limbs::mulhi_scratch_size(n), 0);
+			limbs::mulhi(high, x, y, scratch);
+			std::vector<su::digit_t> error(n);
+			EXPECT_EQ(limbs::sub_n(error, std::span(product).subspan(n), high), 0u) << "Size " << n;
+			EXPECT_EQ(limbs::cmp(error, std::vector<su::digit_t>{n}), std::strong_ordering::less) << "Size " << n;
+		}
+	}
+}
+
+TEST(CoreLimbs, MiddleProduct)
+{
+	std::mt19937_64 gen(10);
+
+	// The columns where every limb of y takes part, without the carries of the ones below
+	const std::vector<su::digit_t> x = {max_digit, 1, 2, max_digit};
+	const std::vector<su::digit_t> y = {3, max_digit};
+	std::vector<su::digit_t> result(x.size() - y.size() + 3);
+	limbs::mulmid_basecase(result, x, y);
+	// Columns 1 to 3: 1 * 3 + max * max, 2 * 3 + 1 * max and max * 3 + 2 * max
+	std::vector<su::digit_t> expected(result.size());
+	for (size_t column = 0; column < 3; column++)
+	{
+		for (size_t j = 0; j < y.size(); j++)
+		{
+			su::digit_t high;
+			const su::digit_t low = su::multiply_digits(x[column + 1 - j], y[j], high);
+			const std::vector<su::digit_t> partial = {low, high};
+			limbs::add(std::span(expected).subspan(column), std::span(expected).subspan(column), partial);
+		}
+	}
+	EXPECT_EQ(result, expected);
+
+	// Square, wider and narrower middle products, with even and odd sizes around the transposed Karatsuba threshold
+	const size_t threshold = limbs::mulmid_karatsuba_threshold;
+	for (size_t m: {threshold - 1, threshold, threshold + 1, 2 * threshold, 3 * threshold + 1})
+	{
+		for (size_t columns: {size_t{1}, m / 2, m, m + 1, 2 * m + 3})
+		{
+			for (int fill = 0; fill < 2; fill++)
+			{
+				const auto lhs = fill == 1 ? std::vector<su::digit_t>(m + columns - 1, max_digit) : random_limbs(m + columns - 1, gen);
+				const auto rhs = fill == 1 ? std::vector<su::digit_t>(m, max_digit) : random_limbs(m, gen);
+				std::vector<su::digit_t> basecase(columns + 2);
+				limbs::mulmid_basecase(basecase, lhs, rhs);
+
+				std::vector<su::digit_t> fast(columns + 2);
+				std::vector<su::digit_t> scratch(limbs::mulmid_scratch_size(lhs.size(), m));
+				limbs::mulmid(fast, lhs, rhs, scratch);
+				EXPECT_EQ(fast, basecase) << "Sizes " << lhs.size() << " and " << m;
+			}
+		}
+	}
+}
+
+TEST(CoreLimbs, BarrettReduction)
+{
+	std::mt19937_64 gen(11);
+
+	for (size_t k: {1, 2, 7, 40, 150})
+	{
+		for (int fill = 0; fill < 3; fill++)
+		{
+			// A power of B is the modulus with the largest inverse
+			auto modulus = random_limbs(k, gen);
+			if (fill == 2)
+			{
+				std::fill(modulus.begin(), modulus.end(), 0);
+				modulus.back() = 1;
+			}
+			modulus.back() |= 1;
+
+			std::vector<su::digit_t> inverse(k + 1);
+			std::vector<su::digit_t> scratch(std::max(limbs::barrett_inverse_scratch_size(k), limbs::barrett_reduce_scratch_size(k)));
+			limbs::barrett_inverse(inverse, modulus, scratch);
+
+			const auto value = fill == 1 ? std::vector<su::digit_t>(2 * k, max_digit) : random_limbs(2 * k, gen);
+			std::vector<su::digit_t> result(k);
+			limbs::barrett_reduce(result, value, modulus, inverse, scratch);
+
+			std::vector<su::digit_t> quotient(k + 1);
+			std::vector<su::digit_t> remainder(k);
+			scratch.assign(limbs::divrem_scratch_size(2 * k, k), 0);
+			limbs::divrem(quotient, remainder, value, modulus, scratch);
+			EXPECT_EQ(result, remainder) << "Size " << k;
+		}
+	}
+}
+
+TEST(CoreLimbs, PreparedTransforms)
+{
+	std::mt19937_64 gen(12);
+
+	// The transform is made for lhs of up to lhs_size limbs, and also works for shorter ones
+	for (auto [lhs_size, rhs_size]: {std::pair<size_t, size_t>{1, 1}, {5, 3}, {64, 64}, {300, 700}, {2000, 1500}})
+	{
+		const auto rhs = random_limbs(rhs_size, gen);
+		std::vector<su::digit_t> ntt_prepared(su::ntt::prepared_size(lhs_size, rhs_size));
+		std::vector<su::digit_t> ntt_scratch(su::ntt::prepared_scratch_size(lhs_size, rhs_size));
+		su::ntt::prepare(ntt_prepared, lhs_size, rhs, ntt_scratch);
+
+		std::vector<double> fft_prepared(su::fft::prepared_size(lhs_size, rhs_size));
+		std::vector<double> fft_scratch(su::fft::prepared_scratch_size(lhs_size, rhs_size));
+		su::fft::prepare(fft_prepared, lhs_size, rhs);
+
+		for (size_t size: {lhs_size, (lhs_size + 1) / 2})
+		{
+			const auto lhs = size == lhs_size ? std::vector<su::digit_t>(size, max_digit) : random_limbs(size, gen);
+			std::vector<su::digit_t> expected(size + rhs_size);
+			std::vector<su::digit_t> scratch(limbs::mul_scratch_size(size, rhs_size));
+			limbs::mul(expected, lhs, rhs, scratch);
+
+			std::vector<su::digit_t> result(size + rhs_size);
+			su::ntt::mul_prepared(result, lhs, ntt_prepared, lhs_size, rhs_size, ntt_scratch);
+			EXPECT_EQ(result, expected) << "NTT sizes " << size << " and " << rhs_size;
+
+			su::fft::mul_prepared(result, lhs, fft_prepared, lhs_size, rhs_size, fft_scratch);
+			EXPECT_EQ(result, expected) << "FFT sizes " << size << " and " << rhs_size;
+		}
+	}
+}
+
+TEST(CoreLimbs, Radix52RoundTrip)
+{
+	std::mt19937_64 gen(5);
+
+	for (size_t n: {1, 2, 13, 14, 40})
+	{
+		const auto x = random_limbs(n, gen);
+		std::vector<su::digit_t> digits(ifma::radix52_size(n) + 1, max_digit);
+		ifma::to_radix52(digits, x);
+		for (auto digit: digits)
+			EXPECT_LE(digit, ifma::radix_mask);
+		EXPECT_EQ(digits.back(), 0u);
+
+		std::vector<su::digit_t> back(n + 1, max_digit);
+		ifma::from_radix52(back, digits);
+		EXPECT_EQ(std::vector<su::digit_t>(back.begin(), back.end() - 1), x) << "Size " << n;
+		EXPECT_EQ(back.back(), 0u);
+	}
+}
+
+TEST(CoreLimbs, IfmaMultiplication)
+{
+	std::mt19937_64 gen(6);
+
+	// The emulation runs everywhere, and the hardware kernels have to agree with it where the CPU has them
+	std::vector<ifma::Backend> backends = {ifma::Backend::emulated};
+	if (ifma::usable())
+		backends.push_back(ifma::Backend::ifma);
+
+	const size_t sizes[] = {1, 2, 7, 31, 32, 33, 70};
+	for (auto backend: backends)
+	{
+		for (size_t n: sizes)
+		{
+			for (size_t m: sizes)
+			{
+				for (int fill = 0; fill < 2; fill++)
+				{
+					const auto x = fill ? random_limbs(n, gen) : std::vector<su::digit_t>(n, max_digit);
+					const auto y = fill ? random_limbs(m, gen) : std::vector<su::digit_t>(m, max_digit);
+
+					std::vector<su::digit_t> expected(n + m);
+					limbs::mul_basecase(expected, x, y);
+
+					std::vector<su::digit_t> result(n + m);
+					ifma::mul(result, x, y, backend);
+					EXPECT_EQ(result, expected) << "Sizes " << n << " and " << m;
+				}
+			}
+
+			const auto x = random_limbs(n, gen);
+			std::vector<su::digit_t> expected(2 * n);
+			limbs::mul_basecase(expected, x, x);
+
+			std::vector<su::digit_t> result(2 * n);
+			ifma::sqr(result, x, backend);
+			EXPECT_EQ(result, expected) << "Size " << n;
+		}
+	}
+}
+
+TEST(CoreLimbs, IfmaBackendsAgree)
+{
+	std::mt19937_64 gen(12);
+
+	// The emulation is forced on one side, so the backend picked by default, hardware or not, has to give the same limbs
+	for (size_t n: {1, 5, 32, 33, 97})
+	{
+		for (size_t m: {1, 19, 32, 64})
+		{
+			const auto x = random_limbs(n, gen);
+			const auto y = random_limbs(m, gen);
+
+			std::vector<su::digit_t> emulated(n + m);
+			std::vector<su::digit_t> best(n + m);
+			ifma::mul(emulated, x, y, ifma::Backend::emulated);
+			ifma::mul(best, x, y, ifma::best_backend());
+			EXPECT_EQ(best, emulated) << "Sizes " << n << " and " << m;
+		}
+
+		const auto x = random_limbs(n, gen);
+		std::vector<su::digit_t> emulated(2 * n);
+		std::vector<su::digit_t> best(2 * n);
+		ifma::sqr(emulated, x, ifma::Backend::emulated);
+		ifma::sqr(best, x, ifma::best_backend());
+		EXPECT_EQ(best, emulated) << "Size " << n;
+	}
+}
+
+TEST(CoreLimbs, IfmaMontgomery)
+{
+	std::mt19937_64 gen(7);
+
+	std::vector<ifma::Backend> backends = {ifma::Backend::emulated};
+	if (ifma::usable())
+		backends.push_back(ifma::Backend::ifma);
+
+	// Moduli whose top digit is nearly full or nearly empty, of sizes around the 8 digit vectors
+	for (size_t size: {size_t{1}, size_t{2}, size_t{8}, size_t{9}, size_t{40}, ifma::montgomery_max_digits})
+	{
+		for (int fill = 0; fill < 2; fill++)
+		{
+			std::vector<su::digit_t> modulus(size);
+			for (auto &digit: modulus)
+				digit = fill ? gen() & ifma::radix_mask : ifma::radix_mask;
+			modulus[0] |= 1;
+			// The top digit keeps a spare bit, as montgomery_size asks for
+			modulus.back() = fill ? std::max<su::digit_t>(modulus.back() >> 40, 1) : ifma::radix_mask >> 1;
+			const su::digit_t inverse = ifma::montgomery_inverse(modulus[0]);
+			EXPECT_EQ(inverse * modulus[0] & ifma::radix_mask, ifma::radix_mask) << "Size " << size;
+
+			// lhs is below the modulus, so x * R^2 / R is x * R, and times 1 / R gives x back
+			std::vector<su::digit_t> lhs(modulus);
+			lhs[0]--;
+			std::vector<su::digit_t> r_squared(size);
+			ifma::montgomery_r_squared(r_squared, modulus);
+
+			std::vector<su::digit_t> one(size);
+			one[0] = 1;
+			std::vector<std::vector<su::digit_t>> results;
+			for (auto backend: backends)
+			{
+				std::vector<su::digit_t> result(size);
+				ifma::montgomery_mul(result, lhs, r_squared, modulus, inverse, backend);
+				ifma::montgomery_mul(result, result, result, modulus, inverse, backend);
+				ifma::montgomery_mul(result, result, one, modulus, inverse, backend);
+				results.push_back(result);
+			}
+
+			// (m - 1)^2 is 1 modulo m
+			EXPECT_EQ(results[0], one) << "Size " << size;
+			for (const auto &result: results)
+				EXPECT_EQ(result, results[0]) << "Size " << size;
+		}
+	}
+}
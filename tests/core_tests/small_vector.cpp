@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include <suuri_small_vector.hpp>
+
+#include <cstdint>
+
+namespace su = suuri;
+
+TEST(CoreSmallVector, InlineStorage)
+{
+	// Up to the inline capacity, no heap storage should be used
+	su::SmallVector<uint64_t, 2> a;
+	EXPECT_TRUE(a.empty());
+	EXPECT_TRUE(a.is_inline());
+
+	a.push_back(1);
+	a.push_back(2);
+	EXPECT_EQ(a.size(), 2);
+	EXPECT_TRUE(a.is_inline());
+
+	su::SmallVector<uint64_t, 2> b = {3};
+	EXPECT_TRUE(b.is_inline());
+	EXPECT_EQ(b[0], 3);
+
+	// Moving inline storage copies the elements
+	su::SmallVector<uint64_t, 2> c = std::move(a);
+	EXPECT_TRUE(c.is_inline());
+	EXPECT_EQ(c, (su::SmallVector<uint64_t, 2>{1, 2}));
+	EXPECT_TRUE(a.empty());
+}
+
+TEST(CoreSmallVector, HeapStorage)
+{
+	// Growing past the inline capacity moves the elements to the heap
+	su::SmallVector<uint64_t, 2> a = {1, 2};
+	a.push_back(3);
+	EXPECT_FALSE(a.is_inline());
+	EXPECT_EQ(a, (su::SmallVector<uint64_t, 2>{1, 2, 3}));
+
+	// Pushing back an element of the vector itself while growing
+	a.resize(a.capacity());
+	a.push_back(a[0]);
+	EXPECT_EQ(a.back(), 1);
+
+	// Resizing zero initialises new elements
+	a.resize(100);
+	EXPECT_EQ(a.size(), 100);
+	EXPECT_EQ(a[99], 0);
+
+	// Copies are independent of each other
+	su::SmallVector<uint64_t, 2> b = a;
+	b[0] = 42;
+	EXPECT_EQ(a[0], 1);
+	EXPECT_FALSE(b.is_inline());
+
+	// Moving heap storage takes over the allocation
+	const uint64_t *data = a.data();
+	su::SmallVector<uint64_t, 2> c = std::move(a);
+	EXPECT_EQ(c.data(), data);
+	EXPECT_TRUE(a.empty());
+	EXPECT_TRUE(a.is_inline());
+
+	// Erasing from the front shifts the remaining elements down
+	c = {1, 2, 3, 4, 5};
+	c.erase(c.begin(), c.begin() + 2);
+	EXPECT_EQ(c, (su::SmallVector<uint64_t, 2>{3, 4, 5}));
+}
@@ -491,6 +491,99 @@ TEST (IntAddition, IntegersPositiveNegative)
 	}
 }
 
+TEST (IntAddition, FullWidthDigits)
+{
+	// Test that carries propagate across digits that use their full width
+	{
+		su::big_int_t a = UINT64_MAX;
+		su::big_int_t b = 1;
+		su::big_int_t c = a + b;
+
+		EXPECT_EQ(c, su::big_int_t("18446744073709551616"));
+
+		a = su::big_int_t("340282366920938463463374607431768211455"); // 2^128 - 1
+		b = 1;
+		c = a + b;
+
+		EXPECT_EQ(c, su::big_int_t("340282366920938463463374607431768211456"));
+
+		c = a + a;
+
+		EXPECT_EQ(c, su::big_int_t("680564733841876926926749214863536422910"));
+	}
+
+	// Test that borrows propagate across full width digits
+	{
+		su::big_int_t a = su::big_int_t("340282366920938463463374607431768211456"); // 2^128
+		su::big_int_t b = -1;
+		su::big_int_t c = a + b;
+
+		EXPECT_EQ(c, su::big_int_t("340282366920938463463374607431768211455"));
+
+		a = INT64_MIN;
+		b = INT64_MIN;
+		c = a + b;
+
+		EXPECT_EQ(c, su::big_int_t("-18446744073709551616"));
+	}
+}
+
+TEST (IntAddition, SingleDigitCounter)
+{
+	// Test a counter that crosses zero and the single digit boundary in both directions
+	su::big_int_t counter = -3;
+	for (int i = -3; i <= 3; i++)
+	{
+		EXPECT_EQ(counter, i);
+		counter += 1;
+	}
+
+	counter = UINT64_MAX - 2;
+	for (int i = 0; i < 5; i++)
+		counter += 1;
+	EXPECT_EQ(counter, su::big_int_t("18446744073709551618"));
+
+	for (int i = 0; i < 5; i++)
+		counter -= 1;
+	EXPECT_EQ(counter, UINT64_MAX - 2);
+
+	counter = -static_cast<int64_t>(INT64_MAX);
+	counter -= INT64_MAX;
+	counter -= 2;
+	EXPECT_EQ(counter, su::big_int_t("-18446744073709551616"));
+}
+
+TEST (IntAddition, Primitives)
+{
+	// Primitive operands are added to the digits directly, carrying across several of them
+	const su::big_int_t a("340282366920938463463374607431768211455");// 2^128 - 1
+	const su::big_int_t b("-340282366920938463463374607431768211456");// -2^128
+
+	EXPECT_EQ(a + 1, su::big_int_t("340282366920938463463374607431768211456"));
+	EXPECT_EQ(1u + a, a + su::big_int_t(1));
+	EXPECT_EQ(a + INT64_MIN, a + su::big_int_t(INT64_MIN));
+	EXPECT_EQ(b + 1, su::big_int_t("-340282366920938463463374607431768211455"));
+	EXPECT_EQ(b + UINT64_MAX, b + su::big_int_t(UINT64_MAX));
+	EXPECT_EQ(static_cast<int8_t>(-7) + b, b - 7);
+	EXPECT_EQ(su::big_int_t(-3) + 5, 2);
+
+	su::big_int_t c = a;
+	c += static_cast<uint16_t>(1);
+	c += -1;
+	EXPECT_EQ(c, a);
+	EXPECT_EQ(su::big_int_t(a) + 0, a);
+
+	// Cancelling a single digit value leaves a positive zero
+	su::big_int_t d(-5);
+	d += 5;
+	EXPECT_EQ(d, 0);
+	EXPECT_FALSE(d.is_negative());
+	EXPECT_FALSE((su::big_int_t(-5) + su::big_int_t(5)).is_negative());
+	EXPECT_FALSE((su::big_int_t(5) - su::big_int_t(5)).is_negative());
+	EXPECT_TRUE((su::big_int_t(-5) + 4).is_negative());
+	EXPECT_FALSE((su::big_int_t(-5) + 6).is_negative());
+}
+
 TEST (IntAddition, Random)
 {
 	auto binOp = [](const su::big_int_t& a, const su::big_int_t& b) { return a + b; };
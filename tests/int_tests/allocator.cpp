@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <big_int.hpp>
+
+#include <memory_resource>
+
+namespace su = suuri;
+
+namespace
+{
+
+// Memory resource that counts the allocations made through it
+class counting_resource : public std::pmr::memory_resource
+{
+public:
+	size_t allocations = 0;
+
+private:
+	void *do_allocate(size_t bytes, size_t alignment) override
+	{
+		allocations++;
+		return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+	}
+	void do_deallocate(void *p, size_t bytes, size_t alignment) override
+	{
+		std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+	}
+	[[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+	{
+		return this == &other;
+	}
+};
+
+// Makes any allocation through the default memory resource throw, for the lifetime of the object
+class forbid_default_resource
+{
+public:
+	forbid_default_resource() : previous_(std::pmr::set_default_resource(std::pmr::null_memory_resource())) {}
+	~forbid_default_resource() { std::pmr::set_default_resource(previous_); }
+
+private:
+	std::pmr::memory_resource *previous_;
+};
+
+}// namespace
+
+TEST(IntAllocator, PmrArithmetic)
+{
+	counting_resource resource;
+	std::pmr::polymorphic_allocator<su::digit_t> alloc(&resource);
+
+	const std::string a_str = "123456789123456789123456789123456789123456789123456789123456789123456789";
+	const std::string b_str = "-987654321987654321987654321987654321987654321";
+
+	{
+		forbid_default_resource forbid;
+
+		su::pmr::big_int_t a(a_str, alloc);
+		su::pmr::big_int_t b(b_str, alloc);
+
+		su::pmr::big_int_t sum = a + b;
+		su::pmr::big_int_t difference = a - b;
+		su::pmr::big_int_t product = a * b;
+		su::pmr::big_int_t karatsuba_product = a.karatsuba_multiplication(b);
+		su::pmr::big_int_t quotient = a / b;
+		su::pmr::big_int_t remainder = a % b;
+		auto str = product.to_string(std::pmr::polymorphic_allocator<char>(&resource));
+
+		EXPECT_EQ(sum.get_allocator().resource(), &resource);
+		EXPECT_EQ(product, karatsuba_product);
+		EXPECT_EQ(quotient * b + remainder, a);
+		EXPECT_EQ(su::big_int_t(std::string(str)) * -1,
+				  su::big_int_t(a_str) * su::big_int_t(b_str));
+		EXPECT_EQ(a.pow(5).get_allocator().resource(), &resource);
+	}
+
+	EXPECT_GT(resource.allocations, 0);
+}
+
+TEST(IntAllocator, MonotonicBuffer)
+{
+	// All big integers of a request can live in a single arena
+	std::pmr::monotonic_buffer_resource arena;
+	std::pmr::polymorphic_allocator<su::digit_t> alloc(&arena);
+
+	su::pmr::big_int_t factorial(1, alloc);
+	for (int i = 2; i <= 50; i++)
+		factorial *= su::pmr::big_int_t(i, alloc);
+
+	EXPECT_EQ(factorial.to_string(), "30414093201713378043612608166064768844377641568960512000000000000");
+	EXPECT_EQ(factorial.get_allocator().resource(), &arena);
+}
+
+TEST(IntAllocator, PrimitiveOperands)
+{
+	// Arithmetic with primitives works on the digits in place, without converting the primitive
+	counting_resource resource;
+	su::pmr::big_int_t a("340282366920938463463374607431768211455123", &resource);
+	a.reserve(8);
+	const size_t allocations = resource.allocations;
+
+	a *= 1000;
+	a += 17;
+	a -= -4;
+	a /= 7;
+	a %= 1000000007;
+	const bool less = a < 1000000007;
+
+	EXPECT_EQ(resource.allocations, allocations);
+	EXPECT_TRUE(less);
+	EXPECT_EQ(a.to_string(), ((su::big_int_t("340282366920938463463374607431768211455123") * su::big_int_t(1000) + su::big_int_t(21)) /
+							  su::big_int_t(7) % su::big_int_t(1000000007)).to_string());
+}
@@ -241,3 +241,26 @@ TEST (IntComparison, LessAndGreater)
 		EXPECT_FALSE(a > b);
 	}
 }
+
+TEST (IntComparison, Primitives)
+{
+	// Primitives are compared without being converted to big integers
+	const su::big_int_t large("340282366920938463463374607431768211455");
+	const su::big_int_t negative_zero = -su::big_int_t(0);
+
+	EXPECT_TRUE(large > UINT64_MAX);
+	EXPECT_TRUE(-large < INT64_MIN);
+	EXPECT_TRUE(0 < large);
+	EXPECT_FALSE(large == UINT64_MAX);
+	EXPECT_TRUE(su::big_int_t(-5) == -5);
+	EXPECT_TRUE(su::big_int_t(-5) < -4);
+	EXPECT_TRUE(su::big_int_t(-5) > -6);
+	EXPECT_TRUE(su::big_int_t(UINT64_MAX) >= UINT64_MAX);
+	EXPECT_TRUE(su::big_int_t(INT64_MIN) == INT64_MIN);
+	EXPECT_TRUE(su::big_int_t(3) != 3u + 1);
+	EXPECT_TRUE(negative_zero == 0);
+	EXPECT_TRUE(negative_zero < 1);
+	EXPECT_TRUE(negative_zero > -1);
+	EXPECT_EQ(su::big_int_t(7) <=> 7, std::strong_ordering::equal);
+	EXPECT_EQ(-large <=> static_cast<int8_t>(-1), std::strong_ordering::less);
+}
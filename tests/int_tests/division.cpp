@@ -398,6 +398,65 @@ TEST (IntDivision, Special)
 	}
 }
 
+TEST (IntDivision, FullWidthDigits)
+{
+	// Test division by a single digit divisor that uses the full width of the digit
+	su::big_int_t a = su::big_int_t("340282366920938463463374607431768211455"); // 2^128 - 1
+	su::big_int_t b = UINT64_MAX;
+
+	EXPECT_EQ(a / b, su::big_int_t("18446744073709551617"));
+	EXPECT_EQ(a % b, 0);
+
+	b = INT64_MIN;
+
+	EXPECT_EQ(a / b, su::big_int_t("-36893488147419103231"));
+	EXPECT_EQ(a % b, su::big_int_t("9223372036854775807"));
+}
+
+TEST (IntDivision, Primitives)
+{
+	// Division by a primitive truncates towards zero, and the remainder has the sign of the dividend
+	const su::big_int_t a("340282366920938463463374607431768211455");// 2^128 - 1
+
+	EXPECT_EQ(a / UINT64_MAX, su::big_int_t("18446744073709551617"));
+	EXPECT_EQ(a % UINT64_MAX, 0);
+	EXPECT_EQ(a / INT64_MIN, su::big_int_t("-36893488147419103231"));
+	EXPECT_EQ(a % INT64_MIN, su::big_int_t("9223372036854775807"));
+	EXPECT_EQ(-a / 10, -a / su::big_int_t(10));
+	EXPECT_EQ(-a % 10, -5);
+	EXPECT_EQ(su::big_int_t(-7) / 2, -3);
+	EXPECT_EQ(su::big_int_t(-7) % -2, -1);
+	EXPECT_EQ(100 / su::big_int_t(-7), -14);
+	EXPECT_EQ(100 % su::big_int_t(-7), 2);
+	EXPECT_EQ(5 / a, 0);
+
+	su::big_int_t b = a;
+	b /= static_cast<uint8_t>(255);
+	EXPECT_EQ(b, a / su::big_int_t(255));
+	b %= 1000;
+	EXPECT_EQ(b, a / su::big_int_t(255) % su::big_int_t(1000));
+
+	// A zero quotient or remainder is never negative
+	EXPECT_FALSE((su::big_int_t(-6) % 3).is_negative());
+	EXPECT_FALSE((su::big_int_t(-1) / 2).is_negative());
+	EXPECT_FALSE((su::big_int_t(-6) % su::big_int_t(3)).is_negative());
+	EXPECT_FALSE((su::big_int_t(-1) / su::big_int_t(2)).is_negative());
+	EXPECT_FALSE((-a / (a + 1)).is_negative());
+	su::big_int_t c = -1;
+	c /= 2;
+	EXPECT_FALSE(c.is_negative());
+	c = -6;
+	c %= 3;
+	EXPECT_FALSE(c.is_negative());
+	EXPECT_TRUE((su::big_int_t(-7) % 3).is_negative());
+
+	EXPECT_THROW(a / 0, su::divide_by_zero);
+	EXPECT_THROW(a % 0u, su::divide_by_zero);
+	EXPECT_THROW(b /= 0, su::divide_by_zero);
+	EXPECT_THROW(b %= 0, su::divide_by_zero);
+	EXPECT_EQ(b, a / su::big_int_t(255) % su::big_int_t(1000));
+}
+
 TEST (IntDivision, Random)
 {
 	auto binOp = [](const su::big_int_t &a, const su::big_int_t &b) { return a / b; };
@@ -427,3 +486,35 @@ TEST (IntDivision, Random)
 			"../../random_tests/int/division/division_large_input.test",
 			binOp);
 }
+
+TEST (IntDivision, DivideAndConquerAgainstDefinition)
+{
+	RandomInts random(1122);
+
+	// Against the definition of the quotient and remainder, for every combination of signs
+	for (size_t lhs_size: {2, 3, 4, 40, 100, 500, 2000})
+	{
+		for (size_t rhs_size: {2, 3, 41, 90, 300, 1000})
+		{
+			const su::big_int_t a = random(lhs_size);
+			const su::big_int_t b = random(rhs_size);
+			for (const auto &[x, y]: {std::pair{a, b}, std::pair{-a, b}, std::pair{a, -b}, std::pair{-a, -b}})
+			{
+				const auto [quotient, remainder] = x.divide_with_remainder(y);
+				EXPECT_EQ(quotient * y + remainder, x) << "Sizes " << lhs_size << " and " << rhs_size;
+				EXPECT_LT(remainder.abs(), y.abs());
+				EXPECT_TRUE(remainder.is_zero() || (remainder < 0) == (x < 0));
+				EXPECT_EQ(x / y, quotient);
+				EXPECT_EQ(x % y, remainder);
+			}
+		}
+	}
+
+	// Exact divisions, and quotients one below a power of the base
+	su::big_int_t a = random(700);
+	su::big_int_t b = random(300);
+	EXPECT_EQ(a * b / b, a);
+	EXPECT_EQ(a * b % a, 0);
+	EXPECT_EQ((a * b - 1) / b, a - 1);
+	EXPECT_THROW((void) (a / 0), su::divide_by_zero);
+}
@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+
+#include <suuri_expression.hpp>
+
+#include <memory_resource>
+#include <random>
+#include <vector>
+
+namespace su = suuri;
+
+namespace
+{
+
+su::big_int_t random_int(size_t digits, std::mt19937_64 &gen, bool negative = false)
+{
+	std::vector<su::digit_t> d(digits);
+	for (auto &digit: d)
+		digit = gen();
+	d.back() |= 1;
+
+	return su::big_int_t{d, negative};
+}
+
+// Memory resource that counts the allocations made through it
+class counting_resource : public std::pmr::memory_resource
+{
+public:
+	size_t allocations = 0;
+
+private:
+	void *do_allocate(size_t bytes, size_t alignment) override
+	{
+		allocations++;
+		return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+	}
+	void do_deallocate(void *p, size_t bytes, size_t alignment) override
+	{
+		std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+	}
+	[[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+	{
+		return this == &other;
+	}
+};
+
+}// namespace
+
+TEST (IntExpression, AddmulSubmul)
+{
+	std::mt19937_64 gen(5);
+
+	for (int i = 0; i < 200; i++)
+	{
+		const auto a = random_int(1 + gen() % 5, gen, gen() & 1);
+		const auto b = random_int(1 + gen() % 5, gen, gen() & 1);
+		const auto c = random_int(1 + gen() % 9, gen, gen() & 1);
+
+		auto sum = c;
+		sum.addmul(a, b);
+		EXPECT_EQ(sum, c + a * b);
+
+		auto difference = c;
+		difference.submul(a, b);
+		EXPECT_EQ(difference, c - a * b);
+
+		// The product cancels the value exactly
+		auto zero = a * b;
+		zero.submul(a, b);
+		EXPECT_EQ(zero, 0);
+	}
+}
+
+TEST (IntExpression, AddmulSubmulPastKaratsuba)
+{
+	std::mt19937_64 gen(7);
+
+	// Products from the Karatsuba threshold on go through the multiplication dispatcher before they are accumulated
+	const size_t k = su::limbs::karatsuba_threshold;
+	for (size_t lhs_size: {k - 1, k, 3 * k, 20 * k})
+	{
+		for (size_t rhs_size: {k - 1, k, 4 * k})
+		{
+			const auto a = random_int(lhs_size, gen, gen() & 1);
+			const auto b = random_int(rhs_size, gen, gen() & 1);
+			for (size_t c_size: {size_t{1}, lhs_size + rhs_size, lhs_size + rhs_size + 2})
+			{
+				const auto c = random_int(c_size, gen, gen() & 1);
+
+				auto sum = c;
+				sum.addmul(a, b);
+				ASSERT_EQ(sum, c + a * b) << "Sizes " << lhs_size << ", " << rhs_size << " and " << c_size;
+
+				auto difference = c;
+				difference.submul(a, b);
+				ASSERT_EQ(difference, c - a * b) << "Sizes " << lhs_size << ", " << rhs_size << " and " << c_size;
+
+				su::big_int_t r = su::lazy(a) * b + c;
+				ASSERT_EQ(r, a * b + c) << "Sizes " << lhs_size << ", " << rhs_size << " and " << c_size;
+			}
+		}
+	}
+
+	const auto a = random_int(5 * k, gen);
+	auto zero = a * a;
+	zero.submul(a, a);
+	EXPECT_EQ(zero, 0);
+}
+
+TEST (IntExpression, LazyEvaluation)
+{
+	std::mt19937_64 gen(9);
+
+	for (int i = 0; i < 100; i++)
+	{
+		const auto a = random_int(1 + gen() % 5, gen, gen() & 1);
+		const auto b = random_int(1 + gen() % 5, gen, gen() & 1);
+		const auto c = random_int(1 + gen() % 5, gen, gen() & 1);
+		const auto d = random_int(1 + gen() % 5, gen, gen() & 1);
+
+		su::big_int_t r = su::lazy(a) * b + c;
+		EXPECT_EQ(r, a * b + c);
+
+		r = su::lazy(a) * b - su::lazy(c) * d;
+		EXPECT_EQ(r, a * b - c * d);
+
+		r = (su::lazy(a) + b) * (c - su::lazy(d)) - a;
+		EXPECT_EQ(r, (a + b) * (c - d) - a);
+
+		auto x = c;
+		x += su::lazy(a) * b;
+		EXPECT_EQ(x, c + a * b);
+		x -= su::lazy(a) * b + d;
+		EXPECT_EQ(x, c - d);
+
+		// The destination appearing in its own expression
+		x = su::lazy(x) * x - a;
+		EXPECT_EQ(x, (c - d) * (c - d) - a);
+	}
+}
+
+TEST (IntExpression, SizesDestinationOnce)
+{
+	std::mt19937_64 gen(13);
+	counting_resource resource;
+
+	std::vector<su::digit_t> digits(6);
+	auto make = [&](size_t size) {
+		for (auto &digit: digits)
+			digit = gen() | 1;
+		return su::pmr::big_int_t{std::span(digits.data(), size), false, &resource};
+	};
+
+	const auto a = make(4);
+	const auto b = make(4);
+	const auto c = make(6);
+	const auto d = make(3);
+
+	su::pmr::big_int_t r{&resource};
+	resource.allocations = 0;
+	r = su::lazy(a) * b + su::lazy(c) * d - a;
+	EXPECT_EQ(resource.allocations, 1);
+	EXPECT_EQ(r, a * b + c * d - a);
+
+	resource.allocations = 0;
+	r = su::lazy(c) * d + su::lazy(a) * b;
+	EXPECT_EQ(resource.allocations, 0);
+}
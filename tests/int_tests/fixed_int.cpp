@@ -0,0 +1,109 @@
+#include "test_helpers.hpp"
+
+#include <gtest/gtest.h>
+
+#include <big_int.hpp>
+#include <suuri_fixed_int.hpp>
+#include <suuri_math.hpp>
+
+namespace su = suuri;
+
+namespace
+{
+
+template<size_t Bits>
+su::big_int_t wrap(const su::big_int_t &value)
+{
+	// Reduce to the two's complement range of a Bits wide integer
+	const su::big_int_t modulus = su::big_int_t(2).pow(Bits);
+	su::big_int_t ret = value % modulus;
+	if (ret < 0)
+		ret += modulus;
+	if (ret >= modulus / 2)
+		ret -= modulus;
+	return ret;
+}
+
+template<size_t Bits>
+void test_against_big_int(size_t iterations)
+{
+	RandomInts random(4321);
+	constexpr size_t digits = Bits / su::digit_bits;
+
+	for (size_t i = 0; i < iterations; i++)
+	{
+		su::big_int_t a = wrap<Bits>(random(1 + i % digits) * (i % 2 ? 1 : -1));
+		su::big_int_t b = wrap<Bits>(random(1 + (i / 2) % digits) * (i % 3 ? 1 : -1));
+		su::FixedInt<Bits> fa(a);
+		su::FixedInt<Bits> fb(b);
+
+		ASSERT_EQ(fa.to_big_int(), a);
+		EXPECT_EQ((fa + fb).to_big_int(), wrap<Bits>(a + b));
+		EXPECT_EQ((fa - fb).to_big_int(), wrap<Bits>(a - b));
+		EXPECT_EQ((fa * fb).to_big_int(), wrap<Bits>(a * b));
+		EXPECT_EQ(fa < fb, a < b);
+		EXPECT_EQ(fa == fb, a == b);
+		EXPECT_EQ((fa / fb).to_big_int(), a / b);
+		EXPECT_EQ((fa % fb).to_big_int(), a % b);
+	}
+}
+
+}// namespace
+
+TEST(IntFixedInt, Basic)
+{
+	su::fixed_int256_t a = 5;
+	su::fixed_int256_t b = -7;
+
+	EXPECT_EQ(a + b, -2);
+	EXPECT_EQ(a - b, 12);
+	EXPECT_EQ(a * b, -35);
+	EXPECT_EQ(b / a, -1);
+	EXPECT_EQ(b % a, -2);
+	EXPECT_LT(b, a);
+	EXPECT_GT(a, b);
+	EXPECT_EQ(b.to_string(), "-7");
+
+	a = su::fixed_int256_t("57896044618658097711785492504343953926634992332820282019728792003956564819967"); // 2^255 - 1
+	EXPECT_EQ(a + 1, -a - 1);// Wraps around to the minimum value
+	EXPECT_EQ((-a - 1).abs(), -a - 1);
+
+	EXPECT_THROW(a / 0, su::divide_by_zero);
+}
+
+TEST(IntFixedInt, AgainstBigInt)
+{
+	test_against_big_int<64>(200);
+	test_against_big_int<256>(200);
+	test_against_big_int<512>(100);
+}
+
+TEST(IntFixedInt, Square)
+{
+	RandomInts random(1357);
+
+	for (int i = 0; i < 100; i++)
+	{
+		su::big_int_t value = random(8);
+		su::fixed_int512_t a = su::fixed_int512_t(wrap<512>(value));
+		EXPECT_EQ(a.square(), a * a);
+		EXPECT_EQ((-a).square(), a * a);
+	}
+
+	su::fixed_int256_t b = -1;
+	EXPECT_EQ(b.square(), 1);
+}
+
+TEST(IntFixedInt, SuuriMath)
+{
+	su::fixed_int512_t a = -3;
+
+	EXPECT_EQ(su::sgn(a), -1);
+	EXPECT_EQ(su::abs(a), 3);
+	EXPECT_EQ(su::square(a), 9);
+	EXPECT_EQ(su::pow(a, 5), -243);
+	EXPECT_EQ(su::pow(a, 300).to_big_int(), wrap<512>(su::big_int_t(-3).pow(300)));
+
+	su::fixed_int4096_t b = 3;
+	EXPECT_EQ(su::pow(b, 2000).to_big_int(), su::big_int_t(3).pow(2000));
+}
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <big_int.hpp>
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+namespace su = suuri;
+
+namespace
+{
+
+std::vector<std::byte> bytes(std::initializer_list<int> values)
+{
+	std::vector<std::byte> ret;
+	for (int value: values)
+		ret.push_back(static_cast<std::byte>(value));
+	return ret;
+}
+
+}// namespace
+
+TEST(IntImportExport, ByteOrders)
+{
+	// 0x0102030405060708090a as a single byte string in both orders
+	const auto little = bytes({0x0a, 0x09, 0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01});
+	const auto big = bytes({0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a});
+	const su::big_int_t expected{std::vector<su::digit_t>{0x030405060708090a, 0x0102}};
+
+	EXPECT_EQ(su::big_int_t::import_words(little, 1, su::word_order::least_significant_first, std::endian::little), expected);
+	EXPECT_EQ(su::big_int_t::import_words(big, 1, su::word_order::most_significant_first, std::endian::big), expected);
+	EXPECT_EQ(su::big_int_t::import_words(big, 10, su::word_order::least_significant_first, std::endian::big), expected);
+
+	// Two byte words, most significant word first, with the bytes of each word little endian
+	const auto mixed = bytes({0x02, 0x01, 0x04, 0x03, 0x06, 0x05, 0x08, 0x07, 0x0a, 0x09});
+	EXPECT_EQ(su::big_int_t::import_words(mixed, 2, su::word_order::most_significant_first, std::endian::little), expected);
+
+	EXPECT_EQ(expected.export_words(1, su::word_order::least_significant_first, std::endian::little), little);
+	EXPECT_EQ(expected.export_words(1, su::word_order::most_significant_first, std::endian::little), big);
+	EXPECT_EQ(expected.export_words(2, su::word_order::most_significant_first, std::endian::little), mixed);
+
+	// Zero has no words
+	EXPECT_EQ(su::big_int_t(0).export_size(4), 0);
+	EXPECT_EQ(su::big_int_t::import_words(std::span<const std::byte>(), 4, su::word_order::least_significant_first, std::endian::little), 0);
+}
+
+TEST(IntImportExport, Nails)
+{
+	// Words of 7 value bits, as in a base 128 encoding
+	const auto data = bytes({0xff, 0x81, 0x01});
+	const auto value = su::big_int_t::import_words(data, 1, su::word_order::least_significant_first, std::endian::little, 1);
+	EXPECT_EQ(value, 0x7f + (0x01 << 7) + (0x01 << 14));
+
+	EXPECT_EQ(value.export_size(1, 1), 3);
+	EXPECT_EQ(value.export_words(1, su::word_order::least_significant_first, std::endian::little, 1), bytes({0x7f, 0x01, 0x01}));
+}
+
+TEST(IntImportExport, RoundTrip)
+{
+	std::mt19937_64 gen(17);
+	const std::array<size_t, 5> word_sizes = {1, 3, 4, 8, 16};
+
+	for (int i = 0; i < 50; i++)
+	{
+		std::vector<su::digit_t> digits(1 + gen() % 6);
+		for (auto &digit: digits)
+			digit = gen();
+		digits.back() |= 1;
+		const su::big_int_t value{digits};
+
+		for (size_t word_size: word_sizes)
+			for (size_t nails: {size_t{0}, size_t{3}})
+				for (auto order: {su::word_order::least_significant_first, su::word_order::most_significant_first})
+					for (auto endianness: {std::endian::little, std::endian::big})
+					{
+						const auto exported = value.export_words(word_size, order, endianness, nails);
+						EXPECT_EQ(exported.size(), value.export_size(word_size, nails) * word_size);
+						EXPECT_EQ(su::big_int_t::import_words(exported, word_size, order, endianness, nails), value);
+					}
+	}
+}
+
+TEST(IntImportExport, CallerBuffer)
+{
+	const su::big_int_t value{std::vector<su::digit_t>{1, 2}};
+	std::array<std::byte, 32> buffer{};
+
+	const auto written = value.export_words(buffer, 8, su::word_order::least_significant_first, std::endian::little);
+	EXPECT_EQ(written.data(), buffer.data());
+	EXPECT_EQ(written.size(), 16);
+	EXPECT_EQ(su::big_int_t::import_words(written, 8, su::word_order::least_significant_first, std::endian::little), value);
+
+	std::array<std::byte, 12> small{};
+	EXPECT_THROW(value.export_words(small, 8, su::word_order::least_significant_first, std::endian::little), su::buffer_too_small);
+
+	const std::array<uint32_t, 3> words = {1, 0, 2};
+	EXPECT_EQ(su::big_int_t::import_words(std::span<const uint32_t>(words), su::word_order::least_significant_first),
+			  su::big_int_t(std::vector<su::digit_t>{1, 2}));
+}
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include <big_int.hpp>
+
+#include <random>
+#include <vector>
+
+namespace su = suuri;
+
+namespace
+{
+
+su::big_int_t random_int(size_t digits, std::mt19937_64 &gen, bool negative = false)
+{
+	std::vector<su::digit_t> d(digits);
+	for (auto &digit: d)
+		digit = gen();
+	d.back() |= 1;
+
+	return su::big_int_t{d, negative};
+}
+
+}// namespace
+
+TEST (IntMove, TemporaryOperandsGiveSameResults)
+{
+	std::mt19937_64 gen(7);
+
+	for (int i = 0; i < 50; i++)
+	{
+		const auto a = random_int(1 + gen() % 6, gen, gen() & 1);
+		const auto b = random_int(1 + gen() % 6, gen, gen() & 1);
+		const auto c = random_int(1 + gen() % 6, gen, gen() & 1);
+
+		const auto sum = a + b;
+		const auto difference = a - b;
+		const auto product = a * b;
+
+		EXPECT_EQ(su::big_int_t(a) + b, sum);
+		EXPECT_EQ(a + su::big_int_t(b), sum);
+		EXPECT_EQ(su::big_int_t(a) + su::big_int_t(b), sum);
+
+		EXPECT_EQ(su::big_int_t(a) - b, difference);
+		EXPECT_EQ(a - su::big_int_t(b), difference);
+		EXPECT_EQ(su::big_int_t(a) - su::big_int_t(b), difference);
+
+		EXPECT_EQ(su::big_int_t(a) * b, product);
+		EXPECT_EQ(a * su::big_int_t(b), product);
+		EXPECT_EQ(su::big_int_t(a) * su::big_int_t(b), product);
+
+		EXPECT_EQ(-su::big_int_t(a), -a);
+		EXPECT_EQ(a * b + c - a * c, product + (c - a * c));
+	}
+}
+
+TEST (IntMove, TemporaryStorageIsReused)
+{
+	std::mt19937_64 gen(11);
+	const auto b = random_int(3, gen);
+
+	auto a = random_int(8, gen);
+	const auto *storage = a.digits().data();
+	auto sum = std::move(a) + b;
+	EXPECT_EQ(sum.digits().data(), storage);
+
+	auto c = random_int(8, gen);
+	storage = c.digits().data();
+	auto difference = b - std::move(c);
+	EXPECT_EQ(difference.digits().data(), storage);
+	EXPECT_LT(difference, 0);
+}
+
+TEST (IntMove, MultiplyAssignInPlace)
+{
+	std::mt19937_64 gen(3);
+
+	for (int i = 0; i < 50; i++)
+	{
+		auto a = random_int(1 + gen() % 8, gen, gen() & 1);
+		const auto b = random_int(1 + gen() % 8, gen, gen() & 1);
+		const auto expected = a.long_multiplication(b);
+
+		a *= b;
+		EXPECT_EQ(a, expected);
+
+		a *= a;
+		EXPECT_EQ(a, expected.long_multiplication(expected));
+	}
+
+	su::big_int_t zero = 0;
+	auto a = random_int(4, gen);
+	a *= zero;
+	EXPECT_EQ(a, 0);
+}
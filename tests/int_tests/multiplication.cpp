@@ -4,6 +4,7 @@
 #include <gtest/gtest.h>
 
 #include <big_int.hpp>
+#include <random>
 
 namespace su = suuri;
 
@@ -316,6 +317,53 @@ TEST (IntMultiplication, IntegersPositiveNegative)
 	}
 }
 
+TEST (IntMultiplication, FullWidthDigits)
+{
+	// Test products of digits that use their full width
+	su::big_int_t a = UINT64_MAX;
+	su::big_int_t b = UINT64_MAX;
+	su::big_int_t c = a * b;
+
+	EXPECT_EQ(c, su::big_int_t("340282366920938463426481119284349108225"));
+	EXPECT_EQ(a.karatsuba_multiplication(b), c);
+
+	a = su::big_int_t("340282366920938463463374607431768211455"); // 2^128 - 1
+	b = su::big_int_t("-340282366920938463463374607431768211455");
+	c = a * b;
+
+	EXPECT_EQ(c, su::big_int_t("-115792089237316195423570985008687907852589419931798687112530834793049593217025"));
+	EXPECT_EQ(a.karatsuba_multiplication(b), c);
+}
+
+TEST (IntMultiplication, Primitives)
+{
+	// Primitive operands are multiplied into the digits directly
+	const su::big_int_t a("340282366920938463463374607431768211455");// 2^128 - 1
+
+	EXPECT_EQ(a * 10, a * su::big_int_t(10));
+	EXPECT_EQ(-3 * a, a * su::big_int_t(-3));
+	EXPECT_EQ(a * UINT64_MAX, a * su::big_int_t(UINT64_MAX));
+	EXPECT_EQ(a * INT64_MIN, a * su::big_int_t(INT64_MIN));
+	EXPECT_EQ(a * 0, 0);
+	EXPECT_EQ(su::big_int_t(-6) * 7, -42);
+
+	// A zero product is positive whatever the signs of the operands
+	su::big_int_t d(-5);
+	d *= 0;
+	EXPECT_EQ(d, 0);
+	EXPECT_FALSE(d.is_negative());
+	EXPECT_FALSE((su::big_int_t(-5) * su::big_int_t(0)).is_negative());
+	EXPECT_FALSE((su::big_int_t(0) * su::big_int_t(-5)).is_negative());
+	EXPECT_FALSE((-a * 0).is_negative());
+	EXPECT_TRUE((su::big_int_t(-5) * 3).is_negative());
+	EXPECT_FALSE((su::big_int_t(-5) * -3).is_negative());
+
+	su::big_int_t factorial = 1;
+	for (uint32_t i = 2; i <= 30; i++)
+		factorial *= i;
+	EXPECT_EQ(factorial, su::big_int_t("265252859812191058636308480000000"));
+}
+
 TEST (IntMultiplication, Random)
 {
 	auto binOp = [](const su::big_int_t &a, const su::big_int_t &b) { return a * b; };
@@ -375,3 +423,287 @@ TEST (IntMultiplication, KaratsubaRandom)
 			"../../random_tests/int/multiplication/multiplication_large_input.test",
 			binOp);
 }
+
+TEST (IntMultiplication, KaratsubaAgainstLongMultiplication)
+{
+	RandomInts random(1234);
+	auto long_multiplication = [](const su::big_int_t &a, const su::big_int_t &b) { return a.long_multiplication(b); };
+
+	// Balanced and unbalanced operand sizes, including odd sizes that split unevenly, around the threshold
+	expect_products_match(random, {1, 2, 3, 7, 31, 32, 33, 47, 64, 69}, {1, 5, 16, 33, 64},
+						  [](const su::big_int_t &a, const su::big_int_t &b) { return a.karatsuba_multiplication(b); }, long_multiplication);
+
+	// Operands with all bits set maximise the carries in the middle term
+	su::big_int_t a = su::big_int_t(std::vector<su::digit_t>(37, UINT64_MAX));
+	su::big_int_t b = su::big_int_t(std::vector<su::digit_t>(29, UINT64_MAX));
+	EXPECT_EQ(a.karatsuba_multiplication(b), a.long_multiplication(b));
+	EXPECT_EQ(a.karatsuba_multiplication(a), a.long_multiplication(a));
+}
+
+TEST (IntMultiplication, Toom3AgainstLongMultiplication)
+{
+	RandomInts random(4321);
+
+	// Sizes where every piece is small, and 75 against 51 and 50, just inside and outside the balance Toom-3 needs
+	expect_products_match(random, {5, 6, 26, 75}, {5, 12, 50, 51, 75},
+						  [](const su::big_int_t &a, const su::big_int_t &b) { return a.toom3_multiplication(b); },
+						  [](const su::big_int_t &a, const su::big_int_t &b) { return a.long_multiplication(b); });
+
+	// All bits set maximises the values at 1 and 2
+	su::big_int_t a = su::big_int_t(std::vector<su::digit_t>(301, UINT64_MAX));
+	su::big_int_t b = su::big_int_t(std::vector<su::digit_t>(250, UINT64_MAX));
+	EXPECT_EQ(a.toom3_multiplication(b), a.long_multiplication(b));
+	EXPECT_EQ(a.toom3_multiplication(a), a.long_multiplication(a));
+	EXPECT_EQ(-a * b, -a.long_multiplication(b));
+}
+
+TEST (IntMultiplication, DispatcherAgainstLongMultiplication)
+{
+	RandomInts random(99);
+
+	// Sizes on both sides of the thresholds, including operands too unbalanced for Toom-3
+	const std::vector<size_t> sizes = {1, 2, 31, 32, 50, 127, 128, 129, 200, 333, 700};
+	expect_products_match(random, sizes, sizes, [](const su::big_int_t &a, const su::big_int_t &b) { return a * b; },
+						  [](const su::big_int_t &a, const su::big_int_t &b) { return a.long_multiplication(b); });
+
+	// Squaring in place
+	for (size_t size: {su::limbs::karatsuba_threshold, su::limbs::toom3_threshold + 1})
+	{
+		const su::big_int_t a = random(size);
+		auto square = a;
+		square *= square;
+		ASSERT_EQ(square, a.long_multiplication(a)) << "Size " << size;
+	}
+}
+
+TEST (IntMultiplication, HigherToomAgainstLongMultiplication)
+{
+	RandomInts random(2468);
+
+	typedef su::big_int_t (su::big_int_t::*multiplication_t)(const su::big_int_t &) const;
+	const multiplication_t multiplications[] = {&su::big_int_t::toom4_multiplication, &su::big_int_t::toom6h_multiplication,
+												&su::big_int_t::toom8h_multiplication};
+
+	for (const auto multiplication: multiplications)
+	{
+		// Small pieces exercise every split, including the uneven ones the half point allows
+		expect_products_match(random, {4, 17, 30, 56, 82, 108, 119}, {2, 11, 29, 56, 101},
+							  [multiplication](const su::big_int_t &a, const su::big_int_t &b) { return (a.*multiplication)(b); },
+							  [](const su::big_int_t &a, const su::big_int_t &b) { return a.long_multiplication(b); });
+
+		// All bits set maximises the values at the positive points
+		su::big_int_t a = su::big_int_t(std::vector<su::digit_t>(301, UINT64_MAX));
+		su::big_int_t b = su::big_int_t(std::vector<su::digit_t>(250, UINT64_MAX));
+		EXPECT_EQ((a.*multiplication)(b), a.long_multiplication(b));
+		EXPECT_EQ((a.*multiplication)(a), a.long_multiplication(a));
+		EXPECT_EQ(((-a).*multiplication)(b), -a.long_multiplication(b));
+	}
+
+	// Sizes past the thresholds of every variant go through the dispatcher
+	for (size_t size: {su::limbs::toom4_threshold, su::limbs::toom6h_threshold, su::limbs::toom8h_threshold + 100})
+	{
+		su::big_int_t a = random(size);
+		su::big_int_t b = random(size + size / 3);
+
+		ASSERT_EQ(a * b, a.karatsuba_multiplication(b)) << "Size " << size;
+		ASSERT_EQ(a * a, a.karatsuba_multiplication(a)) << "Size " << size;
+	}
+}
+
+TEST (IntMultiplication, NttAgainstLongMultiplication)
+{
+	RandomInts random(1357);
+
+	// The transforms work for any size, including ones where the sizes add up to a power of two
+	const std::vector<size_t> sizes = {1, 2, 3, 17, 64, 65, 250};
+	expect_products_match(random, sizes, sizes, [](const su::big_int_t &a, const su::big_int_t &b) { return a.ntt_multiplication(b); },
+						  [](const su::big_int_t &a, const su::big_int_t &b) { return a.long_multiplication(b); });
+
+	// All bits set gives the largest coefficients, and this size uses the four-step layout
+	su::big_int_t a = su::big_int_t(std::vector<su::digit_t>(3000, UINT64_MAX));
+	su::big_int_t b = su::big_int_t(std::vector<su::digit_t>(2500, UINT64_MAX));
+	EXPECT_EQ(a.ntt_multiplication(b), a.karatsuba_multiplication(b));
+	EXPECT_EQ(a.ntt_multiplication(a), a.karatsuba_multiplication(a));
+	EXPECT_EQ((-a).ntt_multiplication(b), -a.karatsuba_multiplication(b));
+
+	// Past the threshold, operator* uses the transforms
+	a = random(su::limbs::ntt_threshold);
+	b = random(su::limbs::ntt_threshold + 1000);
+	EXPECT_EQ(a * b, a.toom8h_multiplication(b));
+	EXPECT_EQ(a * a, a.toom8h_multiplication(a));
+}
+
+TEST (IntMultiplication, SsaAgainstLongMultiplication)
+{
+	RandomInts random(2468);
+
+	const std::vector<size_t> sizes = {1, 2, 5, 31, 64, 100, 333};
+	expect_products_match(random, sizes, sizes, [](const su::big_int_t &a, const su::big_int_t &b) { return a.ssa_multiplication(b); },
+						  [](const su::big_int_t &a, const su::big_int_t &b) { return a.long_multiplication(b); });
+
+	// All bits set gives the largest negacyclic coefficients, whose signs the unweighting has to recover
+	su::big_int_t a = su::big_int_t(std::vector<su::digit_t>(3000, UINT64_MAX));
+	su::big_int_t b = su::big_int_t(std::vector<su::digit_t>(2500, UINT64_MAX));
+	EXPECT_EQ(a.ssa_multiplication(b), a.ntt_multiplication(b));
+	EXPECT_EQ(a.ssa_multiplication(a), a.ntt_multiplication(a));
+	EXPECT_EQ((-a).ssa_multiplication(b), -a.ntt_multiplication(b));
+
+	a = random(20000);
+	b = random(17000);
+	EXPECT_EQ(a.ssa_multiplication(b), a * b);
+}
+
+TEST (IntMultiplication, FftAgainstLongMultiplication)
+{
+	RandomInts random(8642);
+
+	const std::vector<size_t> sizes = {1, 2, 3, 17, 64, 65, 250};
+	expect_products_match(random, sizes, sizes, [](const su::big_int_t &a, const su::big_int_t &b) { return a.fft_multiplication(b); },
+						  [](const su::big_int_t &a, const su::big_int_t &b) { return a.long_multiplication(b); });
+
+	// All bits set makes every point as large as the split allows, which is the case the error bound is for
+	su::big_int_t a = su::big_int_t(std::vector<su::digit_t>(20000, UINT64_MAX));
+	su::big_int_t b = su::big_int_t(std::vector<su::digit_t>(3000, UINT64_MAX));
+	EXPECT_EQ(a.fft_multiplication(b), a.ntt_multiplication(b));
+	EXPECT_EQ(a.fft_multiplication(a), a.ntt_multiplication(a));
+	EXPECT_EQ((-a).fft_multiplication(b), -a.ntt_multiplication(b));
+
+	// Fewer bits per point fit the bound as the operands grow, until none do
+	EXPECT_GT(su::fft::plan(100, 100).bits, su::fft::plan(100000, 100000).bits);
+	EXPECT_FALSE(su::fft::applicable(size_t{1} << 24, size_t{1} << 24));
+
+	// Past the threshold, operator* uses the FFT where the CPU supports it
+	a = random(su::limbs::fft_threshold);
+	b = random(su::limbs::fft_threshold + 700);
+	EXPECT_EQ(a * b, a.ntt_multiplication(b));
+	EXPECT_EQ(a * a, a.ntt_multiplication(a));
+}
+
+TEST (IntMultiplication, IfmaAgainstLongMultiplication)
+{
+	RandomInts random(9753);
+
+	// Around the 32 limb tiles the operands are converted in
+	const std::vector<size_t> sizes = {1, 2, 13, 32, 33, 100};
+	for (auto backend: {su::ifma::Backend::emulated, su::ifma::best_backend()})
+	{
+		expect_products_match(random, sizes, sizes,
+							  [backend](const su::big_int_t &a, const su::big_int_t &b) { return a.ifma_multiplication(b, backend); },
+							  [](const su::big_int_t &a, const su::big_int_t &b) { return a.long_multiplication(b); });
+
+		su::big_int_t a = su::big_int_t(std::vector<su::digit_t>(70, UINT64_MAX));
+		su::big_int_t b = su::big_int_t(std::vector<su::digit_t>(45, UINT64_MAX));
+		EXPECT_EQ(a.ifma_multiplication(b, backend), a.long_multiplication(b));
+		EXPECT_EQ(a.ifma_multiplication(a, backend), a.long_multiplication(a));
+		EXPECT_EQ((-a).ifma_multiplication(b, backend), -a.long_multiplication(b));
+	}
+}
+
+TEST (IntMultiplication, SquareAgainstLongMultiplication)
+{
+	RandomInts random(97531);
+
+	// Sizes on both sides of every squaring threshold
+	const size_t sizes[] = {1, 2, 3, 39, 40, 41, 223, 224, 225, 899, 900, 1299, 1300, 2500};
+	for (size_t size: sizes)
+	{
+		su::big_int_t a = random(size);
+		ASSERT_EQ(a.square(), a.long_multiplication(a)) << "Size " << size;
+		ASSERT_EQ((-a).square(), a.long_multiplication(a)) << "Size " << size;
+	}
+
+	su::big_int_t a = su::big_int_t(std::vector<su::digit_t>(3000, UINT64_MAX));
+	EXPECT_EQ(a.square(), a.ntt_multiplication(a));
+	EXPECT_EQ(su::big_int_t(UINT64_MAX).square(), su::big_int_t(UINT64_MAX).long_multiplication(su::big_int_t(UINT64_MAX)));
+	EXPECT_EQ(su::big_int_t(0).square(), 0);
+
+	// Squaring in place goes through the same path
+	su::big_int_t b = a;
+	b *= b;
+	EXPECT_EQ(b, a.ntt_multiplication(a));
+}
+
+TEST (IntMultiplication, UnbalancedAgainstLongMultiplication)
+{
+	RandomInts random(24680);
+
+	// Shorter lengths on both sides of the Toom thresholds, with the longer operand from as long to ten times as long
+	const size_t shorter_sizes[] = {2, 5, 40, 150, 400};
+	const size_t percentages[] = {100, 130, 150, 175, 200, 250, 300, 1000};
+	for (size_t shorter: shorter_sizes)
+	{
+		for (size_t percentage: percentages)
+		{
+			const size_t longer = shorter * percentage / 100;
+			su::big_int_t a = random(longer);
+			su::big_int_t b = random(shorter);
+			const su::big_int_t expected = a.long_multiplication(b);
+
+			ASSERT_EQ(a.toom32_multiplication(b), expected) << "Sizes " << longer << " and " << shorter;
+			ASSERT_EQ(b.toom42_multiplication(a), expected) << "Sizes " << longer << " and " << shorter;
+			ASSERT_EQ(a.toom63_multiplication(b), expected) << "Sizes " << longer << " and " << shorter;
+			ASSERT_EQ(a.chunked_multiplication(b), expected) << "Sizes " << longer << " and " << shorter;
+			ASSERT_EQ(a * b, expected) << "Sizes " << longer << " and " << shorter;
+		}
+	}
+
+	// A huge accumulator times word sized and medium factors
+	su::big_int_t a = su::big_int_t(std::vector<su::digit_t>(5000, UINT64_MAX));
+	su::big_int_t b = su::big_int_t(std::vector<su::digit_t>(300, UINT64_MAX));
+	EXPECT_EQ(a * b, a.long_multiplication(b));
+	EXPECT_EQ(-a * su::big_int_t(UINT64_MAX), -a.long_multiplication(su::big_int_t(UINT64_MAX)));
+	EXPECT_EQ(b.toom42_multiplication(-b.toom32_multiplication(b)), -b.long_multiplication(b.long_multiplication(b)));
+}
+
+TEST (IntMultiplication, ParallelAgainstSerial)
+{
+	RandomInts random(97531);
+	auto random_digits = [&random](size_t size) {
+		std::vector<su::digit_t> digits(size);
+		for (auto &digit: digits)
+			digit = std::uniform_int_distribution<su::digit_t>()(random.engine());
+		return digits;
+	};
+
+	su::parallel::set_thread_count(4);
+
+	// Past the threshold, through the FFT and the NTT, balanced, unbalanced and squared
+	const std::pair<size_t, size_t> sizes[] = {{4000, 4000}, {9000, 5000}, {40000, 4000}, {20000, 17000}};
+	for (const auto &[longer, shorter]: sizes)
+	{
+		su::big_int_t a = random(longer);
+		su::big_int_t b = random(shorter);
+
+		ASSERT_EQ(a * b, a.ntt_multiplication(b)) << "Sizes " << longer << " and " << shorter;
+		ASSERT_EQ(a.square(), a.ntt_multiplication(a)) << "Size " << longer;
+	}
+
+	// The Toom and chunked tiers, which the FFT replaces when AVX2 is available
+	for (const auto &[longer, shorter]: {std::pair<size_t, size_t>{4100, 4000}, {7000, 4500}, {9500, 5000}, {30000, 4000}})
+	{
+		const auto a = random_digits(longer);
+		const auto b = random_digits(shorter);
+		const su::big_int_t expected = su::big_int_t(a).ntt_multiplication(su::big_int_t(b));
+		std::vector<su::digit_t> product(longer + shorter);
+
+		const su::limbs::ToomSplit split = su::parallel::toom_split(longer, shorter);
+		if (split.rhs_pieces != 0)
+		{
+			std::vector<su::digit_t> scratch(su::parallel::toom_scratch_size(longer, shorter, split));
+			su::parallel::toom(product, a, b, split, scratch);
+			ASSERT_EQ(su::big_int_t(product), expected) << "Sizes " << longer << " and " << shorter;
+		}
+
+		std::vector<su::digit_t> scratch(su::parallel::chunked_scratch_size(longer, shorter));
+		su::parallel::chunked(product, a, b, scratch);
+		ASSERT_EQ(su::big_int_t(product), expected) << "Sizes " << longer << " and " << shorter;
+
+		const su::limbs::ToomSplit square_split = su::parallel::sqr_toom_split(longer);
+		std::vector<su::digit_t> square(2 * longer);
+		scratch.assign(su::parallel::toom_scratch_size(0, longer, square_split), 0);
+		su::parallel::toom(square, a, {}, square_split, scratch);
+		ASSERT_EQ(su::big_int_t(square), su::big_int_t(a).ntt_multiplication(su::big_int_t(a))) << "Size " << longer;
+	}
+
+	su::parallel::set_thread_count(1);
+}
@@ -0,0 +1,70 @@
+#include "test_helpers.hpp"
+
+#include <gtest/gtest.h>
+
+#include <suuri_prepared.hpp>
+
+#include <memory_resource>
+
+namespace su = suuri;
+
+TEST (IntPrepared, FftAgainstMultiplication)
+{
+	RandomInts random(41);
+
+	const size_t size = su::limbs::fft_threshold + 300;
+	const auto b = random(size);
+	const su::PreparedMultiplier<> prepared(b);
+	if (!su::limbs::fft_usable(size, size))
+		GTEST_SKIP() << "The FFT is not used on this CPU";
+
+	ASSERT_TRUE(prepared.uses_transform(size));
+	for (size_t lhs_size: {size, size - 1, su::limbs::fft_threshold})
+	{
+		const auto a = random(lhs_size);
+		ASSERT_EQ(prepared.multiply(a), a.ntt_multiplication(b)) << "Size " << lhs_size;
+	}
+
+	// All limbs set gives the largest coefficients the error bound has to cover
+	const su::big_int_t ones(std::vector<su::digit_t>(size, ~su::digit_t{0}));
+	EXPECT_EQ(su::PreparedMultiplier<>(ones) * ones, ones.ntt_multiplication(ones));
+
+	const auto a = random(size);
+	EXPECT_EQ(-a * prepared, -a.ntt_multiplication(b));
+	EXPECT_EQ(su::PreparedMultiplier<>(-b) * -a, a.ntt_multiplication(b));
+}
+
+TEST (IntPrepared, Fallback)
+{
+	RandomInts random(43);
+
+	// Short products, and operands longer than the transform is made for, are multiplied as usual
+	const auto b = random(su::limbs::fft_threshold + 10);
+	const su::PreparedMultiplier<> prepared(b);
+	for (size_t lhs_size: {size_t{1}, size_t{50}, su::limbs::fft_threshold + 500})
+	{
+		const auto a = random(lhs_size);
+		EXPECT_EQ(a * prepared, a * b) << "Size " << lhs_size;
+	}
+	EXPECT_FALSE(prepared.uses_transform(su::limbs::fft_threshold + 500));
+
+	const su::PreparedMultiplier<> small(su::big_int_t(12345));
+	EXPECT_EQ(small * su::big_int_t(-2), su::big_int_t(-24690));
+	EXPECT_EQ(small * su::big_int_t(0), su::big_int_t(0));
+}
+
+TEST (IntPrepared, Allocator)
+{
+	RandomInts random(44);
+	std::pmr::monotonic_buffer_resource resource;
+
+	const size_t size = su::limbs::fft_threshold + 100;
+	const auto a = random(size);
+	const auto b = random(size);
+	const su::pmr::big_int_t b_pmr(b.digits(), false, &resource);
+
+	const su::PreparedMultiplier<std::pmr::polymorphic_allocator<su::digit_t>> prepared(b_pmr);
+	const auto product = su::pmr::big_int_t(a.digits(), false, &resource) * prepared;
+	EXPECT_EQ(product.get_allocator().resource(), &resource);
+	EXPECT_EQ(product, su::pmr::big_int_t((a * b).digits(), false, &resource));
+}
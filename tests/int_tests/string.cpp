@@ -2,6 +2,7 @@
 
 #include <big_int.hpp>
 
+#include <random>
 #include <sstream>
 #include <string>
 
@@ -395,3 +396,69 @@ TEST(IntString, SpecifiedBaseConstructor)
 		EXPECT_EQ(b.to_string(), "123456789012345678909876543211234567890");
 	}
 }
+
+TEST(IntString, InvalidBase)
+{
+	// Bases 0 and 1 have no digits to convert with, and bases past 36 run out of letters
+	EXPECT_THROW(su::big_int_t("b0_0"), std::invalid_argument);
+	EXPECT_THROW(su::big_int_t("b1_0"), std::invalid_argument);
+	EXPECT_THROW(su::big_int_t("b37_0"), std::invalid_argument);
+	EXPECT_EQ(su::big_int_t("b2_101"), 5);
+}
+
+TEST(IntString, LargeValueRoundTrip)
+{
+	// Chunks of 19 decimal digits are produced per division, so check zeros inside and at the edges of chunks
+	const std::string values[] = {
+			"10000000000000000000",
+			"9999999999999999999",
+			"18446744073709551616",
+			"100000000000000000000000000000000000000",
+			"123456789012345678900000000000000000000000000000000000000001",
+	};
+
+	for (const auto &value: values)
+		EXPECT_EQ(su::big_int_t(value).to_string(), value);
+
+	std::string nines(500, '9');
+	EXPECT_EQ(su::big_int_t(nines).to_string(), nines);
+}
+
+TEST(IntString, DivideAndConquerConversion)
+{
+	std::mt19937 gen(2211);
+
+	// Long enough for several levels of divide and conquer in both directions, with runs of zeros and nines
+	for (size_t length: {1000, 12345, 40000})
+	{
+		for (int fill = 0; fill < 3; fill++)
+		{
+			std::string digits(length, fill == 1 ? '9' : '0');
+			if (fill == 0)
+				for (auto &digit: digits)
+					digit = static_cast<char>('0' + gen() % 10);
+			digits[0] = '1';
+
+			// One digit at a time, as a reference that does not go through the conversion
+			su::big_int_t expected = 0;
+			for (char digit: digits)
+				expected = expected * 10 + (digit - '0');
+
+			const su::big_int_t value(digits);
+			EXPECT_EQ(value, expected) << "Length " << length;
+			EXPECT_EQ(value.to_string(), digits) << "Length " << length;
+			EXPECT_EQ(su::big_int_t("-" + digits), -expected);
+		}
+	}
+
+	// Other bases take other numbers of characters per chunk
+	for (uint32_t base: {2, 7, 16, 36})
+	{
+		std::string digits(20000, '1');
+		su::big_int_t expected = 0;
+		for (size_t i = 0; i < digits.size(); i++)
+			expected = expected * base + 1;
+
+		EXPECT_EQ(su::big_int_t("b" + std::to_string(base) + "_" + digits), expected) << "Base " << base;
+	}
+}
@@ -675,6 +675,25 @@ TEST(IntSubtraction, IntegersPositiveNegative)
 }
 
 
+TEST (IntSubtraction, Primitives)
+{
+	// Primitive operands are subtracted from the digits directly, borrowing across several of them
+	const su::big_int_t a("340282366920938463463374607431768211456");// 2^128
+
+	EXPECT_EQ(a - 1, su::big_int_t("340282366920938463463374607431768211455"));
+	EXPECT_EQ(a - INT64_MIN, a - su::big_int_t(INT64_MIN));
+	EXPECT_EQ(a - UINT64_MAX, a - su::big_int_t(UINT64_MAX));
+	EXPECT_EQ(1 - a, su::big_int_t("-340282366920938463463374607431768211455"));
+	EXPECT_EQ(5u - su::big_int_t(a), su::big_int_t(5) - a);
+	EXPECT_EQ(su::big_int_t(3) - 5, -2);
+	EXPECT_EQ(7 - su::big_int_t(-3), 10);
+
+	su::big_int_t b = -a;
+	b -= 1;
+	b -= -2;
+	EXPECT_EQ(b, 1 - a);
+}
+
 TEST (IntSubtraction, Random)
 {
 	auto binOp = [](const su::big_int_t& a, const su::big_int_t& b) { return a - b; };
@@ -1,3 +1,5 @@
+#include "test_helpers.hpp"
+
 #include <gtest/gtest.h>
 
 #include <big_int.hpp>
@@ -110,3 +112,56 @@ TEST(IntSuuriMath, Pow)
 	EXPECT_EQ(su::pow(a, 20), su::big_int_t{"686394475970957575528162329744850259123595018357328157281789909574621132884063828987026930102646603776"});
 	EXPECT_EQ(a.pow(20), su::big_int_t{"686394475970957575528162329744850259123595018357328157281789909574621132884063828987026930102646603776"});
 }
+
+TEST(IntSuuriMath, PowMod)
+{
+	// Small values, with odd moduli on the Montgomery path and even ones on the generic one
+	for (int base = -20; base <= 20; base += 3)
+	{
+		for (int exponent = 0; exponent <= 12; exponent++)
+		{
+			for (int modulus: {1, 2, 3, 7, 10, 64, 97, -13})
+			{
+				su::big_int_t expected = su::big_int_t(base).pow(static_cast<size_t>(exponent)) % su::big_int_t(modulus);
+				if (expected < 0)
+					expected += su::big_int_t(modulus).abs();
+				EXPECT_EQ(su::big_int_t(base).pow_mod(exponent, modulus), expected)
+						<< base << "^" << exponent << " mod " << modulus;
+			}
+		}
+	}
+	EXPECT_THROW((void) su::big_int_t(3).pow_mod(2, 0), su::divide_by_zero);
+
+	RandomInts random(1357);
+
+	// Moduli of many digits, against exponentiation followed by a single reduction. Even moduli and the largest odd one
+	// take Barrett reduction.
+	for (size_t size: {1, 2, 3, 5, 9, 40, 70})
+	{
+		su::big_int_t modulus = random(size);
+		su::big_int_t base = random(size + 1);
+		for (bool odd: {false, true})
+		{
+			if ((modulus % 2 == 0) == odd)
+				modulus += 1;
+
+			for (auto backend: {su::ifma::Backend::emulated, su::ifma::best_backend()})
+			{
+				EXPECT_EQ(base.pow_mod(7, modulus, backend), base.pow(7) % modulus) << "Size " << size;
+				EXPECT_EQ(base.pow_mod(16, modulus, backend), base.pow(16) % modulus) << "Size " << size;
+			}
+		}
+	}
+
+	// 2^127 - 1 and 2^521 - 1 are prime, so a^(p - 1) is 1 and a^p is a, by Fermat's little theorem
+	for (size_t exponent: {127, 521})
+	{
+		const su::big_int_t prime = su::big_int_t(2).pow(exponent) - 1;
+		const su::big_int_t base = random(exponent / 64);
+		for (auto backend: {su::ifma::Backend::emulated, su::ifma::best_backend()})
+		{
+			EXPECT_EQ(base.pow_mod(prime - 1, prime, backend), 1);
+			EXPECT_EQ(base.pow_mod(prime, prime, backend), base);
+		}
+	}
+}
@@ -3,6 +3,8 @@
 #include <big_int.hpp>
 #include <fstream>
 #include <gtest/gtest.h>
+#include <random>
+#include <vector>
 
 namespace su = suuri;
 
@@ -38,4 +40,59 @@ void run_pre_generated_test_file_bin_op(std::string fileName, su::big_int_t (*bi
 	}
 
 	file.close();
-}
\ No newline at end of file
+}
+
+/**
+ * Random values of a given number of digits, from a fixed seed so that a failure comes back on the next run.
+ */
+class RandomInts
+{
+public:
+	explicit RandomInts(uint32_t seed) : gen_(seed) {}
+
+	/**
+	 * @return A random positive value of exactly size digits.
+	 */
+	su::big_int_t operator()(size_t size)
+	{
+		return su::big_int_t::random_of_size(size, [this](uint32_t min, uint32_t max) { return std::uniform_int_distribution<uint32_t>(min, max)(gen_); });
+	}
+
+	/**
+	 * @return The engine behind the values, for tests that draw other random numbers as well.
+	 */
+	std::mt19937 &engine() noexcept
+	{
+		return gen_;
+	}
+
+private:
+	std::mt19937 gen_;
+};
+
+/**
+ * @brief Checks a multiplication against a reference on random operands of every pair of sizes, in both orders, and on
+ * the square of a random operand of every lhs size.
+ *
+ * The square passes the same value as both operands, so multiplications that square when they see it take that path.
+ */
+template<typename Multiplication, typename Reference>
+void expect_products_match(RandomInts &random, const std::vector<size_t> &lhs_sizes, const std::vector<size_t> &rhs_sizes,
+						   Multiplication multiplication, Reference reference)
+{
+	for (size_t lhs_size: lhs_sizes)
+	{
+		for (size_t rhs_size: rhs_sizes)
+		{
+			const su::big_int_t a = random(lhs_size);
+			const su::big_int_t b = random(rhs_size);
+			const su::big_int_t expected = reference(a, b);
+
+			ASSERT_EQ(multiplication(a, b), expected) << "Sizes " << lhs_size << " and " << rhs_size;
+			ASSERT_EQ(multiplication(b, a), expected) << "Sizes " << rhs_size << " and " << lhs_size;
+		}
+
+		const su::big_int_t a = random(lhs_size);
+		ASSERT_EQ(multiplication(a, a), reference(a, a)) << "Size " << lhs_size;
+	}
+}
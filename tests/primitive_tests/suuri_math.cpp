@@ -88,6 +88,13 @@ TEST(PrimitiveIntSuuriMath, AbsoluteValue)
 	}
 }
 
+TEST(PrimitiveIntSuuriMath, Square)
+{
+	EXPECT_EQ(su::square(int8_t{-11}), 121);
+	EXPECT_EQ(su::square(int64_t{3037000499}), int64_t{9223372030926249001});
+	EXPECT_EQ(su::square(uint64_t{1} << 31), uint64_t{1} << 62);
+}
+
 TEST(PrimitiveIntSuuriMath, Pow)
 {
 	{
@@ -0,0 +1,348 @@
+#include <big_int.hpp>
+#include <suuri_cpu.hpp>
+#include <suuri_limbs.hpp>
+#include <suuri_parallel.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * Measures where each multiplication, squaring, short product, division and conversion algorithm starts to beat the one
+ * below it, and writes the crossovers as a header that suuri_thresholds.hpp picks up, in the spirit of GMP's tuneup.
+ *
+ * The tiers are tuned from the bottom up. While one is tuned, the tiers above it are switched off and the ones below it
+ * keep their tuned values, so the algorithm runs at the top level only, on top of the already tuned recursion.
+ *
+ * Usage: suuri_tune [header path]. Without a path the header is written to standard output.
+ */
+
+namespace limbs = suuri::limbs;
+namespace parallel = suuri::parallel;
+
+namespace
+{
+
+/**
+ * A threshold no operand reaches, which switches its algorithm off.
+ */
+constexpr size_t never = size_t{1} << 40;
+
+enum class Operation {
+	basecase,
+	mul,
+	sqr,
+	parallel_mul,
+	mullo,
+	mulhi,
+	mulmid,
+	divide,
+	from_string,
+	to_string,
+};
+
+struct Tier {
+	const char *macro;
+	size_t &threshold;
+	Operation operation;
+	size_t min_size;
+	size_t max_size;
+	bool (*applicable)();
+	// The tier this one takes over from, whose threshold the search starts at
+	const size_t *below = nullptr;
+};
+
+bool always()
+{
+	return true;
+}
+
+bool has_avx2()
+{
+	return suuri::cpu::has_avx2();
+}
+
+bool has_threads()
+{
+	return parallel::thread_count() > 1;
+}
+
+std::vector<suuri::digit_t> random_limbs(size_t size, std::mt19937_64 &gen)
+{
+	std::vector<suuri::digit_t> ret(size);
+	for (auto &limb: ret)
+		limb = gen();
+	return ret;
+}
+
+/**
+ * @brief Runs the operation on operands of size limbs, with the thresholds as they are set.
+ */
+class Measurement
+{
+public:
+	Measurement(Operation operation, size_t size, std::mt19937_64 &gen)
+		: operation_(operation), lhs_(random_limbs(size, gen)), rhs_(random_limbs(size, gen)), result_(2 * size)
+	{
+		// The middle product and division take a lhs of twice the size, and the conversions a value of this size
+		if (operation == Operation::mulmid)
+		{
+			lhs_ = random_limbs(2 * size - 1, gen);
+			result_.resize(size + 2);
+		}
+		if (operation == Operation::divide)
+		{
+			lhs_ = random_limbs(2 * size, gen);
+			rhs_.back() |= 1;
+			result_.resize(size + 1);
+			remainder_.resize(size);
+		}
+		value_ = suuri::big_int_t(lhs_);
+		if (operation == Operation::from_string)
+			string_ = value_.to_string();
+	}
+
+	/**
+	 * @return The fastest time of a call, out of batches of calls each long enough to time.
+	 */
+	double seconds_per_call(size_t batches)
+	{
+		if (calls_ == 0)
+		{
+			calls_ = 1;
+			while (time_batch() < 2e-3)
+				calls_ *= 2;
+		}
+
+		double best = std::numeric_limits<double>::infinity();
+		for (size_t i = 0; i < batches; i++)
+			best = std::min(best, time_batch());
+
+		return best / static_cast<double>(calls_);
+	}
+
+private:
+	double time_batch()
+	{
+		const size_t size = lhs_.size();
+		switch (operation_)
+		{
+			case Operation::mul:
+				scratch_.resize(limbs::mul_scratch_size(size, size));
+				break;
+			case Operation::sqr:
+				scratch_.resize(limbs::sqr_scratch_size(size));
+				break;
+			case Operation::parallel_mul:
+				scratch_.resize(parallel::mul_scratch_size(size, size));
+				break;
+			case Operation::mullo:
+				scratch_.resize(limbs::mullo_scratch_size(size));
+				break;
+			case Operation::mulhi:
+				scratch_.resize(limbs::mulhi_scratch_size(size));
+				break;
+			case Operation::mulmid:
+				scratch_.resize(limbs::mulmid_scratch_size(size, rhs_.size()));
+				break;
+			case Operation::divide:
+				scratch_.resize(limbs::divrem_scratch_size(size, rhs_.size()));
+				break;
+			case Operation::basecase:
+			case Operation::from_string:
+			case Operation::to_string:
+				break;
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < calls_; i++)
+		{
+			switch (operation_)
+			{
+				case Operation::basecase:
+					limbs::mul_basecase(result_, lhs_, rhs_);
+					break;
+				case Operation::mul:
+					limbs::mul(result_, lhs_, rhs_, scratch_);
+					break;
+				case Operation::sqr:
+					limbs::sqr(result_, lhs_, scratch_);
+					break;
+				case Operation::parallel_mul:
+					parallel::mul(result_, lhs_, rhs_, scratch_);
+					break;
+				case Operation::mullo:
+					limbs::mullo(std::span(result_).first(size), lhs_, rhs_, scratch_);
+					break;
+				case Operation::mulhi:
+					limbs::mulhi(std::span(result_).first(size), lhs_, rhs_, scratch_);
+					break;
+				case Operation::mulmid:
+					limbs::mulmid(result_, lhs_, rhs_, scratch_);
+					break;
+				case Operation::divide:
+					limbs::divrem(result_, remainder_, lhs_, rhs_, scratch_);
+					break;
+				case Operation::from_string:
+					value_ = suuri::big_int_t(string_);
+					break;
+				case Operation::to_string:
+					string_ = value_.to_string();
+					break;
+			}
+		}
+		const auto end = std::chrono::steady_clock::now();
+
+		return std::chrono::duration<double>(end - start).count();
+	}
+
+	Operation operation_;
+	std::vector<suuri::digit_t> lhs_;
+	std::vector<suuri::digit_t> rhs_;
+	std::vector<suuri::digit_t> result_;
+	std::vector<suuri::digit_t> scratch_;
+	std::vector<suuri::digit_t> remainder_;
+	suuri::big_int_t value_;
+	std::string string_;
+	size_t calls_ = 0;
+};
+
+/**
+ * @brief Finds the smallest size from which the tier's algorithm beats the one below it at three sizes in a row, each
+ * time by at least a percent. This keeps noise from moving the crossover, or from picking one where the two run the same code.
+ *
+ * @return The crossover, or the end of the search if the algorithm never won.
+ */
+size_t find_crossover(const Tier &tier, std::mt19937_64 &gen)
+{
+	constexpr size_t wins_needed = 3;
+	constexpr size_t batches = 5;
+	constexpr double margin = 0.99;
+
+	const size_t min_size = std::max(tier.min_size, tier.below ? *tier.below : 0);
+	const size_t max_size = std::max(tier.max_size, min_size);
+	size_t first_win = max_size;
+	size_t wins = 0;
+	for (size_t size = min_size; size <= max_size; size = std::max(size + 1, size + size / 10))
+	{
+		Measurement measurement(tier.operation, size, gen);
+
+		// Alternating between the two keeps a change in the load of the machine from favouring either
+		double with_tier = std::numeric_limits<double>::infinity();
+		double without_tier = std::numeric_limits<double>::infinity();
+		for (size_t i = 0; i < batches; i++)
+		{
+			tier.threshold = size;
+			with_tier = std::min(with_tier, measurement.seconds_per_call(1));
+			tier.threshold = never;
+			without_tier = std::min(without_tier, measurement.seconds_per_call(1));
+		}
+
+		std::cerr << "  " << size << " limbs: " << without_tier / with_tier << "x\n";
+		if (with_tier < margin * without_tier)
+		{
+			if (wins++ == 0)
+				first_win = size;
+			if (wins == wins_needed)
+				return first_win;
+		} else
+		{
+			wins = 0;
+			first_win = max_size;
+		}
+	}
+
+	if (first_win == max_size)
+		std::cerr << "  No crossover up to " << max_size << " limbs\n";
+
+	return first_win;
+}
+
+}// namespace
+
+int main(int argc, char **argv)
+{
+	parallel::set_thread_count(0);
+
+	// In dispatch order, so that every tier is tuned on top of the ones below it. The NTT is tuned against Toom-Cook alone,
+	// and the FFT against both.
+	const auto &k = limbs::karatsuba_threshold.value;
+	const auto &t3 = limbs::toom3_threshold.value;
+	const auto &t4 = limbs::toom4_threshold.value;
+	const auto &t6 = limbs::toom6h_threshold.value;
+	const auto &sk = limbs::sqr_karatsuba_threshold.value;
+	const auto &st3 = limbs::sqr_toom3_threshold.value;
+	const auto &ml = limbs::mullo_dc_threshold.value;
+	std::vector<Tier> tiers = {
+			{"SUURI_SIMD_BASECASE_THRESHOLD", limbs::simd_basecase_threshold.value, Operation::basecase, 2, 64, has_avx2},
+			{"SUURI_KARATSUBA_THRESHOLD", limbs::karatsuba_threshold.value, Operation::mul, 8, 128, always},
+			{"SUURI_TOOM3_THRESHOLD", limbs::toom3_threshold.value, Operation::mul, 40, 600, always, &k},
+			{"SUURI_TOOM4_THRESHOLD", limbs::toom4_threshold.value, Operation::mul, 150, 1500, always, &t3},
+			{"SUURI_TOOM6H_THRESHOLD", limbs::toom6h_threshold.value, Operation::mul, 500, 5000, always, &t4},
+			{"SUURI_TOOM8H_THRESHOLD", limbs::toom8h_threshold.value, Operation::mul, 1500, 12000, always, &t6},
+			{"SUURI_NTT_THRESHOLD", limbs::ntt_threshold.value, Operation::mul, 3000, 60000, always},
+			{"SUURI_FFT_THRESHOLD", limbs::fft_threshold.value, Operation::mul, 300, 8000, has_avx2},
+			{"SUURI_SQR_KARATSUBA_THRESHOLD", limbs::sqr_karatsuba_threshold.value, Operation::sqr, 8, 160, always},
+			{"SUURI_SQR_TOOM3_THRESHOLD", limbs::sqr_toom3_threshold.value, Operation::sqr, 60, 800, always, &sk},
+			{"SUURI_SQR_TOOM4_THRESHOLD", limbs::sqr_toom4_threshold.value, Operation::sqr, 200, 3000, always, &st3},
+			{"SUURI_SQR_FFT_THRESHOLD", limbs::sqr_fft_threshold.value, Operation::sqr, 300, 8000, has_avx2},
+			{"SUURI_MULLO_DC_THRESHOLD", limbs::mullo_dc_threshold.value, Operation::mullo, 8, 200, always},
+			{"SUURI_MULHI_DC_THRESHOLD", limbs::mulhi_dc_threshold.value, Operation::mulhi, 8, 200, always},
+			{"SUURI_SHORT_PRODUCT_FULL_THRESHOLD", limbs::short_product_full_threshold.value, Operation::mullo, 300, 12000, always, &ml},
+			{"SUURI_MULMID_KARATSUBA_THRESHOLD", limbs::mulmid_karatsuba_threshold.value, Operation::mulmid, 8, 200, always},
+			{"SUURI_DIV_DC_THRESHOLD", limbs::div_dc_threshold.value, Operation::divide, 8, 400, always},
+			{"SUURI_FROM_STRING_DC_THRESHOLD", suuri::big_int_t::from_string_dc_threshold.value, Operation::from_string, 10, 4000, always},
+			{"SUURI_TO_STRING_DC_THRESHOLD", suuri::big_int_t::to_string_dc_threshold.value, Operation::to_string, 2, 500, always},
+			{"SUURI_PARALLEL_THRESHOLD", parallel::threshold.value, Operation::parallel_mul, 500, 30000, has_threads},
+	};
+
+	std::vector<size_t> defaults;
+	for (auto &tier: tiers)
+	{
+		defaults.push_back(tier.threshold);
+		tier.threshold = never;
+	}
+
+	std::mt19937_64 gen(5489);
+	std::ostringstream header;
+	header << "#pragma once\n\n"
+		   << "// Generated by suuri_tune. Delete this file to go back to the default thresholds.\n\n";
+	for (size_t i = 0; i < tiers.size(); i++)
+	{
+		auto &tier = tiers[i];
+		if (!tier.applicable())
+		{
+			// The algorithm never runs on this machine, so the threshold does not matter
+			std::cerr << tier.macro << ": not used on this machine, keeping " << defaults[i] << "\n";
+			tier.threshold = defaults[i];
+			continue;
+		}
+
+		std::cerr << tier.macro << ":\n";
+		tier.threshold = find_crossover(tier, gen);
+		std::cerr << tier.macro << ": " << tier.threshold << " (default " << defaults[i] << ")\n";
+		header << "#define " << tier.macro << " " << tier.threshold << "\n";
+	}
+
+	if (argc < 2)
+	{
+		std::cout << header.str();
+		return 0;
+	}
+
+	std::ofstream file(argv[1]);
+	file << header.str();
+	if (!file)
+	{
+		std::cerr << "Unable to write " << argv[1] << "\n";
+		return 1;
+	}
+
+	return 0;
+}